@@ -0,0 +1,278 @@
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "command_line.h"
+#include "engine.h"
+#include "engine_interface.h"
+#include "heap_based_engine.h"
+#include "latency_summary.h"
+#include "linux/perf_counters.h"
+#include "order.h"
+#include "tsc.h"
+
+/**
+ * AddOrder and Execute timed separately, one JSON object per line:
+ * for every engine, book depth, price distribution and crossing ratio the
+ * book is prefilled to depth with resting orders, then each measured
+ * operation adds one order and executes.
+ *
+ * All orders carry the same quantity, so a crossing order takes out exactly
+ * one resting order and the book stays near its starting depth. The orders
+ * are generated against a model of the book, a crossing order is priced at
+ * the best resting price on the other side, or rests if that side is empty,
+ * so it never rests beyond the touch where later orders would cross it.
+ *
+ * With --perf each operation is also counted by its own perf_event group,
+ * enabled just around it, and the per operation hardware counts are added
+ * to the JSON (null where the counter is not available).
+ */
+namespace {
+
+constexpr Price_t kMid = 1 << 15;
+constexpr Price_t kMaxOffset = 2000;
+constexpr Quantity_t kQuantity = 100;
+
+enum class Distribution { kUniform, kNearTouch, kOneSided };
+
+std::string_view ToString(Distribution distribution) {
+  switch (distribution) {
+    case Distribution::kUniform:
+      return "uniform";
+    case Distribution::kNearTouch:
+      return "near_touch";
+    case Distribution::kOneSided:
+      return "one_sided";
+  }
+  return "";
+}
+
+struct BenchConfig {
+  uint32_t Depth;
+  Distribution PriceDistribution;
+  double CrossingRatio;
+};
+
+struct BenchOrder {
+  OrderType_t Type;
+  Price_t Price;
+};
+
+// orders in the sequence they are added, every order it hands out is
+// assumed to reach the engine
+class OrderSource {
+ public:
+  OrderSource(Distribution distribution, uint64_t seed)
+      : m_distribution_{distribution}, m_random_{seed} {}
+
+  // resting order which does not cross the book
+  BenchOrder Passive() {
+    const OrderType_t type =
+        m_distribution_ == Distribution::kOneSided ? kBuy : RandomSide();
+    const Price_t offset = Offset();
+    const auto price =
+        static_cast<Price_t>(type == kBuy ? kMid - offset : kMid + offset);
+
+    ++m_resting_[type][price];
+    return BenchOrder{.Type = type, .Price = price};
+  }
+
+  // marketable order, takes out the best resting order on the other side,
+  // a passive order instead while that side is empty
+  BenchOrder Aggressive() {
+    const OrderType_t type =
+        m_distribution_ == Distribution::kOneSided ? kSell : RandomSide();
+    auto& levels = m_resting_[type == kBuy ? kSell : kBuy];
+
+    if (levels.empty()) [[unlikely]] {
+      return Passive();
+    }
+
+    const auto best =
+        type == kBuy ? std::begin(levels) : std::prev(std::end(levels));
+    const Price_t price = best->first;
+
+    if (--best->second == 0) {
+      levels.erase(best);
+    }
+    return BenchOrder{.Type = type, .Price = price};
+  }
+
+  bool Chance(double probability) {
+    return std::bernoulli_distribution{probability}(m_random_);
+  }
+
+ private:
+  OrderType_t RandomSide() {
+    return std::bernoulli_distribution{0.5}(m_random_) ? kBuy : kSell;
+  }
+
+  Price_t Offset() {
+    if (m_distribution_ == Distribution::kNearTouch) {
+      // most orders within a few ticks of the touch
+      const auto offset = std::geometric_distribution<int>{0.3}(m_random_);
+      return std::min<int>(offset + 1, kMaxOffset);
+    }
+    return std::uniform_int_distribution<int>{1, kMaxOffset}(m_random_);
+  }
+
+ private:
+  Distribution m_distribution_;
+  std::mt19937_64 m_random_;
+  // resting orders per price of each side, indexed by kBuy and kSell
+  std::array<std::map<Price_t, uint32_t>, 2> m_resting_;
+};
+
+template <Engine_t Engine>
+void AddOrder(Engine& engine, const BenchOrder& order, ID_t id) {
+  if (order.Type == kBuy) {
+    engine.AddOrder(BuyOrder(id, order.Price, kQuantity));
+  } else {
+    engine.AddOrder(SellOrder(id, order.Price, kQuantity));
+  }
+}
+
+void ReportPerf(const PerfReading& reading, uint64_t op_count) {
+  auto field = [](std::string_view name, std::optional<double> value) {
+    std::cout << ",\"" << name << "\":";
+    if (value) {
+      std::cout << *value;
+    } else {
+      std::cout << "null";
+    }
+  };
+
+  for (uint32_t i = 0; i < kPerfEventCount; ++i) {
+    const PerfEvent event = static_cast<PerfEvent>(i);
+    field(PerfEventName(event), reading.PerOp(event, op_count));
+  }
+  field("ipc", reading.Ipc());
+}
+
+void Report(std::string_view engine_name,
+            std::string_view op,
+            const BenchConfig& config,
+            std::vector<uint64_t>& samples,
+            const PerfCounters* counters) {
+  const LatencySummary summary = Summarize(samples);
+
+  std::cout << "{\"engine\":\"" << engine_name << "\",\"op\":\"" << op
+            << "\",\"depth\":" << config.Depth << ",\"distribution\":\""
+            << ToString(config.PriceDistribution)
+            << "\",\"crossing_ratio\":" << config.CrossingRatio
+            << ",\"count\":" << summary.Count
+            << ",\"mean_ns\":" << summary.Mean
+            << ",\"p50_ns\":" << summary.P50 << ",\"p90_ns\":" << summary.P90
+            << ",\"p99_ns\":" << summary.P99
+            << ",\"p999_ns\":" << summary.P999
+            << ",\"max_ns\":" << summary.Max;
+
+  if (counters != nullptr) {
+    ReportPerf(counters->Read(), summary.Count);
+  }
+  std::cout << "}\n";
+}
+
+template <Engine_t Engine>
+void Bench(std::string_view engine_name,
+           const BenchConfig& config,
+           uint32_t op_count,
+           double ticks_per_ns,
+           bool perf) {
+  OrderSource source(config.PriceDistribution, config.Depth);
+
+  auto engine = std::make_unique<Engine>();
+  ID_t id = 1;
+
+  // the prefill comes first, the measured orders are priced against it
+  for (uint32_t i = 0; i < config.Depth; ++i) {
+    AddOrder(*engine, source.Passive(), id++);
+  }
+
+  // generated up front so the random number generation is not timed
+  std::vector<BenchOrder> orders;
+  orders.reserve(op_count);
+  for (uint32_t i = 0; i < op_count; ++i) {
+    orders.push_back(source.Chance(config.CrossingRatio) ? source.Aggressive()
+                                                         : source.Passive());
+  }
+
+  std::vector<uint64_t> add_samples(op_count);
+  std::vector<uint64_t> execute_samples(op_count);
+
+  std::unique_ptr<PerfCounters> add_counters;
+  std::unique_ptr<PerfCounters> execute_counters;
+  if (perf) {
+    add_counters = std::make_unique<PerfCounters>();
+    execute_counters = std::make_unique<PerfCounters>();
+  }
+
+  for (uint32_t i = 0; i < op_count; ++i) {
+    // the ioctls stay outside of the timed regions
+    if (perf) {
+      add_counters->Enable();
+    }
+    const uint64_t start = ReadTsc();
+    AddOrder(*engine, orders[i], id++);
+    const uint64_t added = ReadTscp();
+
+    if (perf) {
+      add_counters->Disable();
+      execute_counters->Enable();
+    }
+    const uint64_t execute_start = ReadTsc();
+    const auto results = engine->Execute();
+    const uint64_t executed = ReadTscp();
+
+    if (perf) {
+      execute_counters->Disable();
+    }
+
+    add_samples[i] = (added - start) / ticks_per_ns;
+    execute_samples[i] = (executed - execute_start) / ticks_per_ns;
+  }
+
+  Report(engine_name, "AddOrder", config, add_samples, add_counters.get());
+  Report(engine_name, "Execute", config, execute_samples,
+         execute_counters.get());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const bool perf = HasFlag(argc, argv, "--perf");
+  const uint32_t op_count =
+      argc > 1 and argv[1][0] != '-' ? std::stoul(argv[1]) : 20'000;
+
+  if (perf) {
+    PerfCounters probe;
+    if (!probe.Available()) {
+      std::cerr << "perf counters unavailable, " << probe.Error() << '\n';
+    }
+  }
+
+  const double ticks_per_ns = CalibrateTsc();
+
+  for (const uint32_t depth : {1'000u, 10'000u, 100'000u}) {
+    for (const auto distribution :
+         {Distribution::kUniform, Distribution::kNearTouch,
+          Distribution::kOneSided}) {
+      for (const double crossing_ratio : {0.0, 0.1, 0.5}) {
+        const BenchConfig config{.Depth = depth,
+                                 .PriceDistribution = distribution,
+                                 .CrossingRatio = crossing_ratio};
+
+        Bench<Engine>("Engine", config, op_count, ticks_per_ns, perf);
+        Bench<HeapBasedEngine>("HeapBasedEngine", config, op_count,
+                               ticks_per_ns, perf);
+      }
+    }
+  }
+}
@@ -0,0 +1,126 @@
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "fix.h"
+#include "order.h"
+#include "tsc.h"
+
+/**
+ * FIX decode throughput, one JSON object per line: a buffer of
+ * NewOrderSingle messages, as a session would receive them back to back,
+ * is framed, checksummed, scanned and turned into native orders the way
+ * FixTransport does it, several passes over the same buffer
+ */
+namespace {
+
+struct Decoded {
+  uint64_t Orders{0};
+  uint64_t Checksum{0};
+};
+
+std::vector<uint8_t> MakeMessages(uint32_t count) {
+  std::mt19937_64 random{count};
+  std::vector<uint8_t> messages(count * FixWriter::kMaxMessageLen);
+  uint64_t len = 0;
+  FixWriter writer;
+
+  for (uint32_t i = 0; i < count; ++i) {
+    writer.Add(kFixMsgType, 'D')
+        .Add(kFixSenderCompId, "BENCHCLIENT")
+        .Add(kFixTargetCompId, "ENGINE")
+        .Add(kFixMsgSeqNum, uint64_t{i + 2})
+        .Add(kFixSendingTime, "20260101-00:00:00")
+        .Add(kFixClOrdId, uint64_t{1'000'000 + i})
+        .Add(kFixSymbol, "PTME")
+        .Add(kFixSide, random() % 2 == 0 ? '1' : '2')
+        .Add(kFixOrderQty, uint64_t{1 + random() % 1000})
+        .Add(kFixOrdType, '2')
+        .Add(kFixPrice, uint64_t{30'000 + random() % 100});
+    len += writer.Finish(messages.data() + len);
+  }
+
+  messages.resize(len);
+  return messages;
+}
+
+Decoded Decode(std::span<const uint8_t> pending) {
+  Decoded decoded;
+  int64_t len;
+
+  while ((len = FixMessageLength(pending)) > 0) {
+    std::string_view cl_ord_id;
+    std::string_view side;
+    std::string_view quantity_text;
+    std::string_view price_text;
+
+    ForEachFixField(FixBody(pending.first(len)),
+                    [&](uint32_t tag, std::string_view value) {
+                      switch (tag) {
+                        case kFixClOrdId:
+                          cl_ord_id = value;
+                          break;
+                        case kFixSide:
+                          side = value;
+                          break;
+                        case kFixOrderQty:
+                          quantity_text = value;
+                          break;
+                        case kFixPrice:
+                          price_text = value;
+                          break;
+                        default:
+                          break;
+                      }
+                    });
+
+    uint64_t id;
+    uint64_t quantity;
+    uint64_t price;
+    if (ParseFixUint(cl_ord_id, id) and
+        ParseFixUint(quantity_text, quantity) and
+        ParseFixWholePrice(price_text, price)) [[likely]] {
+      const Order order(side == "1" ? kBuy : kSell, id,
+                        static_cast<Price_t>(price),
+                        static_cast<Quantity_t>(quantity));
+      decoded.Checksum += order.Id() + order.Price() + order.Quantity();
+      ++decoded.Orders;
+    }
+    pending = pending.subspan(len);
+  }
+  return decoded;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const uint32_t message_count =
+      argc > 1 and argv[1][0] != '-' ? std::stoul(argv[1]) : 100'000;
+  constexpr uint32_t kPasses = 10;
+
+  const double ticks_per_ns = CalibrateTsc();
+  const std::vector<uint8_t> messages = MakeMessages(message_count);
+
+  // warms the caches and the branch predictors
+  uint64_t checksum = Decode(messages).Checksum;
+
+  for (uint32_t pass = 0; pass < kPasses; ++pass) {
+    const uint64_t start = ReadTsc();
+    const Decoded decoded = Decode(messages);
+    const double ns = (ReadTscp() - start) / ticks_per_ns;
+    checksum += decoded.Checksum;
+
+    std::cout << "{\"op\":\"FixDecode\",\"pass\":" << pass
+              << ",\"messages\":" << decoded.Orders
+              << ",\"bytes\":" << messages.size()
+              << ",\"ns_per_message\":" << ns / decoded.Orders
+              << ",\"messages_per_s\":" << decoded.Orders * 1e9 / ns
+              << ",\"mb_per_s\":" << messages.size() * 1e3 / ns << "}\n";
+  }
+
+  // keeps the decoded orders observable
+  std::cerr << "checksum " << checksum << '\n';
+}
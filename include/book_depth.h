@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include "define.h"
+#include "order.h"
+#include "trade_result.h"
+
+// one aggregated price level, Quantity is the sum over its resting orders
+struct DepthLevel {
+  Price_t Price;
+  uint32_t Quantity;
+} __attribute__((packed, aligned(1)));
+
+// a level of one side which changed, Quantity is 0 once it has gone
+struct DepthUpdate {
+  OrderType_t Side;
+  Price_t Price;
+  uint32_t Quantity;
+} __attribute__((packed, aligned(1)));
+
+/**
+ * resting quantity per price of both sides of the book, kBuy is the bid
+ * side and kSell the ask side, updated on the matching thread as orders
+ * rest, trade and are cancelled
+ *
+ * every price has its own slot, so an update is an add to one counter, a
+ * two level bitmap of the non empty prices finds the best levels of a side
+ * without walking the empty prices in between
+ */
+class BookDepth {
+ public:
+  BookDepth();
+
+  void Add(OrderType_t side, Price_t price, Quantity_t quantity) noexcept;
+  void Remove(OrderType_t side, Price_t price, Quantity_t quantity) noexcept;
+  // a cancel does not say its side, the uncrossed book rests on at most one
+  // side at any price
+  void Remove(Price_t price, Quantity_t quantity) noexcept;
+
+  uint32_t Quantity(OrderType_t side, Price_t price) const noexcept;
+
+  // the best levels of a side, best first, returns how many were filled in
+  uint32_t Top(OrderType_t side, std::span<DepthLevel> levels) const noexcept;
+
+  // grows with every change
+  uint64_t Version() const noexcept { return m_version_; }
+
+ private:
+  static constexpr uint32_t kPriceCount = 1 << (8 * sizeof(Price_t));
+  static constexpr uint32_t kWordCount = kPriceCount / 64;
+  static constexpr uint32_t kSummaryCount = kWordCount / 64;
+
+  struct Side {
+    std::array<uint32_t, kPriceCount> Quantities;
+    // a bit per price with quantity, and a bit per non zero word of those
+    std::array<uint64_t, kWordCount> Occupied;
+    std::array<uint64_t, kSummaryCount> Summary;
+  };
+
+  uint32_t TopBids(std::span<DepthLevel> levels) const noexcept;
+  uint32_t TopAsks(std::span<DepthLevel> levels) const noexcept;
+
+ private:
+  std::unique_ptr<std::array<Side, 2>> m_sides_;
+  uint64_t m_version_{0};
+};
+
+// the order handler's view of BookDepth, fills take the traded quantity off
+// both orders' own price levels
+class DepthReports {
+ public:
+  explicit DepthReports(BookDepth& depth) : m_depth_{&depth} {}
+
+  void Accepted(uint64_t, const Order& order) {
+    m_depth_->Add(order.OrderType(), order.Price(), order.Quantity());
+  }
+
+  void Rejected(uint64_t, const Order&) {}
+
+  bool MayCancel(uint64_t, const Order&) { return true; }
+
+  void Cancelled(uint64_t, const Order& order, Quantity_t quantity) {
+    if (quantity > 0) {
+      m_depth_->Remove(order.Price(), quantity);
+    }
+  }
+
+  void Filled(const TradeResult& trade_result) {
+    m_depth_->Remove(kBuy, trade_result.BuyPrice, trade_result.Quantity);
+    m_depth_->Remove(kSell, trade_result.SellPrice, trade_result.Quantity);
+  }
+
+ private:
+  BookDepth* m_depth_;
+};
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+/**
+ * sbe style fixed layout messages
+ *
+ * | MessageHeader | block of fields at fixed offsets |
+ *
+ * a schema lists the field types in wire order, their offsets are worked
+ * out at compile time, encoders and decoders are flyweights over the
+ * caller's buffer, so a decode reads every field straight from where the
+ * message was received
+ *
+ * versions only ever append fields, a decoder reading a message from an
+ * older sender gets zero for the fields the sender did not have yet, one
+ * reading a newer message skips the fields it does not know, the block
+ * length in the header says where the next message starts
+ */
+struct MessageHeader {
+  uint16_t TemplateId;
+  uint16_t Version;
+  // of the block following the header
+  uint16_t BlockLength;
+} __attribute__((packed, aligned(1)));
+
+template <uint16_t TemplateId, uint16_t Version, class... Fields>
+struct Schema {
+  static_assert((std::is_trivially_copyable_v<Fields> and ...));
+
+  static constexpr uint16_t kTemplateId = TemplateId;
+  static constexpr uint16_t kVersion = Version;
+  static constexpr uint32_t kFieldCount = sizeof...(Fields);
+  static constexpr uint16_t kBlockLength = (0 + ... + sizeof(Fields));
+
+  static constexpr std::array<uint16_t, kFieldCount> kOffsets = [] {
+    std::array<uint16_t, kFieldCount> offsets{};
+    uint16_t offset = 0;
+    uint32_t i = 0;
+    ((offsets[i++] = offset, offset += sizeof(Fields)), ...);
+    return offsets;
+  }();
+
+  template <uint32_t I>
+  using Field = std::tuple_element_t<I, std::tuple<Fields...>>;
+};
+
+// writes the header on construction, the fields at their fixed offsets
+template <class S>
+class Encoder {
+ public:
+  static constexpr uint32_t kLength = sizeof(MessageHeader) + S::kBlockLength;
+
+ public:
+  // the buffer holds at least kLength bytes
+  explicit Encoder(std::span<uint8_t> buffer) : m_data_{buffer.data()} {
+    assert(buffer.size() >= kLength);
+
+    const MessageHeader header{S::kTemplateId, S::kVersion, S::kBlockLength};
+    std::memcpy(m_data_, &header, sizeof(header));
+  }
+
+  template <uint32_t I>
+  Encoder& Set(typename S::template Field<I> value) {
+    std::memcpy(m_data_ + sizeof(MessageHeader) + S::kOffsets[I], &value,
+                sizeof(value));
+    return *this;
+  }
+
+  uint32_t Length() const { return kLength; }
+
+ private:
+  uint8_t* m_data_;
+};
+
+template <class S>
+class Decoder {
+ public:
+  // empty unless the buffer starts with a whole message of this template
+  static std::optional<Decoder> Wrap(std::span<const uint8_t> buffer) {
+    if (buffer.size() < sizeof(MessageHeader)) {
+      return std::nullopt;
+    }
+
+    MessageHeader header;
+    std::memcpy(&header, buffer.data(), sizeof(header));
+
+    if (header.TemplateId != S::kTemplateId or
+        buffer.size() < sizeof(MessageHeader) + header.BlockLength) {
+      return std::nullopt;
+    }
+    return Decoder{buffer.data(), header};
+  }
+
+  // zero if the sender's version did not have the field yet
+  template <uint32_t I>
+  typename S::template Field<I> Get() const {
+    typename S::template Field<I> value{};
+
+    if (S::kOffsets[I] + sizeof(value) <= m_header_.BlockLength) [[likely]] {
+      std::memcpy(&value, m_block_ + S::kOffsets[I], sizeof(value));
+    }
+    return value;
+  }
+
+  uint16_t Version() const { return m_header_.Version; }
+
+  // the fields as they were received, header excluded
+  std::span<const uint8_t> Block() const {
+    return {m_block_, m_header_.BlockLength};
+  }
+
+  uint32_t Length() const {
+    return sizeof(MessageHeader) + m_header_.BlockLength;
+  }
+
+ private:
+  Decoder(const uint8_t* data, MessageHeader header)
+      : m_block_{data + sizeof(MessageHeader)}, m_header_{header} {}
+
+ private:
+  const uint8_t* m_block_;
+  MessageHeader m_header_;
+};
+
+/**
+ * calls visitor(template_id, message) for every whole message at the front
+ * of buffer, message spans the header and its block, returns the bytes
+ * consumed, a trailing partial message is left for the caller
+ */
+template <class Visitor>
+uint64_t ForEachMessage(std::span<const uint8_t> buffer, Visitor&& visitor) {
+  uint64_t consumed = 0;
+
+  while (buffer.size() - consumed >= sizeof(MessageHeader)) {
+    MessageHeader header;
+    std::memcpy(&header, buffer.data() + consumed, sizeof(header));
+
+    const uint64_t length = sizeof(MessageHeader) + header.BlockLength;
+    if (buffer.size() - consumed < length) {
+      break;
+    }
+
+    visitor(header.TemplateId, buffer.subspan(consumed, length));
+    consumed += length;
+  }
+  return consumed;
+}
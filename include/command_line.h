@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string_view>
+
+// returns the argument following `flag`, empty if the flag is not given
+inline std::string_view FlagValue(int argc,
+                                  char** argv,
+                                  std::string_view flag) {
+  for (int i = 1; i + 1 < argc; ++i) {
+    if (flag == argv[i]) {
+      return argv[i + 1];
+    }
+  }
+  return {};
+}
+
+inline bool HasFlag(int argc, char** argv, std::string_view flag) {
+  for (int i = 1; i < argc; ++i) {
+    if (flag == argv[i]) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include "order.h"
+
+/**
+ * parses "<B|S|C>,<id>,<price>,<quantity>" lines, calling
+ * on_order(const Order&) for each well formed one, returns the number of
+ * malformed lines skipped, the quantity of a cancel line is ignored
+ *
+ * from_chars consumes every field in place, so a well formed line is read
+ * exactly once without searching for delimiters or allocating, memchr is only
+ * used to find the end of a malformed line
+ */
+template <class OnOrder>
+uint64_t ParseCsvOrders(std::string_view text, OnOrder&& on_order) {
+  const char* cursor = text.data();
+  const char* const end = text.data() + text.size();
+
+  uint64_t malformed = 0;
+
+  auto field = [&](auto& value) {
+    const auto [ptr, ec] = std::from_chars(cursor, end, value);
+    cursor = ptr;
+    return ec == std::errc{};
+  };
+
+  auto skip = [&](char delimiter) {
+    if (cursor != end and *cursor == delimiter) {
+      ++cursor;
+      return true;
+    }
+    return false;
+  };
+
+  while (cursor != end) {
+    const char* const line = cursor;
+    const char side = *cursor++;
+
+    ID_t id;
+    Price_t price;
+    Quantity_t quantity;
+
+    const bool parsed = (side == 'B' or side == 'S' or side == 'C') and
+                        skip(',') and field(id) and skip(',') and
+                        field(price) and skip(',') and field(quantity);
+
+    skip('\r');
+
+    if (parsed and (cursor == end or skip('\n'))) [[likely]] {
+      const OrderType_t type = side == 'B'   ? kBuy
+                               : side == 'S' ? kSell
+                                             : kCancel;
+      on_order(Order(type, id, price, type == kCancel ? 0 : quantity));
+      continue;
+    }
+
+    // blank lines are skipped silently
+    if (side != '\n' and side != '\r') {
+      ++malformed;
+    }
+
+    const void* line_end = std::memchr(line, '\n', end - line);
+    cursor = line_end == nullptr ? end : static_cast<const char*>(line_end) + 1;
+  }
+
+  return malformed;
+}
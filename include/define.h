@@ -9,3 +9,4 @@ using Quantity_t = uint16_t;
 
 constexpr OrderType_t kBuy = 0;
 constexpr OrderType_t kSell = 1;
+constexpr OrderType_t kCancel = 2;
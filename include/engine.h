@@ -7,6 +7,7 @@
 #include <vector>
 #include "define.h"
 #include "engine_options.h"
+#include "engine_stats.h"
 #include "order.h"
 #include "trade_result.h"
 
@@ -26,10 +27,23 @@ class Engine {
   Engine& operator=(const Engine&) = delete;
   void AddOrder(BuyOrder order) noexcept;
   void AddOrder(SellOrder order) noexcept;
+  Quantity_t Cancel(CancelOrder order) noexcept;
 
   std::vector<TradeResult> Execute() noexcept;
 
+  // XOR of OrderHash over all resting orders, see state_hash.h
+  uint64_t StateHash() const noexcept { return m_state_hash_; }
+
+  // O(depth), counts the price levels by walking the sorted prices
+  EngineStats Stats() const noexcept;
+
+  // rebinds the cache views after the instance has been mapped at a new
+  // address, e.g. a book reattached from shared memory, the orders are kept
+  void Reattach() noexcept;
+
  private:
+  void BindCaches() noexcept;
+
   __attribute__((always_inline)) void InsertBuyOrderAt(
       uint32_t index,
       Price_t price,
@@ -51,6 +65,8 @@ class Engine {
       uint32_t len,
       auto&& price_slice,
       auto&& item_slice) noexcept {
+    m_stats_.ShiftBytes += len * (sizeof(Price_t) + sizeof(ColdCache));
+
     std::memmove(price_slice.data() + index + 1, price_slice.data() + index,
                  len * sizeof(Price_t));
 
@@ -58,6 +74,29 @@ class Engine {
                  len * sizeof(ColdCache));
   }
 
+  __attribute__((always_inline)) void ShiftLeftByOneAt(
+      uint32_t index,
+      uint32_t len,
+      auto&& price_slice,
+      auto&& item_slice) noexcept {
+    m_stats_.ShiftBytes += len * (sizeof(Price_t) + sizeof(ColdCache));
+
+    std::memmove(price_slice.data() + index, price_slice.data() + index + 1,
+                 len * sizeof(Price_t));
+
+    std::memmove(item_slice.data() + index, item_slice.data() + index + 1,
+                 len * sizeof(ColdCache));
+  }
+
+  // removes the order with this id from the run of orders at `price`
+  Quantity_t CancelAt(ID_t id,
+                      Price_t price,
+                      OrderType_t order_type,
+                      uint32_t& count,
+                      std::span<Price_t> price_caches,
+                      std::span<ColdCache> item_caches,
+                      auto&& comp) noexcept;
+
  private:
   uint8_t m_caches_[kMaxOrders * sizeof(Price_t) * 2 +
                     kMaxOrders * sizeof(ColdCache) * 2];
@@ -69,4 +108,9 @@ class Engine {
   std::span<Price_t> m_sell_price_caches_;
   std::span<Engine::ColdCache> m_sell_item_caches_;
   uint32_t m_sell_count_;
+
+  uint64_t m_state_hash_{0};
+
+  // counters only, the book shape is filled in by Stats()
+  EngineStats m_stats_;
 };
@@ -7,8 +7,13 @@
 
 template <class T>
 concept Engine_t =
-    requires(T engine, BuyOrder buy_order, SellOrder sell_order) {
+    requires(T engine,
+             BuyOrder buy_order,
+             SellOrder sell_order,
+             CancelOrder cancel_order) {
       { engine.AddOrder(buy_order) } -> std::same_as<void>;
       { engine.AddOrder(sell_order) } -> std::same_as<void>;
+      // returns the quantity taken off the book, 0 if the order is not found
+      { engine.Cancel(cancel_order) } -> std::same_as<Quantity_t>;
       { engine.Execute() } -> std::same_as<std::vector<TradeResult>>;
     };
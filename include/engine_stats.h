@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+/**
+ * structural work done by an engine since it was constructed, and the shape
+ * of its book when the snapshot was taken
+ *
+ * the counters are plain increments on the matching path, the depth and
+ * price levels are computed by the snapshot itself in O(depth)
+ */
+struct EngineStats {
+  uint64_t AddOrders{0};
+  uint64_t Cancels{0};
+  uint64_t Executes{0};
+  uint64_t Trades{0};
+
+  // Engine: bytes memmoved to open and close slots in the sorted arrays
+  uint64_t ShiftBytes{0};
+  // Engine: orders between each insert position and the touch, summed
+  uint64_t InsertDistance{0};
+  // HeapBasedEngine: comparisons made sifting orders through the heaps
+  uint64_t SiftSteps{0};
+
+  uint32_t BuyDepth{0};
+  uint32_t SellDepth{0};
+  uint32_t BuyLevels{0};
+  uint32_t SellLevels{0};
+};
+
+// totals with per operation averages
+std::ostream& operator<<(std::ostream& os, const EngineStats& stats);
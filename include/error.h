@@ -33,11 +33,23 @@ class TcpSocketOptReuseAddrError : public BaseIOError {
       : BaseIOError("tcp setsockopt reuse addr error") {}
 };
 
+class TcpSocketOptReusePortError : public BaseIOError {
+ public:
+  TcpSocketOptReusePortError()
+      : BaseIOError("tcp setsockopt reuse port error") {}
+};
+
 class TcpSocketOptNoDelayError : public BaseIOError {
  public:
   TcpSocketOptNoDelayError() : BaseIOError("tcp setsockopt no delay error") {}
 };
 
+class TcpSocketOptNonBlockingError : public BaseIOError {
+ public:
+  TcpSocketOptNonBlockingError()
+      : BaseIOError("tcp fcntl non blocking error") {}
+};
+
 class TcpBindError : public BaseIOError {
  public:
   TcpBindError() : BaseIOError("tcp bind error") {}
@@ -52,3 +64,85 @@ class TcpAcceptError : public BaseIOError {
  public:
   TcpAcceptError() : BaseIOError("tcp accept error") {}
 };
+
+class UdpSocketCreateError : public BaseIOError {
+ public:
+  UdpSocketCreateError() : BaseIOError("udp socket create error") {}
+};
+
+class UdpBindError : public BaseIOError {
+ public:
+  UdpBindError() : BaseIOError("udp bind error") {}
+};
+
+class UdpSocketOptMulticastError : public BaseIOError {
+ public:
+  UdpSocketOptMulticastError()
+      : BaseIOError("udp setsockopt add membership error") {}
+};
+
+class SharedMemoryOpenError : public BaseIOError {
+ public:
+  SharedMemoryOpenError() : BaseIOError("shared memory open error") {}
+};
+
+class SharedMemoryTruncateError : public BaseIOError {
+ public:
+  SharedMemoryTruncateError() : BaseIOError("shared memory truncate error") {}
+};
+
+class SharedMemorySizeError : public BaseIOError {
+ public:
+  SharedMemorySizeError() : BaseIOError("shared memory size mismatch error") {}
+};
+
+class FileOpenError : public BaseIOError {
+ public:
+  FileOpenError() : BaseIOError("file open error") {}
+};
+
+class FileWriteError : public BaseIOError {
+ public:
+  FileWriteError() : BaseIOError("file write error") {}
+};
+
+class EpollCreateError : public BaseIOError {
+ public:
+  EpollCreateError() : BaseIOError("epoll create error") {}
+};
+
+class EpollCtlError : public BaseIOError {
+ public:
+  EpollCtlError() : BaseIOError("epoll ctl error") {}
+};
+
+class EpollWaitError : public BaseIOError {
+ public:
+  EpollWaitError() : BaseIOError("epoll wait error") {}
+};
+
+class IoUringSetupError : public BaseIOError {
+ public:
+  IoUringSetupError() : BaseIOError("io_uring setup error") {}
+};
+
+class IoUringRegisterError : public BaseIOError {
+ public:
+  IoUringRegisterError() : BaseIOError("io_uring register error") {}
+};
+
+class IoUringEnterError : public BaseIOError {
+ public:
+  IoUringEnterError() : BaseIOError("io_uring enter error") {}
+};
+
+class IoUringOpUnsupportedError : public BaseIOError {
+ public:
+  IoUringOpUnsupportedError()
+      : BaseIOError("io_uring operation not supported error") {}
+};
+
+class MemfdCreateError : public BaseIOError {
+ public:
+  MemfdCreateError() : BaseIOError("memfd create error") {}
+};
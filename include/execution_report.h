@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include "define.h"
+
+enum ExecType : uint8_t {
+  kAccepted = 0,
+  kRejected = 1,
+  kPartiallyFilled = 2,
+  kFilled = 3,
+  kCancelled = 4,
+};
+
+/**
+ * sent back on the session an order came in on, every inbound order is
+ * answered by exactly one of accepted, rejected or cancelled, followed by
+ * its fills if it trades
+ *
+ * Quantity is the filled quantity of a fill, the quantity taken off the
+ * book for a cancel and the order's quantity otherwise, LeavesQuantity is
+ * what is still resting afterwards
+ */
+struct ExecutionReport {
+  uint8_t ExecType;
+  ID_t Id;
+  Price_t Price;
+  Quantity_t Quantity;
+  Quantity_t LeavesQuantity;
+} __attribute__((packed, aligned(1)));
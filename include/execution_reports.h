@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include "execution_report.h"
+#include "linux/mirrored_buffer.h"
+#include "order.h"
+#include "tcp_transport.h"
+#include "trade_result.h"
+
+template <class T>
+concept ReportSender_t =
+    requires(T sender, uint64_t session, std::span<const uint8_t> buffer) {
+      // what the session took, -1 once the session has gone
+      { sender.Send(session, buffer) } -> std::same_as<int64_t>;
+      { sender.Disconnect(session) };
+    };
+
+/**
+ * execution reports of every session, encoded in place into a preallocated
+ * outbox per session and sent once per flush, so a flush costs one send per
+ * session with something to tell
+ *
+ * the session an order came in on is kept until the order is done, a fill
+ * of a resting order goes back to the session which placed it, whichever
+ * session sent the aggressor, reports for a session which has gone are
+ * dropped, only that session may cancel the order, a cancel from any
+ * other is rejected before it reaches the engine
+ *
+ * a session whose outbox fills up between flushes does not read its
+ * reports and is disconnected
+ */
+class ExecutionReports {
+ public:
+  static constexpr uint32_t kMaxSessions = TcpTransport::kMaxSessions;
+
+ public:
+  ExecutionReports();
+
+  void Accepted(uint64_t session, const Order& order);
+  void Rejected(uint64_t session, const Order& order);
+  void Cancelled(uint64_t session, const Order& order, Quantity_t quantity);
+  void Filled(const TradeResult& trade_result);
+  // only the session which placed an order may cancel it, an order it has
+  // no route for is left to the engine
+  bool MayCancel(uint64_t session, const Order& order) const;
+
+  template <ReportSender_t Sender>
+  void Flush(Sender& sender) {
+    uint32_t pending_count = 0;
+
+    for (uint32_t i = 0; i < m_dirty_count_; ++i) {
+      Outbox& outbox = m_outboxes_[m_dirty_[i]];
+
+      if (outbox.Overflowed) [[unlikely]] {
+        sender.Disconnect(outbox.Session);
+        outbox.Overflowed = false;
+        outbox.Sent = outbox.Written;
+      } else {
+        const int64_t byte_sent = sender.Send(
+            outbox.Session, {outbox.Ring.Data() + outbox.Sent % kOutboxLen,
+                             outbox.Written - outbox.Sent});
+
+        // nothing more can be sent to a session which has gone
+        outbox.Sent = byte_sent < 0 ? outbox.Written : outbox.Sent + byte_sent;
+      }
+
+      if (outbox.Sent < outbox.Written) {
+        // the socket is full, the rest goes with the next flush
+        m_dirty_[pending_count++] = m_dirty_[i];
+      } else {
+        outbox.Dirty = false;
+      }
+    }
+
+    m_dirty_count_ = pending_count;
+  }
+
+  // orders with reports still to come
+  uint64_t LiveOrders() const { return m_routes_.size(); }
+
+ private:
+  // a mirrored ring, a report straddling its end is still one write
+  static constexpr uint64_t kOutboxLen = 1 << 20;
+
+  struct Route {
+    uint64_t Session;
+    Quantity_t LeavesQuantity;
+  };
+
+  struct Outbox {
+    // the latest session on this slot
+    uint64_t Session{0};
+    // running byte counts
+    uint64_t Written{0};
+    uint64_t Sent{0};
+    bool Dirty{false};
+    bool Overflowed{false};
+    MirroredBuffer Ring{kOutboxLen};
+  };
+
+  // room for one report, nullptr if the session has gone or is too far
+  // behind
+  ExecutionReport* Reserve(uint64_t session);
+  void Report(uint64_t session,
+              ExecType exec_type,
+              ID_t id,
+              Price_t price,
+              Quantity_t quantity,
+              Quantity_t leaves_quantity);
+  void Fill(ID_t id, Price_t price, Quantity_t quantity);
+
+ private:
+  std::unordered_map<ID_t, Route> m_routes_;
+
+  std::unique_ptr<Outbox[]> m_outboxes_;
+  // outboxes with something left to send, each at most once
+  std::array<uint32_t, kMaxSessions> m_dirty_;
+  uint32_t m_dirty_count_{0};
+};
+
+// the order handler's view of ExecutionReports
+class SessionReports {
+ public:
+  explicit SessionReports(ExecutionReports& reports) : m_reports_{&reports} {}
+
+  void Accepted(uint64_t session, const Order& order) {
+    m_reports_->Accepted(session, order);
+  }
+
+  void Rejected(uint64_t session, const Order& order) {
+    m_reports_->Rejected(session, order);
+  }
+
+  void Cancelled(uint64_t session, const Order& order, Quantity_t quantity) {
+    m_reports_->Cancelled(session, order, quantity);
+  }
+
+  bool MayCancel(uint64_t session, const Order& order) const {
+    return m_reports_->MayCancel(session, order);
+  }
+
+  void Filled(const TradeResult& trade_result) {
+    m_reports_->Filled(trade_result);
+  }
+
+  template <ReportSender_t Sender>
+  void Flush(Sender& sender) {
+    m_reports_->Flush(sender);
+  }
+
+ private:
+  ExecutionReports* m_reports_;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include "linux/file_map.h"
+#include "order.h"
+
+/**
+ * orders read from a recorded order file instead of the network, handed
+ * over straight from the mapping in batches of at most kBatchOrders, as
+ * fast as the handler takes them
+ */
+class FileReplayTransport {
+ public:
+  static constexpr uint64_t kBatchOrders = 1024;
+
+ public:
+  // throws if the file is not an order file
+  explicit FileReplayTransport(std::string_view path);
+
+  template <class Handler>
+  bool Poll(Handler& handler, int) {
+    if (m_remaining_.empty()) [[unlikely]] {
+      return false;
+    }
+
+    const uint64_t len =
+        std::min<uint64_t>(m_remaining_.size(), kBatchOrders * sizeof(Order));
+    handler(m_remaining_.first(len));
+    m_remaining_ = m_remaining_.subspan(len);
+    return true;
+  }
+
+  bool Exhausted() const { return m_remaining_.empty(); }
+
+  uint64_t OrderCount() const { return m_records_.size() / sizeof(Order); }
+
+ private:
+  FileMap m_file_;
+  std::span<const uint8_t> m_records_;
+  std::span<const uint8_t> m_remaining_;
+};
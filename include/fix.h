@@ -0,0 +1,175 @@
+#pragma once
+
+#include <emmintrin.h>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+/**
+ * FIX 4.4 tag=value primitives, nothing here allocates
+ *
+ * | 8=FIX.4.4 | 9=BodyLength | body, 35=MsgType first | 10=CheckSum |
+ *
+ * every field ends in SOH, fields are found sixteen bytes at a time by
+ * comparing against SOH and '=' with SSE2, which every x86-64 has
+ */
+constexpr char kSoh = '\x01';
+
+enum FixTag : uint32_t {
+  kFixAvgPx = 6,
+  kFixBeginString = 8,
+  kFixBodyLength = 9,
+  kFixCheckSum = 10,
+  kFixClOrdId = 11,
+  kFixCumQty = 14,
+  kFixExecId = 17,
+  kFixLastPx = 31,
+  kFixLastQty = 32,
+  kFixMsgSeqNum = 34,
+  kFixMsgType = 35,
+  kFixOrderId = 37,
+  kFixOrderQty = 38,
+  kFixOrdStatus = 39,
+  kFixOrdType = 40,
+  kFixOrigClOrdId = 41,
+  kFixPrice = 44,
+  kFixSenderCompId = 49,
+  kFixSendingTime = 52,
+  kFixSide = 54,
+  kFixSymbol = 55,
+  kFixTargetCompId = 56,
+  kFixText = 58,
+  kFixEncryptMethod = 98,
+  kFixCxlRejReason = 102,
+  kFixHeartBtInt = 108,
+  kFixTestReqId = 112,
+  kFixExecType = 150,
+  kFixLeavesQty = 151,
+  kFixCxlRejResponseTo = 434,
+};
+
+constexpr std::string_view kFixBegin = "8=FIX.4.4\x01";
+// 10=ccc and its SOH
+constexpr uint32_t kFixTrailerLen = 7;
+
+/**
+ * length of the whole message at the front of buffer, 0 if it has not all
+ * arrived yet, -1 if the buffer does not start with a FIX 4.4 message
+ */
+int64_t FixMessageLength(std::span<const uint8_t> buffer);
+
+// modulo 256 sum of the bytes, as the CheckSum field carries it
+uint8_t FixChecksum(std::span<const uint8_t> buffer);
+
+/**
+ * the fields between BodyLength and CheckSum of a whole message, empty if
+ * its checksum does not match
+ */
+std::span<const uint8_t> FixBody(std::span<const uint8_t> message);
+
+// digits only, false if empty, anything else or too large
+bool ParseFixUint(std::string_view text, uint64_t& value);
+// a whole number, trailing decimals are accepted while they are zero
+bool ParseFixWholePrice(std::string_view text, uint64_t& value);
+
+/**
+ * calls visitor(tag, value) for every field of a body, the value points
+ * into the body, false if a field has no '=' or no numeric tag
+ */
+template <class Visitor>
+bool ForEachFixField(std::span<const uint8_t> body, Visitor&& visitor) {
+  const char* data = reinterpret_cast<const char*>(body.data());
+  const uint32_t len = body.size();
+
+  uint32_t field_start = 0;
+  uint32_t equals_at = UINT32_MAX;
+
+  auto on_mark = [&](uint32_t pos, bool is_equals) {
+    if (is_equals) {
+      // the first one, values may carry '=' of their own
+      if (equals_at == UINT32_MAX) {
+        equals_at = pos;
+      }
+      return true;
+    }
+
+    uint64_t tag;
+    if (equals_at == UINT32_MAX or
+        !ParseFixUint({data + field_start, equals_at - field_start}, tag))
+        [[unlikely]] {
+      return false;
+    }
+
+    visitor(static_cast<uint32_t>(tag),
+            std::string_view{data + equals_at + 1, pos - equals_at - 1});
+    field_start = pos + 1;
+    equals_at = UINT32_MAX;
+    return true;
+  };
+
+  const __m128i soh = _mm_set1_epi8(kSoh);
+  const __m128i equals = _mm_set1_epi8('=');
+
+  uint32_t base = 0;
+  for (; base + 16 <= len; base += 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + base));
+    const uint32_t soh_mask =
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, soh));
+    const uint32_t equals_mask =
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, equals));
+
+    for (uint32_t marks = soh_mask | equals_mask; marks != 0;
+         marks &= marks - 1) {
+      const uint32_t bit = __builtin_ctz(marks);
+      if (!on_mark(base + bit, equals_mask >> bit & 1)) [[unlikely]] {
+        return false;
+      }
+    }
+  }
+
+  // the tail, never read past the body
+  for (; base < len; ++base) {
+    if ((data[base] == kSoh or data[base] == '=') and
+        !on_mark(base, data[base] == '=')) [[unlikely]] {
+      return false;
+    }
+  }
+
+  return field_start == len;
+}
+
+/**
+ * builds one message, the body is collected first so BodyLength and
+ * CheckSum can be filled in around it by Finish, a field which would take
+ * the body past kMaxBodyLen is left out
+ */
+class FixWriter {
+ public:
+  static constexpr uint32_t kMaxBodyLen = 480;
+  // the most Finish writes
+  static constexpr uint32_t kMaxMessageLen = kMaxBodyLen + 32;
+
+ public:
+  FixWriter& Add(uint32_t tag, std::string_view value);
+  FixWriter& Add(uint32_t tag, uint64_t value);
+  FixWriter& Add(uint32_t tag, char value) {
+    return Add(tag, std::string_view{&value, 1});
+  }
+
+  // header, body and trailer into out, which holds kMaxMessageLen bytes,
+  // returns the length written and starts the next message
+  uint32_t Finish(uint8_t* out);
+
+  // fields left out because the body had no room for them
+  uint64_t DroppedCount() const { return m_dropped_count_; }
+
+ private:
+  // the caller has checked that text fits
+  void Append(std::string_view text);
+
+ private:
+  char m_body_[kMaxBodyLen];
+  uint32_t m_len_{0};
+  uint64_t m_dropped_count_{0};
+};
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "execution_report.h"
+#include "fix.h"
+#include "linux/mirrored_buffer.h"
+#include "order.h"
+#include "tcp_sessions.h"
+
+/**
+ * FIX 4.4 order entry, sessions are served by the same TcpSessions as
+ * TcpTransport's binary ones, every whole NewOrderSingle and
+ * OrderCancelRequest of a read is translated into a native order and the
+ * handler gets them as one batch
+ *
+ * ClOrdID is the engine's order id, so it has to be a number unique among
+ * the live orders of all sessions, OrderQty and Price are whole numbers,
+ * Price in ticks, only limit orders are taken, a cancel goes out with the
+ * price its order was placed at
+ *
+ * Send takes the binary execution reports of a session and writes them to
+ * it as ExecutionReport, or OrderCancelReject for a cancel which found
+ * nothing, the transport keeps what it needs about every live order of
+ * its sessions to fill those in
+ *
+ * logon, heartbeat, test request and logout are answered, sequence numbers
+ * of incoming messages are not checked and nothing is resent
+ */
+class FixTransport {
+ public:
+  static constexpr uint32_t kMaxSessions =
+      TcpSessions<TcpSession>::kMaxSessions;
+
+ public:
+  FixTransport(std::string host, uint16_t port);
+
+  template <class Handler>
+  bool Poll(Handler& handler, int timeout_ms) {
+    m_sessions_.Wait(timeout_ms);
+
+    bool received = false;
+
+    for (uint32_t remaining = m_sessions_.ReadyCount(); remaining > 0;
+         --remaining) {
+      const uint32_t index = m_sessions_.PopReady();
+      Session& session = m_sessions_[index];
+
+      // e.g. woken to send what a full socket did not take
+      FlushOutbox(session);
+
+      if (!session.Open or !ReadOnce(session)) {
+        continue;
+      }
+
+      // a batch at a time, a read may hold more messages than fit
+      bool more = true;
+      while (more and session.Open) {
+        const std::span<const uint8_t> orders = Translate(index, more);
+        if (orders.empty()) {
+          continue;
+        }
+
+        if constexpr (std::invocable<Handler&, std::span<const uint8_t>,
+                                     uint64_t>) {
+          handler(orders, m_sessions_.Key(index));
+        } else {
+          handler(orders);
+        }
+        received = true;
+      }
+
+      FlushOutbox(session);
+      m_sessions_.MarkReady(index);
+    }
+    return received;
+  }
+
+  static constexpr bool Exhausted() { return false; }
+
+  uint32_t SessionCount() const { return m_sessions_.Count(); }
+
+  // binary execution reports in, the whole ones taken are written to the
+  // session as FIX, -1 once the session has gone
+  int64_t Send(uint64_t session, std::span<const uint8_t> reports);
+  void Disconnect(uint64_t session);
+
+ private:
+  static constexpr uint64_t kRingLen = TcpSession::kRingLen;
+  static constexpr uint64_t kOutboxLen{1 << 20};
+  static constexpr uint32_t kBatchOrders = 4096;
+  static constexpr uint32_t kMaxCompIdLen = 32;
+
+  struct Session : TcpSession {
+    // a new connection in the slot
+    void Reset();
+
+    bool LoggedOn{false};
+    // closed once the outbox has gone out
+    bool LoggingOut{false};
+
+    uint64_t Written{0};
+    uint64_t Sent{0};
+    MirroredBuffer Outbox{kOutboxLen};
+
+    uint64_t NextSeqNum{1};
+    uint64_t NextExecId{1};
+    // theirs as they sent them, ours go the other way round
+    std::array<char, kMaxCompIdLen> SenderCompId;
+    uint8_t SenderCompIdLen{0};
+    std::array<char, kMaxCompIdLen> TargetCompId;
+    uint8_t TargetCompIdLen{0};
+    std::array<char, kMaxCompIdLen> Symbol;
+    uint8_t SymbolLen{0};
+  };
+
+  struct LiveOrder {
+    uint64_t Session;
+    Price_t Price;
+    Quantity_t OrderQuantity;
+    Quantity_t CumQuantity{0};
+    char Side;
+    // of the fills, for AvgPx
+    uint64_t Notional{0};
+    bool CancelPending{false};
+    // filled while a cancel was on its way, kept for the cancel's answer
+    bool Done{false};
+    ID_t CancelClOrdId{0};
+  };
+
+  // the fields of an inbound message the transport looks at
+  struct Fields {
+    std::string_view MsgType;
+    std::string_view SenderCompId;
+    std::string_view TargetCompId;
+    std::string_view ClOrdId;
+    std::string_view OrigClOrdId;
+    std::string_view Symbol;
+    std::string_view Side;
+    std::string_view OrderQty;
+    std::string_view OrdType;
+    std::string_view Price;
+    std::string_view TestReqId;
+    std::string_view HeartBtInt;
+  };
+
+  uint32_t Index(const Session& session) const {
+    return &session - &m_sessions_[0];
+  }
+  uint64_t Key(uint32_t index) const { return m_sessions_.Key(index); }
+  // the open session behind the key, nullptr if it has gone
+  Session* Find(uint64_t session);
+
+  // one read from a ready session, false once it has nothing more pending
+  bool ReadOnce(Session& session);
+  // also forgets the session's live orders
+  void CloseSession(Session& session);
+
+  // native orders of the next whole messages, more while some are left
+  std::span<const uint8_t> Translate(uint32_t index, bool& more);
+  void OnMessage(uint32_t index, const Fields& fields);
+  void OnNewOrder(uint32_t index, const Fields& fields);
+  void OnCancel(uint32_t index, const Fields& fields);
+
+  // room for one more message in the session's outbox
+  bool HasRoom(const Session& session) const;
+  // header fields, then the message's own, then out into the outbox
+  FixWriter& Begin(Session& session, char msg_type);
+  void Finish(Session& session);
+  void FlushOutbox(Session& session);
+
+  // answered by the transport itself, the order never reaches the engine
+  void Reject(Session& session, const Fields& fields, std::string_view text);
+  void CancelReject(Session& session,
+                    std::string_view cl_ord_id,
+                    std::string_view orig_cl_ord_id,
+                    char ord_status);
+  void Report(Session& session, const ExecutionReport& report);
+  // the fields every ExecutionReport of a live order carries, cl_ord_id is
+  // the order's id but for a cancel, which answers with the cancel
+  // request's
+  FixWriter& BeginReport(Session& session,
+                         ID_t id,
+                         ID_t cl_ord_id,
+                         const LiveOrder& order,
+                         char exec_type,
+                         char ord_status,
+                         Quantity_t leaves_quantity);
+
+  std::string_view SendingTime();
+
+ private:
+  TcpSessions<Session> m_sessions_;
+
+  std::unordered_map<ID_t, LiveOrder> m_orders_;
+
+  // raw, orders are constructed in place as messages are translated
+  std::unique_ptr<uint8_t[]> m_batch_;
+  uint32_t m_batch_count_{0};
+
+  FixWriter m_writer_;
+
+  // SendingTime only changes once a second
+  int64_t m_time_second_{-1};
+  // YYYYMMDD-HH:MM:SS and strftime's terminator
+  char m_time_text_[18];
+};
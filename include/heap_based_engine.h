@@ -5,6 +5,7 @@
 #include <span>
 #include "define.h"
 #include "engine_options.h"
+#include "engine_stats.h"
 #include "order_handler.h"
 
 class HeapBasedEngine {
@@ -40,10 +41,32 @@ class HeapBasedEngine {
 
   void AddOrder(BuyOrder order) noexcept;
   void AddOrder(SellOrder order) noexcept;
+  Quantity_t Cancel(CancelOrder order) noexcept;
 
   std::vector<TradeResult> Execute() noexcept;
 
+  // XOR of OrderHash over all resting orders, see state_hash.h
+  uint64_t StateHash() const noexcept { return m_state_hash_; }
+
+  // O(depth), the heaps are unordered so price levels are counted in a
+  // bitmap over the whole Price_t range
+  EngineStats Stats() const noexcept;
+
+  // rebinds the cache views after the instance has been mapped at a new
+  // address, e.g. a book reattached from shared memory, the orders are kept
+  void Reattach() noexcept;
+
  private:
+  void BindCaches() noexcept;
+
+  // removes the order with this id and price from one side's heap
+  Quantity_t CancelAt(ID_t id,
+                      Price_t price,
+                      OrderType_t order_type,
+                      uint32_t& count,
+                      std::span<Item> caches,
+                      auto&& comp) noexcept;
+
   uint8_t m_caches_[kMaxOrders * sizeof(Item) * 2];
 
   std::span<HeapBasedEngine::Item> m_buy_caches_;
@@ -53,4 +76,9 @@ class HeapBasedEngine {
   uint32_t m_sell_count_{0};
 
   uint32_t m_sequence_{0};
+
+  uint64_t m_state_hash_{0};
+
+  // counters only, the book shape is filled in by Stats()
+  EngineStats m_stats_;
 };
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <sched.h>
+#include <x86intrin.h>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+/**
+ * what a polling thread does while its ring stays empty (or full)
+ *
+ * by default it keeps spinning, the lowest latency at the cost of a core,
+ * adaptive waiting spins for a while, then yields, then sleeps in short
+ * naps, so an idle consumer gives its core back, no futex is involved so
+ * the producer never has to wake anyone
+ */
+class IdleWait {
+ public:
+  explicit IdleWait(bool adaptive) : m_adaptive_{adaptive} {}
+
+  void Idle() noexcept {
+    if (!m_adaptive_) {
+      return;
+    }
+
+    if (m_rounds_ < kSpinRounds) {
+      _mm_pause();
+    } else if (m_rounds_ < kSpinRounds + kYieldRounds) {
+      sched_yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds{50});
+      return;
+    }
+    ++m_rounds_;
+  }
+
+  // after every round which found work
+  void Reset() noexcept { m_rounds_ = 0; }
+
+ private:
+  static constexpr uint32_t kSpinRounds = 10'000;
+  static constexpr uint32_t kYieldRounds = 100;
+
+  bool m_adaptive_;
+  uint32_t m_rounds_{0};
+};
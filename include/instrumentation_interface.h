@@ -0,0 +1,31 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include "define.h"
+
+enum class Stage : uint8_t {
+  kBatch,     // one received buffer through the order handler
+  kAddOrder,  // Engine::AddOrder
+  kCancel,    // Engine::Cancel
+  kExecute,   // Engine::Execute
+  kPublish,   // handing the trades to the observer
+};
+
+constexpr uint32_t kStageCount = 5;
+
+template <class T>
+concept Instrumentation_t =
+    requires(T instrumentation, Stage stage, ID_t id, uint64_t timestamp) {
+      { instrumentation.Now() } -> std::same_as<uint64_t>;
+      // id is the order the stage worked on, 0 for a whole batch
+      { instrumentation.Record(stage, id, timestamp, timestamp) };
+      { instrumentation.Poll() };
+    };
+
+// the default, every call is empty and compiles away
+struct NoInstrumentation {
+  uint64_t Now() const noexcept { return 0; }
+  void Record(Stage, ID_t, uint64_t, uint64_t) noexcept {}
+  void Poll() noexcept {}
+};
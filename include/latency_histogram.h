@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include "latency_summary.h"
+
+/**
+ * log linear histogram: values below kSubBucketCount have a bucket each,
+ * every power of two above is split into kSubBucketCount linear buckets, so
+ * a recorded value is off by at most 1/16 of itself, over the whole uint64_t
+ * range, in under 8KB
+ *
+ * single writer, the counters are atomics only so another process may read
+ * them while they are written, a record is a few plain loads and stores
+ */
+struct LatencyHistogram {
+  static constexpr uint32_t kSubBucketBits = 4;
+  static constexpr uint32_t kSubBucketCount = 1 << kSubBucketBits;
+  static constexpr uint32_t kBucketCount =
+      (64 - kSubBucketBits + 1) * kSubBucketCount;
+
+  static constexpr uint32_t BucketIndex(uint64_t value) {
+    if (value < kSubBucketCount) {
+      return value;
+    }
+
+    const uint32_t shift = 63 - std::countl_zero(value) - kSubBucketBits;
+    return (shift + 1) * kSubBucketCount + (value >> shift) - kSubBucketCount;
+  }
+
+  // the largest value falling into the bucket
+  static constexpr uint64_t BucketValue(uint32_t index) {
+    if (index < kSubBucketCount) {
+      return index;
+    }
+
+    const uint32_t shift = index / kSubBucketCount - 1;
+    const uint64_t sub_bucket = index % kSubBucketCount + kSubBucketCount;
+    return ((sub_bucket + 1) << shift) - 1;
+  }
+
+  void Record(uint64_t value) noexcept {
+    Increment(Counts[BucketIndex(value)], 1);
+    Increment(Sum, value);
+
+    if (value > Max.load(std::memory_order_relaxed)) {
+      Max.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  // not safe against a concurrent Record, the writer resets
+  void Reset() noexcept;
+
+  static void Increment(std::atomic<uint64_t>& counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value,
+                  std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> Counts[kBucketCount]{};
+  std::atomic<uint64_t> Sum{0};
+  std::atomic<uint64_t> Max{0};
+};
+
+// percentiles are bucket upper bounds, scaled from ticks to nanoseconds
+LatencySummary Summarize(const LatencyHistogram& histogram,
+                         double ticks_per_ns);
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include "engine_stats.h"
+#include "instrumentation_interface.h"
+#include "latency_histogram.h"
+#include "linux/shared_memory.h"
+#include "tsc.h"
+
+std::string_view StageName(Stage stage);
+
+/**
+ * per stage histograms of tsc ticks in a named shared mapping, e.g. under
+ * /dev/shm, written by the engine and read by the latency_stats tool while
+ * the engine keeps running
+ *
+ * a reader cannot clear the histograms under the writer, it bumps
+ * ResetRequest instead and the writer clears them at its next Poll
+ *
+ * the engine's EngineStats are published next to them, guarded by a
+ * sequence number which is odd while a snapshot is being written
+ */
+class LatencyStats {
+ private:
+  struct Page {
+    std::atomic<uint64_t> Magic{0};
+    uint32_t Version{0};
+    std::atomic<double> TicksPerNs{1.0};
+    std::atomic<uint64_t> ResetRequest{0};
+    std::atomic<uint64_t> ResetDone{0};
+    LatencyHistogram Stages[kStageCount];
+    std::atomic<uint64_t> EngineSequence{0};
+    EngineStats Engine;
+  };
+
+  static constexpr uint64_t kMagic = 0x5354414c454d5450;  // "PTMELATS"
+  static constexpr uint32_t kVersion = 2;
+
+ public:
+  explicit LatencyStats(std::string_view path);
+
+  LatencyStats(const LatencyStats&) = delete;
+  LatencyStats& operator=(const LatencyStats&) = delete;
+
+  void Record(Stage stage, uint64_t ticks) noexcept {
+    m_page_->Stages[static_cast<uint32_t>(stage)].Record(ticks);
+  }
+
+  // writer side, applies a pending reset request
+  void Poll() noexcept {
+    const uint64_t request =
+        m_page_->ResetRequest.load(std::memory_order_acquire);
+
+    if (request != m_page_->ResetDone.load(std::memory_order_relaxed))
+        [[unlikely]] {
+      for (auto& histogram : m_page_->Stages) {
+        histogram.Reset();
+      }
+      m_page_->ResetDone.store(request, std::memory_order_release);
+    }
+  }
+
+  // writer side
+  void PublishEngineStats(const EngineStats& stats) noexcept;
+
+  void SetTicksPerNs(double ticks_per_ns) {
+    m_page_->TicksPerNs.store(ticks_per_ns, std::memory_order_relaxed);
+  }
+
+  // reader side
+  LatencySummary Summary(Stage stage) const;
+  // retries while a snapshot is being published
+  EngineStats EngineSnapshot() const;
+  void RequestReset() noexcept;
+
+ private:
+  SharedMemory m_memory_;
+  Page* m_page_;
+};
+
+// times every stage of the order handler into a LatencyStats
+class StageInstrumentation {
+ public:
+  explicit StageInstrumentation(LatencyStats& stats) : m_stats_{&stats} {}
+
+  uint64_t Now() const noexcept { return ReadTsc(); }
+
+  void Record(Stage stage, ID_t, uint64_t start, uint64_t end) noexcept {
+    m_stats_->Record(stage, end - start);
+  }
+
+  void Poll() noexcept { m_stats_->Poll(); }
+
+ private:
+  LatencyStats* m_stats_;
+};
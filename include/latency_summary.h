@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+struct LatencySummary {
+  uint64_t Count{0};
+  double Mean{0};
+  uint64_t P50{0};
+  uint64_t P90{0};
+  uint64_t P99{0};
+  uint64_t P999{0};
+  uint64_t P9999{0};
+  uint64_t Max{0};
+};
+
+// nearest rank percentiles, sorts the samples in place
+LatencySummary Summarize(std::vector<uint64_t>& samples);
+
+std::ostream& operator<<(std::ostream& os, const LatencySummary& summary);
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <sys/epoll.h>
+#include <cstdint>
+#include <span>
+
+// edge triggered readiness of many descriptors, each registered with a
+// caller chosen tag which comes back in its events
+class Epoll {
+ public:
+  Epoll();
+  ~Epoll();
+
+  Epoll(const Epoll&) = delete;
+  Epoll& operator=(const Epoll&) = delete;
+
+  // writable also reports the descriptor once its send buffer frees up
+  void Add(int fd, uint64_t tag, bool writable = false);
+  void Remove(int fd);
+
+  // number of events filled in, 0 on timeout or when a signal interrupted
+  // the wait, a negative timeout waits for ever
+  int Wait(std::span<epoll_event> events, int timeout_ms);
+
+ private:
+  int m_fd_;
+};
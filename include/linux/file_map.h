@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+// read only mapping of a whole file, pages are populated up front
+class FileMap {
+ public:
+  explicit FileMap(std::string_view path);
+  ~FileMap();
+
+  FileMap(const FileMap&) = delete;
+  FileMap& operator=(const FileMap&) = delete;
+
+  std::span<const uint8_t> Data() const { return {m_address_, m_len_}; }
+
+ private:
+  const uint8_t* m_address_{nullptr};
+  uint64_t m_len_{0};
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Len bytes of memory mapped twice back to back, writing past the end of
+ * the first mapping lands at its start, so any Len bytes from an offset
+ * inside the first mapping are one contiguous span, Len is a multiple of
+ * the page size
+ *
+ * backed by a memfd, pages are only allocated once touched
+ */
+class MirroredBuffer {
+ public:
+  explicit MirroredBuffer(uint64_t len);
+  ~MirroredBuffer();
+
+  MirroredBuffer(const MirroredBuffer&) = delete;
+  MirroredBuffer& operator=(const MirroredBuffer&) = delete;
+
+  uint64_t Len() const { return m_len_; }
+  // 2 * Len addressable bytes
+  uint8_t* Data() const { return m_address_; }
+
+ private:
+  uint8_t* m_address_;
+  uint64_t m_len_;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+enum class PerfEvent : uint8_t {
+  kCycles,
+  kInstructions,
+  kBranchMisses,
+  kL1dMisses,
+  kLlcMisses,
+};
+
+constexpr uint32_t kPerfEventCount = 5;
+
+std::string_view PerfEventName(PerfEvent event);
+
+// totals since the counters were opened, empty for an unsupported event
+struct PerfReading {
+  std::array<std::optional<uint64_t>, kPerfEventCount> Values;
+
+  std::optional<double> PerOp(PerfEvent event, uint64_t op_count) const;
+  std::optional<double> Ipc() const;
+};
+
+/**
+ * user space hardware counters of the calling thread, opened as one
+ * perf_event_open group so they are scheduled (and scaled) together
+ *
+ * counting only happens between Enable and Disable, two instances around
+ * two alternating operations count them separately
+ *
+ * never throws, events the pmu or perf_event_paranoid do not allow are left
+ * out, Available is false if none could be opened and Error says why
+ */
+class PerfCounters {
+ public:
+  PerfCounters();
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  bool Available() const { return m_leader_fd_ != -1; }
+  const std::string& Error() const { return m_error_; }
+
+  void Enable() noexcept;
+  void Disable() noexcept;
+
+  PerfReading Read() const;
+
+ private:
+  int m_leader_fd_{-1};
+  std::array<int, kPerfEventCount> m_fds_;
+  // position of each event in a group read, -1 if it is not counted
+  std::array<int, kPerfEventCount> m_slots_;
+  uint32_t m_slot_count_{0};
+
+  std::string m_error_;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// MAP_SHARED mapping of a named file, e.g. under /dev/shm or a hugetlbfs
+// mount, which outlives the process that created it
+class SharedMemory {
+ public:
+  SharedMemory(std::string_view path, uint64_t len);
+  ~SharedMemory();
+
+  SharedMemory(const SharedMemory&) = delete;
+  SharedMemory& operator=(const SharedMemory&) = delete;
+
+  // true if the backing file was created (or empty) when it was mapped
+  bool Created() const { return m_created_; }
+  uint64_t Len() const { return m_len_; }
+  void* Address() const { return m_address_; }
+
+ private:
+  void* m_address_;
+  uint64_t m_len_;
+  bool m_created_{false};
+};
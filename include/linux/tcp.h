@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 #include <span>
 #include <string_view>
 
@@ -16,7 +17,12 @@ class TcpSocket {
   void Listen(int backlog);
 
   TcpSocket Accept();
+  // non blocking accept of a non blocking connection, empty if none is
+  // pending, the listening socket must be non blocking itself
+  std::optional<TcpSocket> TryAccept();
   int Recv(std::span<uint8_t> buffer);
+  // non blocking receive, -1 with errno EAGAIN if nothing is pending
+  int TryRecv(std::span<uint8_t> buffer);
   int Send(std::span<const uint8_t> buffer);
 
   void Close();
@@ -28,5 +34,8 @@ class TcpSocket {
 };
 
 void SetSocketReusable(TcpSocket sock);
+// several listeners on one port, the kernel spreads connections over them
+void SetSocketSharedPort(TcpSocket sock);
 void SetSocketNoDelay(TcpSocket sock);
+void SetSocketNonBlocking(TcpSocket sock);
 bool IsNoDelay(TcpSocket sock);
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+class UdpSocket {
+ public:
+  UdpSocket();
+  UdpSocket(int fd);
+
+  void Bind(std::string_view host, unsigned short port);
+  // the peer every Send goes to, a unicast address or a multicast group
+  bool Connect(std::string_view host, unsigned short port);
+
+  int Recv(std::span<uint8_t> buffer);
+  // non blocking receive, -1 with errno EAGAIN if nothing is pending
+  int TryRecv(std::span<uint8_t> buffer);
+  // one datagram, -1 if it could not be queued
+  int Send(std::span<const uint8_t> buffer);
+
+  void Close();
+
+  const int Fd() { return m_fd_; }
+
+ private:
+  int m_fd_;
+};
+
+bool IsMulticastAddress(std::string_view host);
+// receives what is sent to group on any interface, the socket is bound to
+// the group's port
+void JoinMulticastGroup(UdpSocket sock, std::string_view group);
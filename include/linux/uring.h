@@ -0,0 +1,104 @@
+#pragma once
+
+#include <linux/io_uring.h>
+#include <atomic>
+#include <cstdint>
+#include <span>
+
+/**
+ * io_uring instance driven through the raw system calls
+ *
+ * sqes are queued with GetSqe and handed to the kernel by Submit, which is a
+ * single io_uring_enter for everything queued since the last one, or with
+ * sqpoll only a store plus a wake up of the kernel's poller thread if it
+ * went to sleep, completions are reaped from the mapped ring without a
+ * system call
+ *
+ * the constructor throws if the kernel has no (or a disabled) io_uring, so
+ * the caller can fall back to plain sockets
+ */
+class IoUring {
+ public:
+  IoUring(uint32_t entries, bool sqpoll);
+  ~IoUring();
+
+  IoUring(const IoUring&) = delete;
+  IoUring& operator=(const IoUring&) = delete;
+
+  // zeroed, nullptr if every sqe is queued already, Submit and try again
+  io_uring_sqe* GetSqe() noexcept;
+
+  void Submit();
+  // submits and waits up to timeout_ms (-1 for ever) for a completion
+  void SubmitAndWait(int timeout_ms);
+
+  // calls handler for every completion posted so far, oldest first
+  template <class Handler>
+  uint32_t ForEachCqe(Handler&& handler) {
+    uint32_t head = *m_cq_head_;
+    const uint32_t tail =
+        std::atomic_ref<uint32_t>(*m_cq_tail_).load(std::memory_order_acquire);
+
+    const uint32_t count = tail - head;
+    for (; head != tail; ++head) {
+      handler(m_cqes_[head & m_cq_mask_]);
+    }
+
+    std::atomic_ref<uint32_t>(*m_cq_head_).store(head,
+                                                 std::memory_order_release);
+    return count;
+  }
+
+  // fixed file table, -1 leaves a slot empty for direct descriptors
+  void RegisterFiles(std::span<const int> fds);
+  // slots direct accepts may allocate from
+  void SetFileAllocRange(uint32_t offset, uint32_t len);
+  // a single fixed buffer, index 0
+  void RegisterBuffer(const void* address, uint64_t len);
+  // provided buffer ring for buffer select, entries is a power of two
+  void RegisterBufferRing(io_uring_buf_ring* ring,
+                          uint32_t entries,
+                          uint16_t group);
+
+  // whether this kernel knows the opcode, a ring sets up on kernels which
+  // predate some of the operations
+  bool Supports(uint8_t opcode);
+
+  bool SqPoll() const { return m_sqpoll_; }
+
+ private:
+  int Enter(uint32_t to_submit,
+            uint32_t min_complete,
+            uint32_t flags,
+            const void* arg,
+            uint64_t arg_len);
+  void Register(uint32_t opcode, const void* arg, uint32_t count);
+  uint32_t Flush() noexcept;
+
+ private:
+  int m_fd_;
+  bool m_sqpoll_;
+
+  void* m_sq_ring_;
+  uint64_t m_sq_ring_len_;
+  void* m_cq_ring_;
+  uint64_t m_cq_ring_len_;
+  io_uring_sqe* m_sqes_;
+  uint64_t m_sqes_len_;
+
+  uint32_t* m_sq_head_;
+  uint32_t* m_sq_tail_;
+  uint32_t* m_sq_flags_;
+  uint32_t* m_sq_array_;
+  uint32_t m_sq_mask_;
+  uint32_t m_sq_entries_;
+
+  uint32_t* m_cq_head_;
+  uint32_t* m_cq_tail_;
+  io_uring_cqe* m_cqes_;
+  uint32_t m_cq_mask_;
+
+  // sqes handed out by GetSqe but not yet published to the kernel
+  uint32_t m_sqe_head_{0};
+  uint32_t m_sqe_tail_{0};
+};
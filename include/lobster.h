@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include "order.h"
+
+/**
+ * LOBSTER message files, one event per line
+ *
+ * <time>,<type>,<order id>,<size>,<price>,<direction>
+ *
+ * time is seconds after midnight, price is in units of 1/10000 of the
+ * currency, direction is 1 for a buy and -1 for a sell order, for an
+ * execution it is the side of the resting order
+ */
+namespace lobster {
+
+constexpr int kSubmission = 1;
+constexpr int kPartialCancel = 2;
+constexpr int kDeletion = 3;
+constexpr int kExecution = 4;
+constexpr int kHiddenExecution = 5;
+constexpr int kCrossTrade = 6;
+constexpr int kTradingHalt = 7;
+
+// one cent, the tick of most US equities
+constexpr int64_t kDefaultTickSize = 100;
+
+struct Message {
+  int Type;
+  uint64_t OrderId;
+  int64_t Size;
+  int64_t Price;
+  int Direction;
+};
+
+/**
+ * calls on_message(const Message&) for every well formed line, returns the
+ * number of malformed lines skipped, the time field is not needed to replay
+ * the flow in order and is not converted
+ */
+template <class OnMessage>
+uint64_t ParseMessages(std::string_view text, OnMessage&& on_message) {
+  const char* cursor = text.data();
+  const char* const end = text.data() + text.size();
+
+  uint64_t malformed = 0;
+
+  auto field = [&](auto& value) {
+    const auto [ptr, ec] = std::from_chars(cursor, end, value);
+    cursor = ptr;
+    return ec == std::errc{};
+  };
+
+  auto skip = [&](char delimiter) {
+    if (cursor != end and *cursor == delimiter) {
+      ++cursor;
+      return true;
+    }
+    return false;
+  };
+
+  while (cursor != end) {
+    const char* const line = cursor;
+
+    const void* time_end = std::memchr(cursor, ',', end - cursor);
+    cursor = time_end == nullptr ? end : static_cast<const char*>(time_end);
+
+    Message message;
+
+    const bool parsed = skip(',') and field(message.Type) and skip(',') and
+                        field(message.OrderId) and skip(',') and
+                        field(message.Size) and skip(',') and
+                        field(message.Price) and skip(',') and
+                        field(message.Direction);
+
+    skip('\r');
+
+    if (parsed and (cursor == end or skip('\n'))) [[likely]] {
+      on_message(message);
+      continue;
+    }
+
+    if (*line != '\n' and *line != '\r') {
+      ++malformed;
+    }
+
+    const void* line_end = std::memchr(line, '\n', end - line);
+    cursor = line_end == nullptr ? end : static_cast<const char*>(line_end) + 1;
+  }
+
+  return malformed;
+}
+
+struct TranslateCount {
+  uint64_t Submissions{0};
+  uint64_t Cancels{0};
+  uint64_t Executions{0};
+  // an event for an order submitted before the file starts
+  uint64_t UnknownOrders{0};
+  // prices beyond the Price_t range around the base price
+  uint64_t OutOfRange{0};
+  // hidden executions, cross trades and halts have no order to replay
+  uint64_t Ignored{0};
+};
+
+/**
+ * turns LOBSTER events into this engine's order stream
+ *
+ * - a submission becomes a buy or sell order with the LOBSTER id
+ * - a deletion becomes a cancel
+ * - a partial cancel becomes a cancel followed by the remaining size added
+ *   again under the same id, the order loses its time priority
+ * - a visible execution becomes an aggressive order on the other side, at
+ *   the resting price and for the executed size, with an id above
+ *   kAggressorIdBase so it never collides with a LOBSTER id
+ *
+ * prices are converted to ticks and shifted so that the first price seen
+ * (or the given base price) lands in the middle of the Price_t range
+ */
+class Translator {
+ public:
+  static constexpr ID_t kAggressorIdBase = ID_t{1} << 63;
+
+  explicit Translator(int64_t tick_size = kDefaultTickSize,
+                      int64_t base_price = 0)
+      : m_tick_size_{tick_size}, m_base_price_{base_price} {}
+
+  // calls on_order(const Order&) for each order the message turns into
+  void Translate(const Message& message, auto&& on_order);
+
+  const TranslateCount& Count() const { return m_count_; }
+
+ private:
+  struct LiveOrder {
+    OrderType_t Side;
+    Price_t Price;
+    int64_t Size;
+  };
+
+  bool ToPrice(int64_t price, Price_t& ticks);
+
+ private:
+  int64_t m_tick_size_;
+  int64_t m_base_price_;
+
+  std::unordered_map<uint64_t, LiveOrder> m_live_;
+  ID_t m_next_aggressor_id_{kAggressorIdBase};
+
+  TranslateCount m_count_;
+};
+
+// sizes above the Quantity_t range are capped
+inline Quantity_t ToQuantity(int64_t size) {
+  return size > 65535 ? 65535 : static_cast<Quantity_t>(size);
+}
+
+void Translator::Translate(const Message& message, auto&& on_order) {
+  if (message.Type == kSubmission) {
+    Price_t price;
+    if (!ToPrice(message.Price, price)) {
+      ++m_count_.OutOfRange;
+      return;
+    }
+
+    const OrderType_t side = message.Direction > 0 ? kBuy : kSell;
+    m_live_[message.OrderId] =
+        LiveOrder{.Side = side, .Price = price, .Size = message.Size};
+    ++m_count_.Submissions;
+
+    on_order(Order(side, message.OrderId, price, ToQuantity(message.Size)));
+    return;
+  }
+
+  if (message.Type != kPartialCancel and message.Type != kDeletion and
+      message.Type != kExecution) {
+    ++m_count_.Ignored;
+    return;
+  }
+
+  const auto found = m_live_.find(message.OrderId);
+  if (found == std::end(m_live_)) {
+    ++m_count_.UnknownOrders;
+    return;
+  }
+
+  LiveOrder& live = found->second;
+  const int64_t size = std::min(
+      message.Type == kDeletion ? live.Size : message.Size, live.Size);
+  live.Size -= size;
+
+  if (message.Type == kExecution) {
+    const OrderType_t side = live.Side == kBuy ? kSell : kBuy;
+    ++m_count_.Executions;
+
+    on_order(Order(side, m_next_aggressor_id_++, live.Price, ToQuantity(size)));
+  } else {
+    ++m_count_.Cancels;
+
+    on_order(CancelOrder(message.OrderId, live.Price));
+    if (live.Size > 0) {
+      on_order(Order(live.Side, message.OrderId, live.Price,
+                     ToQuantity(live.Size)));
+    }
+  }
+
+  if (live.Size == 0) {
+    m_live_.erase(found);
+  }
+}
+
+}  // namespace lobster
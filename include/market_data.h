@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include "book_depth.h"
+#include "codec.h"
+#include "define.h"
+#include "linux/udp.h"
+#include "messages.h"
+
+// the most levels per side a feed carries, a full incremental still fits
+// one datagram on an ethernet mtu
+constexpr uint32_t kMaxDepthLevels = 20;
+
+enum DepthPacketKind : uint8_t {
+  kIncremental = 0,
+  kSnapshot = 1,
+};
+
+// the top levels of both sides, best first, indexed by kBuy and kSell
+struct DepthView {
+  std::array<std::array<DepthLevel, kMaxDepthLevels>, 2> Levels{};
+  std::array<uint32_t, 2> Count{};
+
+  std::span<const DepthLevel> Side(OrderType_t side) const {
+    return {Levels[side].data(), Count[side]};
+  }
+
+  // sets a level, or takes it out with a quantity of 0, the side stays in
+  // price order and a level past the last slot is dropped
+  void Apply(const DepthUpdate& update);
+};
+
+bool operator==(const DepthView& lhs, const DepthView& rhs);
+
+// the updates turning before into after, levels which have gone come first,
+// out has room for 4 * kMaxDepthLevels, returns how many were filled in
+uint32_t DiffDepth(const DepthView& before,
+                   const DepthView& after,
+                   std::span<DepthUpdate> out);
+
+/**
+ * conflated top of book over udp, to a unicast address or a multicast group
+ *
+ * Update runs on the matching thread after each batch and only copies the
+ * top levels of BookDepth, when they changed, into the latest view behind
+ * a sequence lock, it never waits on the publisher
+ *
+ * Run sends on its own thread: once an interval, the levels of the latest
+ * view which differ from what was sent last, in one datagram, so however
+ * often a level changed in between it costs one update, and the feed
+ * never takes more than one datagram of at most 4 * depth levels an
+ * interval whatever the order flow, and once a snapshot interval the
+ * whole view, for subscribers which joined late or lost a datagram
+ *
+ * every datagram is a DepthPacketMessage followed by its levels as
+ * DepthLevelMessage, incrementals are numbered from 1 and a snapshot
+ * carries the number of the last incremental it includes
+ */
+class MarketDataPublisher {
+ public:
+  static constexpr uint32_t kMaxPacketLen =
+      Encoder<DepthPacketMessage>::kLength +
+      4 * kMaxDepthLevels * Encoder<DepthLevelMessage>::kLength;
+
+ public:
+  // depth is capped at kMaxDepthLevels
+  MarketDataPublisher(
+      std::string_view host,
+      uint16_t port,
+      uint32_t depth = 10,
+      std::chrono::milliseconds interval = std::chrono::milliseconds{10},
+      std::chrono::milliseconds snapshot_interval = std::chrono::seconds{1});
+
+  MarketDataPublisher(const MarketDataPublisher&) = delete;
+  MarketDataPublisher& operator=(const MarketDataPublisher&) = delete;
+
+  // matching thread, fed through DepthReports
+  BookDepth& Book() { return m_book_; }
+
+  // matching thread, publishes the book's top levels if they changed
+  void Update() noexcept;
+
+  void Run();  // this is blocking run
+
+  // Run's thread, the levels changed since the last incremental, false if
+  // there were none and nothing was sent
+  bool SendIncremental();
+  void SendSnapshot();
+
+  // Run's thread, incrementals sent so far
+  uint64_t Sequence() const { return m_sequence_; }
+
+ private:
+  void ReadLatest(DepthView& view) const noexcept;
+  void SendPacket(DepthPacketKind kind, std::span<const DepthUpdate> updates);
+
+ private:
+  const uint32_t m_depth_;
+  const std::chrono::milliseconds m_interval_;
+  const std::chrono::milliseconds m_snapshot_interval_;
+
+  UdpSocket m_sock_;
+
+  // the matching thread's side
+  BookDepth m_book_;
+  uint64_t m_book_version_{0};
+  DepthView m_top_;
+
+  // odd while the matching thread writes the latest view
+  alignas(64) std::atomic<uint64_t> m_latest_version_{0};
+  DepthView m_latest_;
+
+  // the publisher's side, what subscribers have been sent
+  alignas(64) DepthView m_sent_;
+  DepthView m_read_;
+  uint64_t m_sequence_{0};
+};
+
+/**
+ * a subscriber's copy of the published view, it is synced by the first
+ * snapshot, applies incrementals in order and on a gap waits for the next
+ * snapshot
+ */
+class DepthFeed {
+ public:
+  // one datagram, false if it was not applied, i.e. it is malformed, old,
+  // or arrived while waiting for a snapshot
+  bool Apply(std::span<const uint8_t> packet);
+
+  bool Synced() const { return m_synced_; }
+  const DepthView& View() const { return m_view_; }
+  // the last incremental applied
+  uint64_t Sequence() const { return m_sequence_; }
+  uint64_t GapCount() const { return m_gap_count_; }
+
+ private:
+  DepthView m_view_;
+  uint64_t m_sequence_{0};
+  bool m_synced_{false};
+  uint64_t m_gap_count_{0};
+};
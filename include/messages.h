@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "book_depth.h"
+#include "codec.h"
+#include "define.h"
+#include "execution_report.h"
+#include "order.h"
+#include "trade_result.h"
+
+/**
+ * schemas of the wire messages, the field indices name the fields
+ *
+ * version 1 of each block is byte for byte the packed struct the engine
+ * already uses, so the block of a decoded order message goes to the order
+ * handler as is, fields of later versions are appended behind it
+ */
+struct OrderMessage : Schema<1, 1, OrderType_t, ID_t, Price_t, Quantity_t> {
+  enum : uint32_t { kOrderType, kId, kPrice, kQuantity };
+};
+
+struct TradeResultMessage
+    : Schema<2, 1, ID_t, ID_t, Price_t, Price_t, Quantity_t> {
+  enum : uint32_t { kBuyId, kSellId, kBuyPrice, kSellPrice, kQuantity };
+};
+
+struct ExecutionReportMessage
+    : Schema<3, 1, uint8_t, ID_t, Price_t, Quantity_t, Quantity_t> {
+  enum : uint32_t { kExecType, kId, kPrice, kQuantity, kLeavesQuantity };
+};
+
+// a market data datagram starts with the packet, its levels follow
+struct DepthPacketMessage : Schema<4, 1, uint64_t, uint8_t, uint16_t> {
+  enum : uint32_t { kSequence, kKind, kLevelCount };
+};
+
+struct DepthLevelMessage : Schema<5, 1, OrderType_t, Price_t, uint32_t> {
+  enum : uint32_t { kSide, kPrice, kQuantity };
+};
+
+static_assert(OrderMessage::kBlockLength == sizeof(Order));
+static_assert(TradeResultMessage::kBlockLength == sizeof(TradeResult));
+static_assert(TradeResultMessage::kOffsets[TradeResultMessage::kQuantity] ==
+              offsetof(TradeResult, Quantity));
+static_assert(ExecutionReportMessage::kBlockLength ==
+              sizeof(ExecutionReport));
+static_assert(ExecutionReportMessage::kOffsets
+                  [ExecutionReportMessage::kLeavesQuantity] ==
+              offsetof(ExecutionReport, LeavesQuantity));
+static_assert(DepthLevelMessage::kBlockLength == sizeof(DepthUpdate));
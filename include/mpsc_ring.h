@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+/**
+ * bounded multi producer single consumer ring of trivially copyable items
+ *
+ * a producer claims a run of slots for its whole batch with one fetch-add
+ * of the shared head, the claim is the batch's place in the total order,
+ * it then copies the items in and stamps each slot with its sequence
+ * number, so producers fill their runs concurrently and nobody locks
+ *
+ * the consumer reads stamped slots in place, oldest first, and stops at
+ * the first slot whose producer has not finished yet, a batch is never
+ * seen out of order or in part before an older one, the slots are handed
+ * back with one release store of its tail
+ *
+ * a claim cannot be taken back, so a producer a full ring ahead of the
+ * consumer waits for room after claiming, the items are copied into raw
+ * bytes so they need no default constructor
+ */
+template <class T, uint64_t Capacity>
+class MpscRing {
+  static_assert(std::has_single_bit(Capacity));
+  static_assert(std::is_trivially_copyable_v<T>);
+
+  static constexpr uint64_t kCacheLineSize = 64;
+  static constexpr uint64_t kMask = Capacity - 1;
+
+ public:
+  static constexpr uint64_t kCapacity = Capacity;
+
+  // zeroed stamps, no slot holds an item before its first lap
+  MpscRing()
+      : m_stamps_{std::make_unique<std::atomic<uint64_t>[]>(Capacity)} {}
+
+  // any producer, at most Capacity items, returns the sequence number of
+  // the first, waits while the consumer is a ring behind
+  uint64_t Push(std::span<const T> items) noexcept {
+    const uint64_t start =
+        m_head_.fetch_add(items.size(), std::memory_order_relaxed);
+    const uint64_t end = start + items.size();
+
+    while (end - m_tail_.load(std::memory_order_acquire) > Capacity) {
+    }
+
+    const uint64_t index = start & kMask;
+    const uint64_t first = std::min<uint64_t>(items.size(), Capacity - index);
+
+    std::memcpy(Slots() + index, items.data(), first * sizeof(T));
+    std::memcpy(Slots(), items.data() + first,
+                (items.size() - first) * sizeof(T));
+
+    // plain stores on x86, and the consumer needs nothing but them
+    for (uint64_t sequence = start; sequence < end; ++sequence) {
+      m_stamps_[sequence & kMask].store(sequence + 1,
+                                        std::memory_order_release);
+    }
+    return start;
+  }
+
+  // consumer side, the oldest contiguous run of finished items, it stops
+  // at the end of the storage and at the first unfinished claim
+  std::span<const T> Front() noexcept {
+    const uint64_t tail = m_tail_.load(std::memory_order_relaxed);
+    const uint64_t index = tail & kMask;
+    const uint64_t limit = Capacity - index;
+
+    uint64_t count = 0;
+    while (count < limit and
+           m_stamps_[index + count].load(std::memory_order_acquire) ==
+               tail + count + 1) {
+      ++count;
+    }
+    return {Slots() + index, count};
+  }
+
+  // consumer side, releases the first count items returned by Front
+  void Pop(uint64_t count) noexcept {
+    m_tail_.store(m_tail_.load(std::memory_order_relaxed) + count,
+                  std::memory_order_release);
+  }
+
+  // claimed, whether or not their producers have finished
+  uint64_t Claimed() const noexcept {
+    return m_head_.load(std::memory_order_acquire);
+  }
+
+  uint64_t Size() const noexcept {
+    return m_head_.load(std::memory_order_acquire) -
+           m_tail_.load(std::memory_order_acquire);
+  }
+
+ private:
+  T* Slots() noexcept { return reinterpret_cast<T*>(m_storage_); }
+
+ private:
+  alignas(kCacheLineSize) std::atomic<uint64_t> m_head_{0};
+  alignas(kCacheLineSize) std::atomic<uint64_t> m_tail_{0};
+  // sequence number plus one of the item a slot holds
+  alignas(kCacheLineSize) std::unique_ptr<std::atomic<uint64_t>[]> m_stamps_;
+  alignas(kCacheLineSize) std::byte m_storage_[Capacity * sizeof(T)];
+};
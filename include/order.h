@@ -33,3 +33,9 @@ class SellOrder : public Order {
   SellOrder(ID_t id, Price_t price, Quantity_t quantity)
       : Order(kSell, id, price, quantity) {}
 } __attribute__((packed, aligned(1)));
+
+// removes the resting order with this id and price from either side
+class CancelOrder : public Order {
+ public:
+  CancelOrder(ID_t id, Price_t price) : Order(kCancel, id, price, 0) {}
+} __attribute__((packed, aligned(1)));
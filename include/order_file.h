@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "order.h"
+
+/**
+ * binary order file
+ *
+ * | OrderFileHeader | Order * Count |
+ *
+ * records use the Order wire layout, so the payload of a mapped file can be
+ * sent to the matching engine as is
+ */
+struct OrderFileHeader {
+  char Magic[8];
+  uint32_t Version;
+  uint32_t RecordSize;
+  uint64_t Count;
+  uint8_t Reserved[8];
+} __attribute__((packed, aligned(1)));
+
+constexpr char kOrderFileMagic[8] = {'P', 'T', 'M', 'E', 'O', 'R', 'D', '\0'};
+constexpr uint32_t kOrderFileVersion = 1;
+
+bool IsOrderFile(std::span<const uint8_t> file);
+
+// validates the header and returns the records, throws if malformed
+std::span<const uint8_t> OrderFileRecords(std::span<const uint8_t> file);
+
+class OrderFileWriter {
+ public:
+  explicit OrderFileWriter(std::string_view path);
+  ~OrderFileWriter();
+
+  OrderFileWriter(const OrderFileWriter&) = delete;
+  OrderFileWriter& operator=(const OrderFileWriter&) = delete;
+
+  void Write(const Order& order) {
+    if (m_buffer_.size() + sizeof(Order) > kBufferSize) [[unlikely]] {
+      Flush();
+    }
+
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(&order);
+    m_buffer_.insert(std::end(m_buffer_), data, data + sizeof(Order));
+    ++m_count_;
+  }
+
+  // flushes the records and writes the final header, throws a
+  // FileWriteError if either write fails, also tried on destruction, where
+  // a failure is ignored
+  void Close();
+
+  uint64_t Count() const { return m_count_; }
+
+ private:
+  void Flush();
+  void WriteAt(std::span<const uint8_t> buffer, uint64_t offset);
+
+ private:
+  static constexpr uint32_t kBufferSize = 1 << 20;
+
+  int m_fd_;
+  std::vector<uint8_t> m_buffer_;
+  uint64_t m_offset_{sizeof(OrderFileHeader)};
+  uint64_t m_count_{0};
+};
@@ -5,16 +5,28 @@
 #include <cstdint>
 #include <span>
 #include "engine_interface.h"
+#include "instrumentation_interface.h"
 #include "observer_interface.h"
+#include "report_interface.h"
 #include "trade_result.h"
 
-template <Engine_t Engine, Observer_t Observer>
+template <Engine_t Engine,
+          Observer_t Observer,
+          Instrumentation_t Instrumentation = NoInstrumentation,
+          Reports_t Reports = NoReports>
 class OrderHandler {
  public:
-  OrderHandler(Engine& engine, Observer& observer)
-      : m_engine_{engine}, m_observer_{observer} {}
+  OrderHandler(Engine& engine,
+               Observer& observer,
+               Instrumentation instrumentation = {},
+               Reports reports = {})
+      : m_engine_{engine},
+        m_observer_{observer},
+        m_instrumentation_{instrumentation},
+        m_reports_{reports} {}
 
-  void operator()(std::span<const uint8_t> buffer) {
+  // session is where the batch came from, for the execution reports
+  void operator()(std::span<const uint8_t> buffer, uint64_t session = 0) {
     assert(buffer.size() >= sizeof(Order));
     assert(buffer.size() % sizeof(Order) == 0);
 
@@ -23,33 +35,93 @@ class OrderHandler {
       const Order* order;
       const BuyOrder* buy_order;
       const SellOrder* sell_order;
+      const CancelOrder* cancel_order;
     } msg;
 
     msg.raw = buffer.data();
     int msg_count = buffer.size() / sizeof(Order);
 
+    m_instrumentation_.Poll();
+    const uint64_t batch_start = m_instrumentation_.Now();
+
     for (int i = 0; i < msg_count; ++i) {
+      const uint64_t start = m_instrumentation_.Now();
+
       switch (msg.order[i].OrderType()) {
         case kBuy:
+          if (msg.order[i].Quantity() == 0) [[unlikely]] {
+            m_reports_.Rejected(session, msg.order[i]);
+            continue;
+          }
           m_engine_.AddOrder(msg.buy_order[i]);
           break;
         case kSell:
+          if (msg.order[i].Quantity() == 0) [[unlikely]] {
+            m_reports_.Rejected(session, msg.order[i]);
+            continue;
+          }
           m_engine_.AddOrder(msg.sell_order[i]);
           break;
+        case kCancel: {
+          // someone else's order stays on the book and with its owner
+          if (!m_reports_.MayCancel(session, msg.order[i])) [[unlikely]] {
+            m_reports_.Rejected(session, msg.order[i]);
+            continue;
+          }
+
+          // taking an order off the book never crosses it
+          const Quantity_t cancelled = m_engine_.Cancel(msg.cancel_order[i]);
+          m_instrumentation_.Record(Stage::kCancel, msg.order[i].Id(), start,
+                                    m_instrumentation_.Now());
+          m_reports_.Cancelled(session, msg.order[i], cancelled);
+          continue;
+        }
         [[unlikely]] default:
-          break;
+          m_reports_.Rejected(session, msg.order[i]);
+          continue;
       }
+
+      const uint64_t added = m_instrumentation_.Now();
+      m_instrumentation_.Record(Stage::kAddOrder, msg.order[i].Id(), start,
+                                added);
+
+      m_reports_.Accepted(session, msg.order[i]);
+
       const std::vector<TradeResult> trade_results = m_engine_.Execute();
 
+      const uint64_t executed = m_instrumentation_.Now();
+      m_instrumentation_.Record(Stage::kExecute, msg.order[i].Id(), added,
+                                executed);
+
+      for (const TradeResult& trade_result : trade_results) {
+        m_reports_.Filled(trade_result);
+      }
+
       if (!trade_results.empty()) {
         // keep trying until succeed
         while (!m_observer_.Send(trade_results)) {
         }
+        m_instrumentation_.Record(Stage::kPublish, msg.order[i].Id(),
+                                  executed, m_instrumentation_.Now());
       }
     }
+
+    m_instrumentation_.Record(Stage::kBatch, 0, batch_start,
+                              m_instrumentation_.Now());
+  }
+
+  // hands the reports gathered since the last flush to the transport
+  template <class Transport>
+    requires requires(Reports reports, Transport& transport) {
+      reports.Flush(transport);
+    }
+  void Flush(Transport& transport) {
+    m_reports_.Flush(transport);
   }
 
  private:
   Engine& m_engine_;
   Observer& m_observer_;
+  [[no_unique_address]] Instrumentation m_instrumentation_;
+  [[no_unique_address]] Reports m_reports_;
 };
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include "order.h"
+#include "spsc_ring.h"
+
+/**
+ * staged alternative to matching inside the server's receive callback
+ *
+ * - network thread: Publish validates the received orders and sequences
+ *   them into a preallocated ring, an order's sequence number is its
+ *   position in the ring
+ * - matching thread: Run hands the sequenced orders to the handler in
+ *   place, it never makes a system call, so with a TradeObserver as the
+ *   handler's observer its core only does book work
+ * - publisher thread: TradeObserver::Run sends the fills from its own ring
+ */
+class OrderPipeline {
+ public:
+  using OrderQueue = SpscRing<Order, 1 << 16>;
+
+  OrderPipeline();
+
+  OrderPipeline(const OrderPipeline&) = delete;
+  OrderPipeline& operator=(const OrderPipeline&) = delete;
+
+  // network thread, buffer holds whole orders, invalid ones are dropped and
+  // counted, waits while the matching thread is a full ring behind
+  void Publish(std::span<const uint8_t> buffer) noexcept;
+
+  // matching thread, hands the oldest contiguous run of sequenced orders to
+  // the handler, false if none were pending
+  template <class Handler>
+  bool RunOnce(Handler& handler) {
+    const std::span<const Order> pending = m_queue_->Front();
+
+    if (pending.empty()) {
+      return false;
+    }
+
+    union {
+      const Order* order;
+      const uint8_t* raw;
+    } msg;
+
+    msg.order = pending.data();
+    handler({msg.raw, pending.size_bytes()});
+
+    m_queue_->Pop(pending.size());
+    return true;
+  }
+
+  template <class Handler>
+  [[noreturn]] void Run(Handler& handler) {
+    while (1) {
+      RunOnce(handler);
+    }
+  }
+
+  // network thread only
+  uint64_t Sequenced() const { return m_sequenced_; }
+  uint64_t Rejected() const { return m_rejected_; }
+
+ private:
+  static bool Valid(const Order& order) noexcept;
+  void Sequence(std::span<const Order> orders) noexcept;
+
+ private:
+  std::unique_ptr<OrderQueue> m_queue_;
+
+  uint64_t m_sequenced_{0};
+  uint64_t m_rejected_{0};
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include "mpsc_ring.h"
+#include "order.h"
+
+/**
+ * OrderPipeline's stage for several gateway threads feeding one matching
+ * thread
+ *
+ * - gateway threads: Publish claims ring slots for a batch with a single
+ *   fetch-add and copies it in, the claim order is the order the book
+ *   sees, so matching stays deterministic for a given sequence however the
+ *   gateways interleave, each session's orders keep their own order as one
+ *   gateway thread serves the session
+ * - matching thread: Run hands the sequenced orders to the handler in place
+ *
+ * orders are not validated here, the order handler rejects what the book
+ * cannot take
+ */
+class OrderSequencer {
+ public:
+  using OrderQueue = MpscRing<Order, 1 << 16>;
+
+  OrderSequencer();
+
+  OrderSequencer(const OrderSequencer&) = delete;
+  OrderSequencer& operator=(const OrderSequencer&) = delete;
+
+  // any gateway thread, buffer holds whole orders, waits while the matching
+  // thread is a full ring behind
+  void Publish(std::span<const uint8_t> buffer) noexcept;
+
+  // matching thread, hands the oldest contiguous run of sequenced orders to
+  // the handler, false if none were ready
+  template <class Handler>
+  bool RunOnce(Handler& handler) {
+    const std::span<const Order> pending = m_queue_->Front();
+
+    if (pending.empty()) {
+      return false;
+    }
+
+    union {
+      const Order* order;
+      const uint8_t* raw;
+    } msg;
+
+    msg.order = pending.data();
+    handler({msg.raw, pending.size_bytes()});
+
+    m_queue_->Pop(pending.size());
+    return true;
+  }
+
+  template <class Handler>
+  [[noreturn]] void Run(Handler& handler) {
+    while (1) {
+      RunOnce(handler);
+    }
+  }
+
+  // any thread
+  uint64_t Sequenced() const { return m_queue_->Claimed(); }
+
+ private:
+  // a claim blocks every later one until it is copied in, so large buffers
+  // go in parts and the other gateways are not held up behind them
+  static constexpr uint64_t kMaxClaim = OrderQueue::kCapacity / 16;
+
+ private:
+  std::unique_ptr<OrderQueue> m_queue_;
+};
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "linux/tcp.h"
+#include "order.h"
+#include "trade_result.h"
+
+/**
+ * Hot standby replication over a local tcp link.
+ *
+ * The primary forwards every inbound order batch, in the order it is applied,
+ * and every kCheckpointInterval orders a checkpoint carrying the number of
+ * orders applied so far and the engine StateHash. The follower applies the
+ * same batches to its own engine, compares hashes at each checkpoint and
+ * echoes its own hash back so both sides notice a divergence.
+ */
+namespace replication {
+
+constexpr uint8_t kOrders = 0;
+constexpr uint8_t kCheckpoint = 1;
+
+constexpr uint64_t kCheckpointInterval = 1 << 12;
+
+struct MessageHeader {
+  uint8_t Type;
+  uint32_t Length;  // payload bytes following the header
+} __attribute__((packed, aligned(1)));
+
+struct Checkpoint {
+  uint64_t Sequence;  // orders applied when the hash was taken
+  uint64_t StateHash;
+} __attribute__((packed, aligned(1)));
+
+}  // namespace replication
+
+// trades are dropped while standing by, the primary publishes them
+class StandbyObserver {
+ public:
+  bool Send(std::span<const TradeResult>) noexcept { return true; }
+};
+
+class ReplicationPublisher {
+ public:
+  // blocks until the follower is connected
+  ReplicationPublisher(std::string_view host, uint16_t port);
+  ReplicationPublisher(const ReplicationPublisher&) = delete;
+  ReplicationPublisher& operator=(const ReplicationPublisher&) = delete;
+
+  // forwards a batch before it is applied locally
+  void Publish(std::span<const uint8_t> orders) noexcept;
+  // called after the batch is applied, emits a checkpoint once per interval
+  void Checkpoint(uint64_t state_hash) noexcept;
+
+ private:
+  void Send(uint8_t type, std::span<const uint8_t> payload) noexcept;
+  void VerifyEchoes() noexcept;
+  void Disconnect() noexcept;
+
+ private:
+  static constexpr uint32_t kHistorySize = 64;
+
+  TcpSocket m_listen_sock_;
+  TcpSocket m_follower_sock_{-1};
+  bool m_connected_{false};
+
+  uint64_t m_sequence_{0};
+  uint64_t m_next_checkpoint_{replication::kCheckpointInterval};
+
+  // recent checkpoints, matched against the follower's echoes
+  std::array<replication::Checkpoint, kHistorySize> m_history_{};
+  uint32_t m_history_count_{0};
+
+  std::vector<uint8_t> m_send_buffer_;
+  std::array<uint8_t, sizeof(replication::Checkpoint) * kHistorySize>
+      m_echo_buffer_;
+  uint32_t m_echo_offset_{0};
+};
+
+class ReplicationFollower {
+ public:
+  ReplicationFollower(std::string_view host, uint16_t port);
+  ReplicationFollower(const ReplicationFollower&) = delete;
+  ReplicationFollower& operator=(const ReplicationFollower&) = delete;
+
+  /**
+   * applies the primary's stream until the primary goes away, returning so
+   * the caller can take over
+   * on_orders(std::span<const uint8_t>) applies a batch
+   * state_hash() returns the local engine StateHash
+   */
+  void Run(auto&& on_orders, auto&& state_hash);
+
+  uint64_t Sequence() const { return m_sequence_; }
+  uint64_t Divergences() const { return m_divergences_; }
+
+ private:
+  void Verify(const replication::Checkpoint& checkpoint, uint64_t state_hash);
+
+ private:
+  TcpSocket m_primary_sock_;
+
+  uint64_t m_sequence_{0};
+  uint64_t m_divergences_{0};
+};
+
+void ReplicationFollower::Run(auto&& on_orders, auto&& state_hash) {
+  constexpr uint32_t kBufLen = 1 << 16;
+  std::vector<uint8_t> buffer(kBufLen);
+  uint32_t offset = 0;
+
+  while (1) {
+    const int byte_recv = m_primary_sock_.Recv(
+        {buffer.data() + offset, static_cast<uint64_t>(kBufLen - offset)});
+
+    if (byte_recv <= 0) {
+      return;
+    }
+
+    const uint32_t len = offset + byte_recv;
+    uint32_t pos = 0;
+
+    while (len - pos >= sizeof(replication::MessageHeader)) {
+      replication::MessageHeader header;
+      std::memcpy(&header, buffer.data() + pos, sizeof(header));
+
+      const uint8_t* payload = buffer.data() + pos + sizeof(header);
+      const uint32_t available = len - pos - sizeof(header);
+
+      if (header.Type == replication::kOrders) {
+        // whole orders are applied as they arrive, the rest waits
+        const uint32_t usable =
+            std::min(header.Length, available) / sizeof(Order) * sizeof(Order);
+
+        if (usable == 0) {
+          break;
+        }
+
+        on_orders(std::span<const uint8_t>{payload, usable});
+        m_sequence_ += usable / sizeof(Order);
+
+        if (usable == header.Length) {
+          pos += sizeof(header) + usable;
+          continue;
+        }
+
+        // rewrite the header in front of the remaining orders
+        pos += usable;
+        header.Length -= usable;
+        std::memcpy(buffer.data() + pos, &header, sizeof(header));
+        break;
+      }
+
+      if (available < header.Length) {
+        break;
+      }
+
+      replication::Checkpoint checkpoint;
+      std::memcpy(&checkpoint, payload, sizeof(checkpoint));
+      Verify(checkpoint, state_hash());
+
+      pos += sizeof(header) + header.Length;
+    }
+
+    offset = len - pos;
+    std::memmove(buffer.data(), buffer.data() + pos, offset);
+  }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include "order.h"
+#include "trade_result.h"
+
+/**
+ * what the order handler tells the originating session about its orders,
+ * session identifies the connection a batch came in on
+ */
+template <class T>
+concept Reports_t = requires(T reports,
+                             uint64_t session,
+                             const Order& order,
+                             Quantity_t quantity,
+                             const TradeResult& trade_result) {
+  { reports.Accepted(session, order) };
+  { reports.Rejected(session, order) };
+  // asked before a cancel reaches the engine, false turns it down
+  { reports.MayCancel(session, order) } -> std::same_as<bool>;
+  // quantity is what the engine took off the book, 0 if nothing was found
+  { reports.Cancelled(session, order, quantity) };
+  { reports.Filled(trade_result) };
+};
+
+// the default, every call is empty and compiles away
+struct NoReports {
+  void Accepted(uint64_t, const Order&) noexcept {}
+  void Rejected(uint64_t, const Order&) noexcept {}
+  bool MayCancel(uint64_t, const Order&) noexcept { return true; }
+  void Cancelled(uint64_t, const Order&, Quantity_t) noexcept {}
+  void Filled(const TradeResult&) noexcept {}
+};
@@ -4,21 +4,66 @@
 #include <functional>
 #include <span>
 #include <string>
-#include <vector>
-#include "linux/tcp.h"
-#include "order.h"
+#include <utility>
+#include "tcp_transport.h"
+#include "transport_interface.h"
 
-class Server {
+/**
+ * order gateway feeding one handler from one transport on the calling
+ * thread, both are template parameters, so the handler is inlined into the
+ * transport's receive loop and the same matching code runs against
+ * sockets, shared memory rings or recorded files without virtual dispatch
+ */
+template <Transport_t Transport, class Handler>
+class BasicServer {
  public:
-  using RecvCallBack = std::function<void(std::span<const uint8_t>)>;
+  template <class... TransportArgs>
+  explicit BasicServer(Handler handler, TransportArgs&&... transport_args)
+      : m_handler_{std::move(handler)},
+        m_transport_(std::forward<TransportArgs>(transport_args)...) {}
 
- public:
-  Server(std::string host, uint16_t port, RecvCallBack recv_callback);
+  // this is blocking run, returns once the transport is exhausted
+  void Run() {
+    while (!m_transport_.Exhausted()) {
+      Poll(-1);
+    }
+  }
+
+  // hands whatever arrives within timeout_ms (-1 for ever) to the handler,
+  // false if there was nothing, a handler with replies to send flushes them
+  // through the transport afterwards
+  bool Poll(int timeout_ms = 0) {
+    const bool received = m_transport_.Poll(m_handler_, timeout_ms);
 
-  void Run();  // this is blocking run
+    if constexpr (requires { m_handler_.Flush(m_transport_); }) {
+      m_handler_.Flush(m_transport_);
+    }
+    return received;
+  }
+
+  Transport& GetTransport() { return m_transport_; }
+  const Transport& GetTransport() const { return m_transport_; }
 
  private:
-  RecvCallBack m_recv_callback_;
+  Handler m_handler_;
+  Transport m_transport_;
+};
+
+/**
+ * the tcp gateway with its handler picked at run time, for callers which
+ * mix handlers or hand them on to another server
+ */
+class Server : public BasicServer<
+                   TcpTransport,
+                   std::function<void(std::span<const uint8_t>)>> {
+ public:
+  using RecvCallBack = std::function<void(std::span<const uint8_t>)>;
+
+  static constexpr uint32_t kMaxSessions = TcpTransport::kMaxSessions;
+
+ public:
+  Server(std::string host, uint16_t port, RecvCallBack recv_callback)
+      : BasicServer{std::move(recv_callback), std::move(host), port} {}
 
-  TcpSocket m_server_fd_;
+  uint32_t SessionCount() const { return GetTransport().SessionCount(); }
 };
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include "engine_interface.h"
+#include "linux/shared_memory.h"
+#include "trade_observer.h"
+
+/**
+ * Engine and its outbound trade queue living in a named shared mapping, so a
+ * restarted (or upgraded) process reattaches to the book instead of replaying.
+ *
+ * layout: | Header | Engine | TradeQueue |
+ *
+ * Header::Epoch is odd while a batch is being applied, a process dying in the
+ * middle of a batch leaves it odd and the book is rejected as torn.
+ */
+template <Engine_t Engine>
+class SharedBook {
+ private:
+  struct Header {
+    std::atomic<uint64_t> Magic{0};
+    uint32_t Version{0};
+    uint32_t EngineSize{0};
+    uint32_t QueueSize{0};
+    std::atomic<uint64_t> Epoch{0};
+  };
+
+  static constexpr uint64_t kMagic = 0x4b4f4f42454d5450;  // "PTMEBOOK"
+  // bump whenever the engine or queue memory layout changes
+  static constexpr uint32_t kVersion = 3;
+
+  static constexpr uint64_t kHugePageSize = 2 * 1024 * 1024;
+  static constexpr uint64_t kCacheLineSize = 64;
+
+  static constexpr uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+
+  static constexpr uint64_t kEngineOffset =
+      AlignUp(sizeof(Header), kCacheLineSize);
+  static constexpr uint64_t kQueueOffset =
+      AlignUp(kEngineOffset + sizeof(Engine), kCacheLineSize);
+  // rounded to the huge page size so the file may live on hugetlbfs
+  static constexpr uint64_t kMappingSize =
+      AlignUp(kQueueOffset + sizeof(TradeQueue), kHugePageSize);
+
+ public:
+  explicit SharedBook(std::string_view path) : m_memory_{path, kMappingSize} {
+    uint8_t* base = reinterpret_cast<uint8_t*>(m_memory_.Address());
+
+    m_header_ = std::launder(reinterpret_cast<Header*>(base));
+    m_engine_ = std::launder(reinterpret_cast<Engine*>(base + kEngineOffset));
+    m_queue_ =
+        std::launder(reinterpret_cast<TradeQueue*>(base + kQueueOffset));
+
+    // a zero magic is a fresh file or an initialization which never finished
+    if (m_memory_.Created() or
+        m_header_->Magic.load(std::memory_order_acquire) == 0) {
+      Initialize(base);
+      return;
+    }
+
+    if (m_header_->Magic.load(std::memory_order_acquire) != kMagic or
+        m_header_->Version != kVersion or
+        m_header_->EngineSize != sizeof(Engine) or
+        m_header_->QueueSize != sizeof(TradeQueue)) {
+      throw std::runtime_error("shared book layout mismatch");
+    }
+
+    if (Updating()) {
+      throw std::runtime_error("shared book is torn");
+    }
+
+    m_engine_->Reattach();
+    m_reattached_ = true;
+  }
+
+  SharedBook(const SharedBook&) = delete;
+  SharedBook& operator=(const SharedBook&) = delete;
+
+  Engine& GetEngine() { return *m_engine_; }
+  TradeQueue& Queue() { return *m_queue_; }
+
+  // true if the book was left behind by a previous process
+  bool Reattached() const { return m_reattached_; }
+
+  bool Updating() const {
+    return m_header_->Epoch.load(std::memory_order_acquire) % 2 == 1;
+  }
+
+  // single writer, so plain stores suffice, the signal fences only keep the
+  // compiler from moving book writes outside of the marked section
+  void BeginUpdate() noexcept {
+    m_header_->Epoch.store(m_header_->Epoch.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+  }
+
+  void EndUpdate() noexcept {
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    m_header_->Epoch.store(m_header_->Epoch.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_release);
+  }
+
+ private:
+  void Initialize(uint8_t* base) {
+    m_header_ = new (base) Header();
+    m_engine_ = new (base + kEngineOffset) Engine();
+    m_queue_ = new (base + kQueueOffset) TradeQueue();
+
+    m_header_->Version = kVersion;
+    m_header_->EngineSize = sizeof(Engine);
+    m_header_->QueueSize = sizeof(TradeQueue);
+
+    // published last, so a crash during initialization is simply redone
+    m_header_->Magic.store(kMagic, std::memory_order_release);
+  }
+
+ private:
+  SharedMemory m_memory_;
+
+  Header* m_header_;
+  Engine* m_engine_;
+  TradeQueue* m_queue_;
+
+  bool m_reattached_{false};
+};
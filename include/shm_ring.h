@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include "linux/shared_memory.h"
+#include "spsc_ring.h"
+
+/**
+ * SpscRing in a named shared mapping, e.g. under /dev/shm, connecting a
+ * producer and a consumer process on the same host
+ *
+ * whichever side maps the file first lays out the ring, the other one
+ * attaches, items left unread by a previous run are still delivered, remove
+ * the file to start over
+ */
+template <class T, uint64_t Capacity>
+class ShmRing {
+ public:
+  using Ring = SpscRing<T, Capacity>;
+
+  explicit ShmRing(std::string_view path) : m_memory_{path, sizeof(Layout)} {
+    m_layout_ = std::launder(reinterpret_cast<Layout*>(m_memory_.Address()));
+
+    if (m_memory_.Created() or
+        m_layout_->Magic.load(std::memory_order_acquire) == 0) {
+      m_layout_ = new (m_memory_.Address()) Layout();
+      m_layout_->Version = kVersion;
+      m_layout_->ItemSize = sizeof(T);
+      m_layout_->ItemCapacity = Capacity;
+      m_layout_->Magic.store(kMagic, std::memory_order_release);
+      return;
+    }
+
+    if (m_layout_->Magic.load(std::memory_order_acquire) != kMagic or
+        m_layout_->Version != kVersion or m_layout_->ItemSize != sizeof(T) or
+        m_layout_->ItemCapacity != Capacity) {
+      throw std::runtime_error("shared memory ring layout mismatch");
+    }
+  }
+
+  ShmRing(const ShmRing&) = delete;
+  ShmRing& operator=(const ShmRing&) = delete;
+
+  Ring& GetRing() { return m_layout_->Items; }
+
+ private:
+  static constexpr uint64_t kMagic = 0x474e4952454d5450;  // "PTMERING"
+  static constexpr uint32_t kVersion = 1;
+
+  struct Layout {
+    std::atomic<uint64_t> Magic{0};
+    uint32_t Version{0};
+    uint32_t ItemSize{0};
+    uint64_t ItemCapacity{0};
+    Ring Items;
+  };
+
+ private:
+  SharedMemory m_memory_;
+  Layout* m_layout_;
+};
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string_view>
+#include <utility>
+#include "server.h"
+#include "shm_transport.h"
+
+// the shared memory gateway with its handler picked at run time
+class ShmServer : public BasicServer<ShmTransport, Server::RecvCallBack> {
+ public:
+  using RecvCallBack = Server::RecvCallBack;
+
+  ShmServer(std::string_view path,
+            RecvCallBack recv_callback,
+            bool adaptive_wait = false)
+      : BasicServer{std::move(recv_callback), path, adaptive_wait} {}
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include "idle_wait.h"
+#include "order.h"
+#include "shm_ring.h"
+
+using ShmOrderRing = ShmRing<Order, 1 << 16>;
+
+/**
+ * order input from a co-located client through a ring in shared memory,
+ * the orders are handed over in place
+ *
+ * one producer per ring, the client pushes whole orders so there is
+ * nothing to reassemble, an empty poll which may wait idles once
+ */
+class ShmTransport {
+ public:
+  explicit ShmTransport(std::string_view path, bool adaptive_wait = false);
+
+  template <class Handler>
+  bool Poll(Handler& handler, int timeout_ms) {
+    auto& ring = m_ring_.GetRing();
+    bool received = false;
+
+    // a second run when the pending orders wrap around the storage
+    for (auto pending = ring.Front(); !pending.empty();
+         pending = ring.Front()) {
+      union {
+        const Order* order;
+        const uint8_t* raw;
+      } msg;
+
+      msg.order = pending.data();
+      handler(std::span<const uint8_t>{msg.raw, pending.size_bytes()});
+
+      ring.Pop(pending.size());
+      received = true;
+    }
+
+    if (received) {
+      m_idle_wait_.Reset();
+    } else if (timeout_ms != 0) {
+      m_idle_wait_.Idle();
+    }
+    return received;
+  }
+
+  static constexpr bool Exhausted() { return false; }
+
+ private:
+  ShmOrderRing m_ring_;
+  IdleWait m_idle_wait_;
+};
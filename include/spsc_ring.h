@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+/**
+ * bounded single producer single consumer ring of trivially copyable items
+ *
+ * the producer copies a whole batch in and publishes it with one release
+ * store of its head, the consumer reads the items in place and hands the
+ * slots back with one release store of its tail, neither side ever waits on
+ * the other
+ *
+ * each index sits on its own cache line next to the owner's cached copy of
+ * the other index, so the lines only bounce when a side runs out of items or
+ * room, indices only grow and are masked on access
+ *
+ * plain storage, it may be placed in a shared mapping and reattached to,
+ * the items are copied into raw bytes so they need no default constructor
+ */
+template <class T, uint64_t Capacity>
+class SpscRing {
+  static_assert(std::has_single_bit(Capacity));
+  static_assert(std::is_trivially_copyable_v<T>);
+
+  static constexpr uint64_t kCacheLineSize = 64;
+  static constexpr uint64_t kMask = Capacity - 1;
+
+ public:
+  static constexpr uint64_t kCapacity = Capacity;
+
+  // producer side, false without a partial write if the batch does not fit
+  bool TryPush(std::span<const T> items) noexcept {
+    const uint64_t head = m_producer_.Head.load(std::memory_order_relaxed);
+
+    if (head + items.size() - m_producer_.CachedTail > Capacity) {
+      m_producer_.CachedTail =
+          m_consumer_.Tail.load(std::memory_order_acquire);
+
+      if (head + items.size() - m_producer_.CachedTail > Capacity)
+          [[unlikely]] {
+        return false;
+      }
+    }
+
+    const uint64_t index = head & kMask;
+    const uint64_t first = std::min<uint64_t>(items.size(), Capacity - index);
+
+    std::memcpy(Slots() + index, items.data(), first * sizeof(T));
+    std::memcpy(Slots(), items.data() + first,
+                (items.size() - first) * sizeof(T));
+
+    m_producer_.Head.store(head + items.size(), std::memory_order_release);
+    return true;
+  }
+
+  // consumer side, the oldest contiguous run of published items, it stops
+  // at the end of the storage so a wrapped batch takes two calls
+  std::span<const T> Front() noexcept {
+    const uint64_t tail = m_consumer_.Tail.load(std::memory_order_relaxed);
+
+    if (tail == m_consumer_.CachedHead) {
+      m_consumer_.CachedHead =
+          m_producer_.Head.load(std::memory_order_acquire);
+    }
+
+    const uint64_t index = tail & kMask;
+    return {Slots() + index,
+            std::min(m_consumer_.CachedHead - tail, Capacity - index)};
+  }
+
+  // consumer side, releases the first count items returned by Front
+  void Pop(uint64_t count) noexcept {
+    m_consumer_.Tail.store(
+        m_consumer_.Tail.load(std::memory_order_relaxed) + count,
+        std::memory_order_release);
+  }
+
+  // the slots as raw memory, e.g. to register them with the kernel once
+  std::span<const std::byte> Storage() const noexcept { return m_storage_; }
+
+  uint64_t Size() const noexcept {
+    return m_producer_.Head.load(std::memory_order_acquire) -
+           m_consumer_.Tail.load(std::memory_order_acquire);
+  }
+
+ private:
+  T* Slots() noexcept { return reinterpret_cast<T*>(m_storage_); }
+
+ private:
+  struct alignas(kCacheLineSize) Producer {
+    std::atomic<uint64_t> Head{0};
+    uint64_t CachedTail{0};
+  };
+
+  struct alignas(kCacheLineSize) Consumer {
+    std::atomic<uint64_t> Tail{0};
+    uint64_t CachedHead{0};
+  };
+
+  Producer m_producer_;
+  Consumer m_consumer_;
+  alignas(kCacheLineSize) std::byte m_storage_[Capacity * sizeof(T)];
+};
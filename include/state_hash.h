@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include "define.h"
+
+/**
+ * Zobrist style book hash: the hash of a book is the XOR of the hashes of its
+ * resting orders, so an insert or a fill updates it in O(1) and two books
+ * holding the same orders hash equal regardless of how they got there.
+ *
+ * splitmix64 stands in for the usual random table, the keys (64 bit ids and
+ * 16 bit prices) are too wide to tabulate.
+ */
+constexpr uint64_t Mix(uint64_t value) noexcept {
+  value += 0x9e3779b97f4a7c15;
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+  return value ^ (value >> 31);
+}
+
+constexpr uint64_t OrderHash(OrderType_t order_type,
+                             ID_t id,
+                             Price_t price,
+                             Quantity_t quantity) noexcept {
+  const uint64_t attributes = (uint64_t{order_type} << 32) |
+                              (uint64_t{price} << 16) | uint64_t{quantity};
+  return Mix(Mix(id) ^ attributes);
+}
+
+// hash change of a resting order filled by `fill`, the order leaves the book
+// once nothing is left
+constexpr uint64_t FillHash(OrderType_t order_type,
+                            ID_t id,
+                            Price_t price,
+                            Quantity_t quantity,
+                            Quantity_t fill) noexcept {
+  const Quantity_t left = quantity - fill;
+  return OrderHash(order_type, id, price, quantity) ^
+         (left > 0 ? OrderHash(order_type, id, price, left) : 0);
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "linux/epoll.h"
+#include "linux/mirrored_buffer.h"
+#include "linux/tcp.h"
+
+// what every tcp session keeps, a transport extends it with its own state
+struct TcpSession {
+  // per session, virtual memory is reserved up front, pages on first use
+  static constexpr uint64_t kRingLen{1 << 18};
+
+  TcpSocket Sock{-1};
+  bool Open{false};
+  bool Ready{false};
+  // bumped on every accept into this slot
+  uint32_t Generation{0};
+  // running byte counts, their difference is what is buffered
+  uint64_t Received{0};
+  uint64_t Delivered{0};
+  MirroredBuffer Ring{kRingLen};
+};
+
+/**
+ * the listener, sessions and ready queue the tcp transports share, up to
+ * kMaxSessions sessions on one epoll on one thread
+ *
+ * sessions with pending data are queued once each, oldest first, and read
+ * one buffer at a time in round robin so a busy client cannot starve the
+ * others, what a transport makes of the bytes is up to it
+ *
+ * each session receives into a mirrored ring, bytes straddling the end of
+ * the ring read back contiguous, so a partial message simply stays where
+ * it is until the rest arrives
+ *
+ * a session's key is its slot with the slot's generation above it, so it
+ * stays unique when a later connection reuses the slot, Session derives
+ * from TcpSession and its Reset, if it has one, runs on every accept
+ */
+template <class Session>
+class TcpSessions {
+ public:
+  static constexpr uint32_t kMaxSessions = 64;
+  static constexpr uint64_t kRingLen = TcpSession::kRingLen;
+
+ public:
+  TcpSessions(std::string host, uint16_t port, bool shared_port = false)
+      : m_sessions_{std::make_unique<Session[]>(kMaxSessions)} {
+    SetSocketReusable(m_server_fd_);
+    if (shared_port) {
+      SetSocketSharedPort(m_server_fd_);
+    }
+    SetSocketNoDelay(m_server_fd_);
+    SetSocketNonBlocking(m_server_fd_);
+
+    m_server_fd_.Bind(host, port);
+    m_server_fd_.Listen(kMaxSessions);
+
+    m_epoll_.Add(m_server_fd_.Fd(), kListenerTag);
+  }
+
+  // waits for events, accepts new sessions and queues the ready ones
+  void Wait(int timeout_ms) {
+    std::array<epoll_event, kMaxSessions + 1> events;
+
+    // never block while a session still has something to read
+    const int event_count =
+        m_epoll_.Wait(events, m_ready_count_ > 0 ? 0 : timeout_ms);
+
+    for (int i = 0; i < event_count; ++i) {
+      if (events[i].data.u64 == kListenerTag) {
+        AcceptAll();
+      } else {
+        // hang ups too, the read then finds the end of the stream
+        MarkReady(events[i].data.u64);
+      }
+    }
+  }
+
+  uint32_t ReadyCount() const { return m_ready_count_; }
+
+  uint32_t PopReady() {
+    const uint32_t index = m_ready_[m_ready_head_];
+    m_ready_head_ = (m_ready_head_ + 1) % kMaxSessions;
+    --m_ready_count_;
+
+    m_sessions_[index].Ready = false;
+    return index;
+  }
+
+  void MarkReady(uint32_t index) {
+    Session& session = m_sessions_[index];
+
+    if (!session.Open or session.Ready) {
+      return;
+    }
+
+    session.Ready = true;
+    m_ready_[(m_ready_head_ + m_ready_count_) % kMaxSessions] = index;
+    ++m_ready_count_;
+  }
+
+  enum ReadStatus { kRead, kDrained, kEnded };
+
+  // one read into the session's ring, kEnded once the connection has ended
+  // or broken, or the ring is full, the caller closes the session then
+  ReadStatus ReadOnce(uint32_t index) {
+    Session& session = m_sessions_[index];
+
+    const uint64_t buffered = session.Received - session.Delivered;
+    uint8_t* tail = session.Ring.Data() + session.Received % kRingLen;
+
+    const int byte_recv = session.Sock.TryRecv({tail, kRingLen - buffered});
+
+    if (byte_recv < 0 and (errno == EAGAIN or errno == EWOULDBLOCK)) {
+      return kDrained;
+    }
+
+    if (byte_recv <= 0) [[unlikely]] {
+      return kEnded;
+    }
+
+    session.Received += byte_recv;
+    return kRead;
+  }
+
+  void Close(uint32_t index) {
+    Session& session = m_sessions_[index];
+
+    m_epoll_.Remove(session.Sock.Fd());
+    session.Sock.Close();
+
+    session.Open = false;
+    --m_session_count_;
+  }
+
+  Session& operator[](uint32_t index) { return m_sessions_[index]; }
+  const Session& operator[](uint32_t index) const {
+    return m_sessions_[index];
+  }
+
+  uint64_t Key(uint32_t index) const {
+    return uint64_t{m_sessions_[index].Generation} << 32 | index;
+  }
+
+  // the slot of the open session behind the key, -1 if it has gone
+  int64_t Find(uint64_t session) const {
+    const uint32_t index = session & UINT32_MAX;
+
+    if (index >= kMaxSessions or !m_sessions_[index].Open or
+        Key(index) != session) {
+      return -1;
+    }
+    return index;
+  }
+
+  uint32_t Count() const { return m_session_count_; }
+
+ private:
+  static constexpr uint64_t kListenerTag = UINT64_MAX;
+
+  void AcceptAll() {
+    // edge triggered, so the backlog is emptied in one go
+    while (auto conn = m_server_fd_.TryAccept()) {
+      uint32_t index = 0;
+      while (index < kMaxSessions and m_sessions_[index].Open) {
+        ++index;
+      }
+
+      if (index == kMaxSessions) [[unlikely]] {
+        std::cout << "session limit reached, rejecting connection" << '\n';
+        conn->Close();
+        continue;
+      }
+
+      Session& session = m_sessions_[index];
+      session.Sock = *conn;
+      session.Open = true;
+      ++session.Generation;
+      session.Received = 0;
+      session.Delivered = 0;
+      if constexpr (requires { session.Reset(); }) {
+        session.Reset();
+      }
+      ++m_session_count_;
+
+      // writable too, so replies left over from a full socket go out as
+      // soon as the client has read some
+      m_epoll_.Add(session.Sock.Fd(), index, true);
+      // data may have arrived before the registration
+      MarkReady(index);
+    }
+  }
+
+ private:
+  TcpSocket m_server_fd_;
+  Epoll m_epoll_;
+
+  std::unique_ptr<Session[]> m_sessions_;
+  uint32_t m_session_count_{0};
+
+  // sessions with data left to read, each at most once, oldest first
+  std::array<uint32_t, kMaxSessions> m_ready_;
+  uint32_t m_ready_head_{0};
+  uint32_t m_ready_count_{0};
+};
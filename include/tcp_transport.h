@@ -0,0 +1,95 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <span>
+#include <string>
+#include "order.h"
+#include "tcp_sessions.h"
+
+/**
+ * order entry sessions over tcp, up to kMaxSessions at once on one thread
+ *
+ * sessions are read in round robin by TcpSessions, every session
+ * reassembles its own partial orders and the handler only ever sees whole
+ * orders of one session at a time, which keeps a single sequenced feed
+ * into the engine, an order straddling the end of a session's ring reads
+ * back contiguous, so one read can hand over up to the whole ring in one
+ * call
+ *
+ * a handler taking a second argument is also told the session a batch
+ * came from, a key which stays unique when a later connection reuses the
+ * slot, Send then writes back to that session
+ *
+ * with shared_port several transports, e.g. one per gateway thread, listen
+ * on the same port and each serves the connections the kernel hands it
+ */
+class TcpTransport {
+ public:
+  static constexpr uint32_t kMaxSessions =
+      TcpSessions<TcpSession>::kMaxSessions;
+
+ public:
+  TcpTransport(std::string host, uint16_t port, bool shared_port = false);
+
+  // waits up to timeout_ms for activity (-1 for ever), then accepts new
+  // sessions and reads once from every session with pending data
+  template <class Handler>
+  bool Poll(Handler& handler, int timeout_ms) {
+    m_sessions_.Wait(timeout_ms);
+
+    bool received = false;
+
+    // one read per ready session, the ones not drained go to the back
+    for (uint32_t remaining = m_sessions_.ReadyCount(); remaining > 0;
+         --remaining) {
+      const uint32_t index = m_sessions_.PopReady();
+      TcpSession& session = m_sessions_[index];
+
+      // e.g. closed by a Send since it was queued
+      if (!session.Open or !ReadOnce(index)) {
+        continue;
+      }
+
+      const uint64_t pending = session.Received - session.Delivered;
+      const uint64_t whole = pending - pending % sizeof(Order);
+
+      if (whole > 0) [[likely]] {
+        // contiguous even across the wrap, the second mapping continues it
+        const std::span<const uint8_t> orders{
+            session.Ring.Data() + session.Delivered % kRingLen, whole};
+
+        if constexpr (std::invocable<Handler&, std::span<const uint8_t>,
+                                     uint64_t>) {
+          handler(orders, m_sessions_.Key(index));
+        } else {
+          handler(orders);
+        }
+        session.Delivered += whole;
+        received = true;
+      }
+
+      m_sessions_.MarkReady(index);
+    }
+    return received;
+  }
+
+  static constexpr bool Exhausted() { return false; }
+
+  uint32_t SessionCount() const { return m_sessions_.Count(); }
+
+  // non blocking, what the session's socket took, -1 once the session is
+  // gone, a session closed here is not handed to the handler again
+  int64_t Send(uint64_t session, std::span<const uint8_t> buffer);
+  // e.g. a client which does not read what is sent to it
+  void Disconnect(uint64_t session);
+
+ private:
+  static constexpr uint64_t kRingLen = TcpSession::kRingLen;
+
+  // one read from a ready session, false once it has nothing more pending
+  bool ReadOnce(uint32_t index);
+
+ private:
+  TcpSessions<TcpSession> m_sessions_;
+};
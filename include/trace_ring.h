@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "define.h"
+#include "instrumentation_interface.h"
+#include "tsc.h"
+
+struct TraceEvent {
+  ID_t OrderId;
+  uint64_t StartTsc;
+  uint32_t Ticks;
+  Stage EventStage;
+} __attribute__((packed, aligned(1)));
+
+constexpr uint8_t kTraceDumpRequested = 0;  // signal or RequestDump
+constexpr uint8_t kTraceDumpSpike = 1;      // a stage took too long
+constexpr uint8_t kTraceDumpExit = 2;       // the engine is shutting down
+
+/**
+ * trace dump file, appended to on every dump
+ *
+ * | TraceDumpHeader | TraceEvent * Count | TraceDumpHeader | ...
+ *
+ * events are oldest first, BaseTsc was read at BaseWallNs (system clock,
+ * nanoseconds since the epoch) so the decoder can put wall clock times on
+ * the tsc stamps
+ */
+struct TraceDumpHeader {
+  char Magic[8];
+  uint32_t Version;
+  uint8_t Reason;
+  uint8_t Reserved[3];
+  uint64_t Count;
+  uint64_t BaseTsc;
+  int64_t BaseWallNs;
+  double TicksPerNs;
+} __attribute__((packed, aligned(1)));
+
+constexpr char kTraceDumpMagic[8] = {'P', 'T', 'M', 'E', 'T', 'R', 'C', '\0'};
+constexpr uint32_t kTraceDumpVersion = 1;
+
+/**
+ * the last kCapacity stage events of the matching thread, a record is one
+ * 21 byte store into a preallocated ring and a head increment, so it stays
+ * on in production
+ *
+ * dumps are taken at the next Poll, either requested (RequestDump is async
+ * signal safe) or after a stage took longer than the spike threshold,
+ * spike dumps are at least a second apart, the matching thread only copies
+ * the ring into a preallocated snapshot and the file is written on a
+ * thread of the ring's own, a spike while the previous dump is still being
+ * written is not dumped, a request waits for the next Poll
+ */
+class TraceRing {
+ public:
+  static constexpr uint64_t kCapacity = 1 << 16;
+
+  TraceRing(std::string_view dump_path, uint64_t spike_ns);
+  // writes the dump in progress, if any, first
+  ~TraceRing();
+
+  TraceRing(const TraceRing&) = delete;
+  TraceRing& operator=(const TraceRing&) = delete;
+
+  void Record(Stage stage, ID_t id, uint64_t start, uint64_t end) noexcept {
+    const uint64_t head = m_head_.load(std::memory_order_relaxed);
+
+    m_events_[head & (kCapacity - 1)] = TraceEvent{.OrderId = id,
+                                                   .StartTsc = start,
+                                                   .Ticks = Ticks(start, end),
+                                                   .EventStage = stage};
+
+    m_head_.store(head + 1, std::memory_order_release);
+
+    if (end - start > m_spike_ticks_) [[unlikely]] {
+      m_spike_ = true;
+    }
+  }
+
+  void Poll() noexcept {
+    if (m_dump_requested_.load(std::memory_order_relaxed)) [[unlikely]] {
+      if (Snapshot(kTraceDumpRequested)) {
+        m_dump_requested_.store(false, std::memory_order_relaxed);
+      }
+    }
+
+    if (m_spike_) [[unlikely]] {
+      m_spike_ = false;
+
+      const uint64_t now = ReadTsc();
+      if (now - m_last_spike_dump_ > m_spike_cooldown_ticks_ and
+          Snapshot(kTraceDumpSpike)) {
+        m_last_spike_dump_ = now;
+      }
+    }
+  }
+
+  void RequestDump() noexcept {
+    m_dump_requested_.store(true, std::memory_order_relaxed);
+  }
+
+  // writes the ring on the calling thread, only async signal safe calls,
+  // so it may also run from a signal handler
+  bool Dump(uint8_t reason) noexcept;
+
+  // blocks until the snapshot taken by Poll, if any, has been written
+  void WaitForDump() const noexcept;
+
+ private:
+  enum SnapshotState : uint8_t { kIdle, kTaken, kStopping };
+
+  static uint32_t Ticks(uint64_t start, uint64_t end) {
+    return end - start > UINT32_MAX ? UINT32_MAX : end - start;
+  }
+
+  // copies the ring for the writer, false if it is still busy with the
+  // previous snapshot
+  bool Snapshot(uint8_t reason) noexcept;
+  void WriteSnapshots() noexcept;
+  // the events oldest first, in up to two parts
+  bool Write(uint8_t reason,
+             std::span<const TraceEvent> older,
+             std::span<const TraceEvent> newer) const noexcept;
+
+ private:
+  std::unique_ptr<TraceEvent[]> m_events_;
+  std::atomic<uint64_t> m_head_{0};
+
+  // handed from the matching thread to the writer while kTaken
+  std::unique_ptr<TraceEvent[]> m_snapshot_;
+  uint64_t m_snapshot_count_{0};
+  uint8_t m_snapshot_reason_{0};
+  std::atomic<SnapshotState> m_snapshot_state_{kIdle};
+
+  std::string m_dump_path_;
+  std::atomic<bool> m_dump_requested_{false};
+
+  uint64_t m_spike_ticks_;
+  uint64_t m_spike_cooldown_ticks_;
+  uint64_t m_last_spike_dump_{0};
+  bool m_spike_{false};
+
+  double m_ticks_per_ns_;
+  uint64_t m_base_tsc_;
+  int64_t m_base_wall_ns_;
+
+  std::thread m_writer_;
+};
+
+// records every stage of the order handler into a TraceRing
+class TraceInstrumentation {
+ public:
+  explicit TraceInstrumentation(TraceRing& ring) : m_ring_{&ring} {}
+
+  uint64_t Now() const noexcept { return ReadTsc(); }
+
+  void Record(Stage stage, ID_t id, uint64_t start, uint64_t end) noexcept {
+    m_ring_->Record(stage, id, start, end);
+  }
+
+  void Poll() noexcept { m_ring_->Poll(); }
+
+ private:
+  TraceRing* m_ring_;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include "linux/epoll.h"
+#include "linux/mirrored_buffer.h"
+#include "linux/tcp.h"
+#include "trade_result.h"
+
+/**
+ * trades for any number of subscribers at once, e.g. clearing, risk and
+ * surveillance, where TradeObserver feeds exactly one
+ *
+ * Send runs on the matching thread and appends to one in-memory trade
+ * log, it never waits on a subscriber: the log is a ring which overwrites
+ * its oldest trades, and a trade's position in it is its sequence number
+ *
+ * Run serves the subscribers on its own thread, each from its own cursor
+ * into the log, straight from the log to the socket, a subscriber whose
+ * socket is full is skipped until it drains again, one the log laps before
+ * it has caught up, or whose connection breaks, is dropped, the others
+ * never wait for it
+ *
+ * a subscriber first gets the sequence number of its first trade as 8
+ * bytes, then the trades back to back, it starts half a log behind the
+ * newest trade, so a subscriber connecting early sees every trade and a
+ * late one has room to catch up
+ */
+class TradeFanout {
+ public:
+  static constexpr uint32_t kMaxSubscribers = 64;
+  // a multiple of 2048, so the log is a whole number of pages
+  static constexpr uint64_t kDefaultLogTrades = 1 << 20;
+
+ public:
+  TradeFanout(std::string_view host,
+              uint16_t port,
+              uint64_t log_trades = kDefaultLogTrades);
+
+  TradeFanout(const TradeFanout&) = delete;
+  TradeFanout& operator=(const TradeFanout&) = delete;
+
+  // matching thread, always succeeds, results fit the log
+  bool Send(std::span<const TradeResult> results) noexcept;
+
+  void Run();  // this is blocking run
+
+  // one round, takes new subscribers and sends every one what its socket
+  // takes, false if there was nothing to send
+  bool Poll();
+
+  // Run's thread
+  uint32_t SubscriberCount() const { return m_subscriber_count_; }
+  uint64_t DroppedCount() const { return m_dropped_count_; }
+
+  // any thread, trades appended so far
+  uint64_t Published() const {
+    return m_head_.load(std::memory_order_acquire) / sizeof(TradeResult);
+  }
+
+ private:
+  static constexpr uint64_t kListenerTag = UINT64_MAX;
+
+  struct Subscriber {
+    TcpSocket Sock{-1};
+    bool Open{false};
+    // waiting for its socket to drain
+    bool Blocked{false};
+    // bytes into the log
+    uint64_t Cursor{0};
+  };
+
+  void AcceptAll();
+  void OnEvent(uint32_t index, uint32_t events);
+  bool Flush(Subscriber& subscriber);
+  // true if the writer has overwritten, or is overwriting, the cursor
+  bool Lapped(const Subscriber& subscriber) const;
+  void Drop(Subscriber& subscriber, std::string_view reason);
+
+ private:
+  TcpSocket m_server_fd_;
+  Epoll m_epoll_;
+
+  MirroredBuffer m_log_;
+
+  // the writer's side, head is what is readable, reserved what it may be
+  // writing up to, both in bytes and only growing
+  alignas(64) std::atomic<uint64_t> m_head_{0};
+  alignas(64) std::atomic<uint64_t> m_reserved_{0};
+
+  alignas(64) std::array<Subscriber, kMaxSubscribers> m_subscribers_;
+  uint32_t m_subscriber_count_{0};
+  uint64_t m_dropped_count_{0};
+};
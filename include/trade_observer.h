@@ -1,28 +1,63 @@
 #pragma once
 
-#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <span>
 #include <string_view>
-#include <vector>
 #include "linux/tcp.h"
+#include "linux/uring.h"
+#include "shm_ring.h"
+#include "spsc_ring.h"
 #include "trade_result.h"
 
+// plain storage so it can be placed in a shared mapping next to the engine
+using TradeQueue = SpscRing<TradeResult, 1 << 14>;
+// the same queue in a named shared mapping, read by a co-located consumer
+using ShmTradeRing = ShmRing<TradeResult, TradeQueue::kCapacity>;
+
+/**
+ * Send runs on the matching thread and only copies into the queue, Run
+ * drains it on its own thread straight from the queue's storage to the
+ * socket, so a slow observer never stalls matching until the queue is full
+ *
+ * with io_uring enabled the queue's storage is a registered buffer and the
+ * socket a fixed file, each send is a zero copy send of everything queued
+ * since the previous one completed
+ *
+ * with a shared memory path the queue itself lives in that mapping and is
+ * drained by the consumer process, Send is then the whole hop and Run
+ * returns straight away
+ */
 class TradeObserver {
  public:
-  TradeObserver(std::string_view host,
-                uint16_t port,
-                uint32_t queue_size = 10'000);
+  TradeObserver(std::string_view host, uint16_t port);
+  // queue is owned by the caller and must outlive the observer
+  TradeObserver(std::string_view host, uint16_t port, TradeQueue& queue);
+  // e.g. /dev/shm/matching_engine_trades, see ShmTradeRing
+  explicit TradeObserver(std::string_view shm_path);
   TradeObserver(const TradeObserver&) = delete;
   TradeObserver& operator=(const TradeObserver&) = delete;
 
+  // false if the queue has no room for the results yet, results larger
+  // than the whole queue are pushed in parts, waiting for Run to drain it
   bool Send(std::span<const TradeResult> results) noexcept;
   void Run();
 
+  // sends through io_uring from now on, throws a BaseIOError if the kernel
+  // does not allow it or has no zero copy send, the blocking socket is used
+  // then, nothing to do for a shared memory queue
+  void EnableIoUring(bool sqpoll);
+
+ private:
+  void Connect(std::string_view host, uint16_t port);
+  void SendAll(std::span<const TradeResult> results);
+  void SendZeroCopy(std::span<const TradeResult> results);
+
  private:
-  std::vector<TradeResult> m_queue_;
-  uint32_t m_count_{0};
-  std::atomic_flag m_flag_{ATOMIC_FLAG_INIT};
+  std::unique_ptr<TradeQueue> m_owned_queue_;
+  std::unique_ptr<ShmTradeRing> m_shm_ring_;
+  TradeQueue& m_queue_;
 
-  TcpSocket m_client_sock_;
+  TcpSocket m_client_sock_{-1};
+  std::unique_ptr<IoUring> m_ring_;
 };
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <span>
+
+// stands in for the handler a transport is polled with
+struct OrderSinkArchetype {
+  void operator()(std::span<const uint8_t>) {}
+};
+
+/**
+ * where a server's orders come from, Poll hands whatever arrives within
+ * timeout_ms (-1 for ever) to the handler, only ever whole orders of one
+ * source at a time, and tells whether there was anything
+ *
+ * Exhausted is true once nothing more can arrive, never for live sources
+ */
+template <class T>
+concept Transport_t =
+    requires(T transport, OrderSinkArchetype& handler, int timeout_ms) {
+      { transport.Poll(handler, timeout_ms) } -> std::same_as<bool>;
+      { transport.Exhausted() } -> std::same_as<bool>;
+    };
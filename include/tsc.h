@@ -0,0 +1,20 @@
+#pragma once
+
+#include <x86intrin.h>
+#include <chrono>
+#include <cstdint>
+
+// time stamp counter, assumes an invariant tsc (constant_tsc, nonstop_tsc)
+inline uint64_t ReadTsc() noexcept {
+  return __rdtsc();
+}
+
+// waits for the preceding instructions to retire, use at the end of a region
+inline uint64_t ReadTscp() noexcept {
+  unsigned int aux;
+  return __rdtscp(&aux);
+}
+
+// tsc ticks per nanosecond, measured against steady_clock
+double CalibrateTsc(
+    std::chrono::milliseconds duration = std::chrono::milliseconds{100});
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include "linux/tcp.h"
+#include "linux/uring.h"
+#include "order.h"
+#include "server.h"
+
+/**
+ * io_uring flavour of Server, same callback and guarantees
+ *
+ * one multishot accept places new connections straight into the fixed file
+ * table, each session then has one multishot recv which picks its buffers
+ * from a registered buffer ring, so in steady state a batch of received
+ * orders costs no system call beyond the (sqpoll free) completion wait
+ *
+ * every completion carries at most one buffer of one session and
+ * completions are handled in the order the kernel posted them, which
+ * interleaves busy sessions fairly, orders split across two buffers are
+ * reassembled per session and handed over on their own, everything else
+ * is passed to the callback straight from the receive buffer
+ */
+class UringServer {
+ public:
+  using RecvCallBack = Server::RecvCallBack;
+
+  static constexpr uint32_t kMaxSessions = Server::kMaxSessions;
+
+ public:
+  UringServer(std::string host,
+              uint16_t port,
+              RecvCallBack recv_callback,
+              bool sqpoll = false);
+
+  void Run();  // this is blocking run
+
+  // waits up to timeout_ms for completions (-1 for ever) and handles them
+  void Poll(int timeout_ms);
+
+  uint32_t SessionCount() const { return m_session_count_; }
+
+ private:
+  static constexpr uint32_t kBufferCount = 256;
+  static constexpr uint32_t kBufferSize = 4096;
+  static constexpr uint16_t kBufferGroup = 0;
+  // the listener sits behind the slots handed to accepted sessions
+  static constexpr uint32_t kListenerSlot = kMaxSessions;
+
+  enum Op : uint64_t { kAccept = 1, kRecv = 2, kClose = 3 };
+
+  struct BufferPool {
+    // page aligned, as the kernel requires of a buffer ring
+    alignas(4096) io_uring_buf Ring[kBufferCount];
+    uint8_t Buffers[kBufferCount][kBufferSize];
+  };
+
+  struct Session {
+    bool Open{false};
+    uint32_t CarryLen{0};
+    uint8_t Carry[sizeof(Order)];
+  };
+
+  static uint64_t Tag(Op op, uint32_t slot) { return op << 32 | slot; }
+
+  io_uring_sqe* NextSqe();
+  void ArmAccept();
+  void ArmRecv(uint32_t slot);
+  void CloseSession(uint32_t slot);
+  void ProvideBuffer(uint16_t buffer_id);
+
+  void OnAccept(const io_uring_cqe& cqe);
+  void OnRecv(uint32_t slot, const io_uring_cqe& cqe);
+  void OnClose();
+  void Deliver(Session& session, std::span<const uint8_t> data);
+
+ private:
+  RecvCallBack m_recv_callback_;
+
+  IoUring m_ring_;
+
+  std::unique_ptr<BufferPool> m_pool_;
+  uint16_t m_buffer_tail_{0};
+
+  std::unique_ptr<Session[]> m_sessions_;
+  uint32_t m_session_count_{0};
+  // false while a full table keeps the multishot accept stopped
+  bool m_accepting_{false};
+
+  // created after everything above, which may throw, the constructor
+  // closes it if the setup fails after that
+  TcpSocket m_server_fd_;
+};
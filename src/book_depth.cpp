@@ -0,0 +1,95 @@
+#include "book_depth.h"
+#include <bit>
+
+BookDepth::BookDepth() : m_sides_{std::make_unique<std::array<Side, 2>>()} {}
+
+void BookDepth::Add(OrderType_t side,
+                    Price_t price,
+                    Quantity_t quantity) noexcept {
+  Side& book = (*m_sides_)[side];
+
+  if (book.Quantities[price] == 0) {
+    book.Occupied[price / 64] |= uint64_t{1} << (price % 64);
+    book.Summary[price / 4096] |= uint64_t{1} << (price / 64 % 64);
+  }
+  book.Quantities[price] += quantity;
+  ++m_version_;
+}
+
+void BookDepth::Remove(OrderType_t side,
+                       Price_t price,
+                       Quantity_t quantity) noexcept {
+  Side& book = (*m_sides_)[side];
+
+  book.Quantities[price] -= quantity;
+  ++m_version_;
+
+  if (book.Quantities[price] > 0) {
+    return;
+  }
+
+  book.Occupied[price / 64] &= ~(uint64_t{1} << (price % 64));
+  if (book.Occupied[price / 64] == 0) {
+    book.Summary[price / 4096] &= ~(uint64_t{1} << (price / 64 % 64));
+  }
+}
+
+void BookDepth::Remove(Price_t price, Quantity_t quantity) noexcept {
+  Remove(Quantity(kBuy, price) > 0 ? kBuy : kSell, price, quantity);
+}
+
+uint32_t BookDepth::Quantity(OrderType_t side, Price_t price) const noexcept {
+  return (*m_sides_)[side].Quantities[price];
+}
+
+uint32_t BookDepth::Top(OrderType_t side,
+                        std::span<DepthLevel> levels) const noexcept {
+  return side == kBuy ? TopBids(levels) : TopAsks(levels);
+}
+
+uint32_t BookDepth::TopBids(std::span<DepthLevel> levels) const noexcept {
+  const Side& book = (*m_sides_)[kBuy];
+  uint32_t count = 0;
+
+  // highest price first
+  for (uint32_t s = kSummaryCount; s-- > 0;) {
+    for (uint64_t summary = book.Summary[s]; summary != 0;) {
+      const uint32_t w = s * 64 + 63 - std::countl_zero(summary);
+      summary &= ~(uint64_t{1} << (w % 64));
+
+      for (uint64_t word = book.Occupied[w]; word != 0;) {
+        if (count == levels.size()) {
+          return count;
+        }
+        const uint32_t bit = 63 - std::countl_zero(word);
+        word &= ~(uint64_t{1} << bit);
+
+        const Price_t price = w * 64 + bit;
+        levels[count++] = DepthLevel{price, book.Quantities[price]};
+      }
+    }
+  }
+  return count;
+}
+
+uint32_t BookDepth::TopAsks(std::span<DepthLevel> levels) const noexcept {
+  const Side& book = (*m_sides_)[kSell];
+  uint32_t count = 0;
+
+  // lowest price first
+  for (uint32_t s = 0; s < kSummaryCount; ++s) {
+    for (uint64_t summary = book.Summary[s]; summary != 0;
+         summary &= summary - 1) {
+      const uint32_t w = s * 64 + std::countr_zero(summary);
+
+      for (uint64_t word = book.Occupied[w]; word != 0; word &= word - 1) {
+        if (count == levels.size()) {
+          return count;
+        }
+        const Price_t price = w * 64 + std::countr_zero(word);
+        levels[count++] = DepthLevel{price, book.Quantities[price]};
+      }
+    }
+  }
+  return count;
+}
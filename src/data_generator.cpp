@@ -1,78 +1,535 @@
-#include <cassert>
-#include <fstream>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <iostream>
-#include <sstream>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
+#include "command_line.h"
+#include "csv_order_parser.h"
+#include "execution_report.h"
+#include "fix.h"
+#include "idle_wait.h"
+#include "latency_summary.h"
+#include "linux/file_map.h"
 #include "linux/tcp.h"
 #include "order.h"
+#include "order_file.h"
+#include "shm_server.h"
+#include "trade_result.h"
 
-void generate_order(const char* file_path,
-                    std::vector<uint8_t>& buffer,
-                    uint32_t max_order) {
-  std::ifstream file(file_path);
-  assert(file.is_open());
+namespace {
+using Clock = std::chrono::steady_clock;
 
-  std::string line;
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             Clock::now().time_since_epoch())
+      .count();
+}
 
-  union {
-    BuyOrder* buy;
-    SellOrder* sell;
-    uint8_t* data;
-  } buf;
+// per order timestamps in steady clock nanoseconds, indexed by file position
+struct OrderTimes {
+  explicit OrderTimes(uint32_t count)
+      : Intended(count), Sent(count), Answered(count) {}
+
+  std::vector<int64_t> Intended;
+  std::vector<std::atomic<int64_t>> Sent;
+  std::vector<uint8_t> Answered;
+};
+
+struct LatencySamples {
+  // from the scheduled send time, corrects for coordinated omission
+  std::vector<uint64_t> Response;
+  // from the actual send time, what a closed loop tester would report
+  std::vector<uint64_t> Service;
+};
+}  // namespace
+
+/**
+ * the orders to send, straight from the mapping for an order file, csv input
+ * is parsed into `parsed` first
+ */
+std::span<const uint8_t> LoadOrders(const FileMap& file,
+                                    std::vector<uint8_t>& parsed,
+                                    uint64_t max_order) {
+  std::span<const uint8_t> orders;
+
+  if (IsOrderFile(file.Data())) {
+    orders = OrderFileRecords(file.Data());
+  } else {
+    const std::string_view text{
+        reinterpret_cast<const char*>(file.Data().data()), file.Data().size()};
+
+    const uint64_t malformed =
+        ParseCsvOrders(text, [&parsed](const Order& order) {
+          const uint8_t* data = reinterpret_cast<const uint8_t*>(&order);
+          parsed.insert(std::end(parsed), data, data + sizeof(Order));
+        });
+
+    if (malformed > 0) {
+      std::cerr << "skipped " << malformed << " malformed lines" << '\n';
+    }
+    orders = parsed;
+  }
+
+  std::cout << "finish loading!" << '\n';
+
+  return orders.first(std::min(orders.size(), max_order * sizeof(Order)));
+}
+
+TcpSocket ConnectToEngine(uint16_t port = 5678) {
+  // the engine only listens once it has reached its trade consumer
+  for (int attempt = 0; attempt < 500; ++attempt) {
+    TcpSocket conn;
+    SetSocketReusable(conn);
+    SetSocketNoDelay(conn);
+
+    if (conn.Connect("127.0.0.1", port)) {
+      return conn;
+    }
+    conn.Close();
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  }
 
-  buf.data = buffer.data();
+  std::cerr << "unable to connect" << '\n';
+  exit(-1);
+}
 
-  uint32_t index = 0;
+bool SendAll(TcpSocket& conn, std::span<const uint8_t> buffer) {
+  while (!buffer.empty()) {
+    const int byte_sent = conn.Send(buffer);
+    if (byte_sent <= 0) {
+      return false;
+    }
+    buffer = buffer.subspan(byte_sent);
+  }
+  return true;
+}
 
-  while (std::getline(file, line) && index < max_order) {
-    std::string item;
-    std::stringstream ss(line);
-    std::string order_type;
+/**
+ * open loop: every order has a fixed send time regardless of how the engine
+ * keeps up, whatever is due when the sender wakes goes out in one send
+ */
+void SendOnSchedule(TcpSocket conn,
+                    std::span<const uint8_t> orders,
+                    std::span<const uint32_t> indices,
+                    OrderTimes& times) {
+  uint32_t next = 0;
 
-    std::getline(ss, order_type, ',');
+  while (next < indices.size()) {
+    const int64_t now = NowNs();
+    const int64_t due = times.Intended[indices[next]];
 
-    std::getline(ss, item, ',');
-    const ID_t id = std::stoi(item);
+    if (now < due) {
+      if (due - now > 100'000) {
+        std::this_thread::sleep_for(
+            std::chrono::nanoseconds{due - now - 50'000});
+      }
+      continue;
+    }
+
+    uint32_t end = next + 1;
+    while (end < indices.size() and times.Intended[indices[end]] <= now) {
+      ++end;
+    }
 
-    std::getline(ss, item, ',');
-    const Price_t price = std::stoi(item);
+    // stamped before sending, the trade may come back before send returns
+    for (uint32_t i = next; i < end; ++i) {
+      times.Sent[indices[i]].store(now, std::memory_order_relaxed);
+    }
 
-    std::getline(ss, item, ',');
-    const Quantity_t quantity = std::stoi(item);
+    if (!SendAll(conn, orders.subspan(next * sizeof(Order),
+                                      (end - next) * sizeof(Order)))) {
+      std::cerr << "unable to send to matching engine" << '\n';
+      exit(-1);
+    }
+
+    next = end;
+  }
+}
+
+/**
+ * the aggressor of a trade is the later of the two orders, its first fill is
+ * the engine's response to it, orders which never trade get no response
+ */
+void CollectTrades(TcpSocket conn,
+                   const std::unordered_map<ID_t, uint32_t>& index_of,
+                   OrderTimes& times,
+                   LatencySamples& samples,
+                   std::atomic<int64_t>& last_trade_ns) {
+  std::vector<uint8_t> buffer(1 << 16);
+  uint32_t offset = 0;
+
+  while (1) {
+    const int byte_recv =
+        conn.Recv({buffer.data() + offset, buffer.size() - offset});
+
+    if (byte_recv <= 0) {
+      return;
+    }
 
-    if (order_type == "B") {
-      buf.buy[index] = BuyOrder(id, price, quantity);
+    const int64_t now = NowNs();
+    last_trade_ns.store(now, std::memory_order_relaxed);
 
+    const uint32_t len = offset + byte_recv;
+    const uint32_t count = len / sizeof(TradeResult);
+
+    for (uint32_t i = 0; i < count; ++i) {
+      TradeResult result;
+      std::memcpy(&result, buffer.data() + i * sizeof(TradeResult),
+                  sizeof(result));
+
+      const auto buy = index_of.find(result.BuyId);
+      const auto sell = index_of.find(result.SellId);
+
+      if (buy == std::end(index_of) or sell == std::end(index_of)) {
+        continue;
+      }
+
+      const uint32_t aggressor = std::max(buy->second, sell->second);
+
+      if (times.Answered[aggressor]) {
+        continue;
+      }
+      times.Answered[aggressor] = 1;
+
+      samples.Response.push_back(now - times.Intended[aggressor]);
+      samples.Service.push_back(
+          now - times.Sent[aggressor].load(std::memory_order_relaxed));
+    }
+
+    offset = len % sizeof(TradeResult);
+    std::memmove(buffer.data(), buffer.data() + (len - offset), offset);
+  }
+}
+
+/**
+ * reads the execution reports of a connection until every order on it has
+ * been answered, then prints how many of each type came back
+ */
+void CountReports(TcpSocket conn, uint64_t order_count) {
+  std::array<uint64_t, kCancelled + 1> counts{};
+  std::vector<uint8_t> buffer(1 << 16);
+  uint32_t offset = 0;
+  uint64_t answered = 0;
+
+  while (answered < order_count) {
+    const int byte_recv =
+        conn.Recv({buffer.data() + offset, buffer.size() - offset});
+
+    if (byte_recv <= 0) {
+      std::cerr << "connection lost after " << answered << " answers" << '\n';
+      break;
+    }
+
+    const uint32_t len = offset + byte_recv;
+    const uint32_t count = len / sizeof(ExecutionReport);
+
+    for (uint32_t i = 0; i < count; ++i) {
+      ExecutionReport report;
+      std::memcpy(&report, buffer.data() + i * sizeof(ExecutionReport),
+                  sizeof(report));
+
+      if (report.ExecType >= counts.size()) [[unlikely]] {
+        continue;
+      }
+      ++counts[report.ExecType];
+
+      // fills follow the one answer every order gets
+      if (report.ExecType != kPartiallyFilled and
+          report.ExecType != kFilled) {
+        ++answered;
+      }
+    }
+
+    offset = len % sizeof(ExecutionReport);
+    std::memmove(buffer.data(), buffer.data() + (len - offset), offset);
+  }
+
+  std::cout << "accepted: " << counts[kAccepted]
+            << ", rejected: " << counts[kRejected]
+            << ", partially filled: " << counts[kPartiallyFilled]
+            << ", filled: " << counts[kFilled]
+            << ", cancelled: " << counts[kCancelled] << '\n';
+}
+
+/**
+ * reads the FIX answers of a session until every order on it has been
+ * answered, then prints how many of each type came back
+ */
+void CountFixReports(TcpSocket conn, uint64_t order_count) {
+  // new, rejected, partially filled, filled, cancelled, cancel rejected
+  std::array<uint64_t, 6> counts{};
+  std::vector<uint8_t> buffer(1 << 16);
+  uint64_t buffered = 0;
+  uint64_t answered = 0;
+
+  while (answered < order_count) {
+    const int byte_recv =
+        conn.Recv({buffer.data() + buffered, buffer.size() - buffered});
+
+    if (byte_recv <= 0) {
+      std::cerr << "connection lost after " << answered << " answers" << '\n';
+      break;
+    }
+    buffered += byte_recv;
+
+    std::span<const uint8_t> pending{buffer.data(), buffered};
+    int64_t len;
+    while ((len = FixMessageLength(pending)) > 0) {
+      std::string_view msg_type;
+      std::string_view exec_type;
+      std::string_view ord_status;
+
+      ForEachFixField(FixBody(pending.first(len)),
+                      [&](uint32_t tag, std::string_view value) {
+                        if (tag == kFixMsgType) {
+                          msg_type = value;
+                        } else if (tag == kFixExecType) {
+                          exec_type = value;
+                        } else if (tag == kFixOrdStatus) {
+                          ord_status = value;
+                        }
+                      });
+
+      if (msg_type == "9") {
+        ++counts[5];
+        ++answered;
+      } else if (msg_type == "8" and exec_type == "F") {
+        ++counts[ord_status == "2" ? 3 : 2];
+      } else if (msg_type == "8" and !exec_type.empty()) {
+        ++counts[exec_type == "0" ? 0 : (exec_type == "4" ? 4 : 1)];
+        ++answered;
+      }
+      pending = pending.subspan(len);
+    }
+
+    if (len < 0) {
+      std::cerr << "garbled fix message after " << answered << " answers"
+                << '\n';
+      break;
+    }
+
+    std::memmove(buffer.data(), pending.data(), pending.size());
+    buffered = pending.size();
+  }
+
+  std::cout << "new: " << counts[0] << ", rejected: " << counts[1]
+            << ", partially filled: " << counts[2]
+            << ", filled: " << counts[3] << ", cancelled: " << counts[4]
+            << ", cancel rejected: " << counts[5] << '\n';
+}
+
+/**
+ * the orders as NewOrderSingle and OrderCancelRequest of one FIX session,
+ * logged on first, order ids become ClOrdIDs, cancels number their own
+ * requests above every order id
+ */
+std::vector<uint8_t> ToFixMessages(std::span<const uint8_t> orders) {
+  union {
+    const uint8_t* data;
+    const Order* order;
+  } msg;
+  msg.data = orders.data();
+
+  const uint64_t order_count = orders.size() / sizeof(Order);
+
+  ID_t cancel_id = 0;
+  for (uint64_t i = 0; i < order_count; ++i) {
+    cancel_id = std::max(cancel_id, msg.order[i].Id());
+  }
+
+  std::vector<uint8_t> messages((order_count + 1) * FixWriter::kMaxMessageLen);
+  uint64_t len = 0;
+  uint64_t seq_num = 1;
+  FixWriter writer;
+
+  auto begin = [&writer, &seq_num](char msg_type) -> FixWriter& {
+    return writer.Add(kFixMsgType, msg_type)
+        .Add(kFixSenderCompId, "DATAGEN")
+        .Add(kFixTargetCompId, "ENGINE")
+        .Add(kFixMsgSeqNum, seq_num++)
+        .Add(kFixSendingTime, "20260101-00:00:00");
+  };
+
+  begin('A').Add(kFixEncryptMethod, uint64_t{0}).Add(kFixHeartBtInt, "30");
+  len += writer.Finish(messages.data() + len);
+
+  for (uint64_t i = 0; i < order_count; ++i) {
+    const Order& order = msg.order[i];
+
+    if (order.OrderType() == kCancel) {
+      begin('F')
+          .Add(kFixClOrdId, ++cancel_id)
+          .Add(kFixOrigClOrdId, order.Id())
+          .Add(kFixSymbol, "PTME")
+          .Add(kFixSide, '1');
     } else {
-      buf.sell[index] = SellOrder(id, price, quantity);
+      begin('D')
+          .Add(kFixClOrdId, order.Id())
+          .Add(kFixSymbol, "PTME")
+          .Add(kFixSide, order.OrderType() == kBuy ? '1' : '2')
+          .Add(kFixOrderQty, uint64_t{order.Quantity()})
+          .Add(kFixOrdType, '2')
+          .Add(kFixPrice, uint64_t{order.Price()});
     }
+    len += writer.Finish(messages.data() + len);
+  }
+
+  messages.resize(len);
+  return messages;
+}
 
-    ++index;
+void RunLoad(std::span<const uint8_t> orders,
+             uint64_t rate,
+             uint32_t connection_count,
+             uint16_t trade_port,
+             uint32_t drain_ms) {
+  const uint32_t order_count = orders.size() / sizeof(Order);
+
+  union {
+    const uint8_t* data;
+    const Order* order;
+  } msg;
+  msg.data = orders.data();
+
+  std::unordered_map<ID_t, uint32_t> index_of;
+  index_of.reserve(order_count);
+  for (uint32_t i = 0; i < order_count; ++i) {
+    index_of.emplace(msg.order[i].Id(), i);
   }
 
-  std::cout << "finish loading!" << '\n';
-  file.close();
+  // orders dealt round robin, each connection gets a contiguous copy
+  std::vector<std::vector<uint8_t>> connection_orders(connection_count);
+  std::vector<std::vector<uint32_t>> connection_indices(connection_count);
+  for (uint32_t i = 0; i < order_count; ++i) {
+    const uint32_t c = i % connection_count;
+    connection_orders[c].insert(std::end(connection_orders[c]),
+                                orders.data() + i * sizeof(Order),
+                                orders.data() + (i + 1) * sizeof(Order));
+    connection_indices[c].push_back(i);
+  }
+
+  TcpSocket trade_server;
+  SetSocketReusable(trade_server);
+  trade_server.Bind("127.0.0.1", trade_port);
+  trade_server.Listen(1);
+
+  std::cout << "waiting for matching engine on trade port " << trade_port
+            << '\n';
+  TcpSocket trade_conn = trade_server.Accept();
+
+  OrderTimes times(order_count);
+  LatencySamples samples;
+  samples.Response.reserve(order_count);
+  samples.Service.reserve(order_count);
+  std::atomic<int64_t> last_trade_ns{0};
+
+  std::jthread collector([&]() {
+    CollectTrades(trade_conn, index_of, times, samples, last_trade_ns);
+  });
+
+  std::vector<TcpSocket> connections;
+  for (uint32_t c = 0; c < connection_count; ++c) {
+    connections.push_back(ConnectToEngine());
+  }
+
+  const int64_t period_ns = 1'000'000'000 / rate;
+  const int64_t start = NowNs() + 1'000'000;
+  for (uint32_t i = 0; i < order_count; ++i) {
+    times.Intended[i] = start + i * period_ns;
+  }
+
+  std::cout << "sending " << order_count << " orders at " << rate
+            << " orders/s over " << connection_count << " connections"
+            << '\n';
+
+  {
+    std::vector<std::jthread> senders;
+    for (uint32_t c = 0; c < connection_count; ++c) {
+      senders.emplace_back(SendOnSchedule, connections[c],
+                           std::span<const uint8_t>{connection_orders[c]},
+                           std::span<const uint32_t>{connection_indices[c]},
+                           std::ref(times));
+    }
+  }
 
-  TcpSocket conn;
-  SetSocketReusable(conn);
-  SetSocketNoDelay(conn);
+  const int64_t send_end = NowNs();
 
-  bool success = conn.Connect("127.0.0.1", 5678);
-  if (!success) {
-    std::cerr << "unable to connect" << '\n';
-    exit(-1);
+  // quiet for drain_ms means the engine has worked through the backlog
+  last_trade_ns.store(send_end, std::memory_order_relaxed);
+  while (NowNs() - last_trade_ns.load(std::memory_order_relaxed) <
+         int64_t{drain_ms} * 1'000'000) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
   }
 
-  std::cout << "sending orders to matching engine..." << index << '\n';
+  trade_conn.Close();
+  collector.join();
+
+  int64_t max_lag = 0;
+  for (uint32_t i = 0; i < order_count; ++i) {
+    max_lag = std::max(max_lag, times.Sent[i].load(std::memory_order_relaxed) -
+                                    times.Intended[i]);
+  }
 
-  conn.Send({buf.data, index * sizeof(Order)});
+  const double seconds = (send_end - start) / 1e9;
+
+  std::cout << "offered rate: " << rate << " orders/s, achieved: "
+            << order_count / seconds << " orders/s, max send lag: "
+            << max_lag / 1'000 << " us" << '\n';
+  std::cout << "orders answered by a trade: " << samples.Response.size()
+            << '\n';
+  std::cout << "response time (ns): " << Summarize(samples.Response) << '\n';
+  std::cout << "service time (ns): " << Summarize(samples.Service) << '\n';
+}
+
+// co-located engine started with --shm-orders, whole orders only
+void SendSharedMemory(std::string_view path,
+                      std::span<const uint8_t> orders,
+                      bool adaptive_wait) {
+  ShmOrderRing ring(path);
+  IdleWait idle_wait(adaptive_wait);
+
+  union {
+    const uint8_t* data;
+    const Order* order;
+  } msg;
+  msg.data = orders.data();
+
+  std::span<const Order> pending{msg.order, orders.size() / sizeof(Order)};
+
+  // a quarter of the ring at a time, so a push fits as soon as the engine
+  // has freed that much instead of waiting for an empty ring
+  while (!pending.empty()) {
+    const std::span<const Order> part = pending.first(
+        std::min<uint64_t>(pending.size(), ShmOrderRing::Ring::kCapacity / 4));
+
+    if (ring.GetRing().TryPush(part)) {
+      pending = pending.subspan(part.size());
+      idle_wait.Reset();
+    } else {
+      idle_wait.Idle();
+    }
+  }
+}
+
+void ExitWithUsage(const char* program) {
+  std::cerr << "Usage: " << program
+            << " <file_path> <max order> [--rate <orders/s>] "
+               "[--connections <n>] [--trade-port <port>] "
+               "[--drain-ms <ms>] | [--shm <path> [--shm-wait adaptive]] | "
+               "[--exec-reports] | [--fix]\n";
+  exit(-1);
 }
 
 int main(int argc, char** argv) {
   if (argc < 3) {
-    std::cerr << "Usage: " << argv[0] << "<file_path> <max order>\n";
-    exit(-1);
+    ExitWithUsage(argv[0]);
   }
 
   const char* file_path = argv[1];
@@ -80,8 +537,64 @@ int main(int argc, char** argv) {
 
   std::cout << "max order: " << max_order << '\n';
 
-  std::vector<uint8_t> buffer;
-  buffer.resize(max_order * sizeof(Order));
+  FileMap file(file_path);
+  std::vector<uint8_t> parsed;
+
+  const std::span<const uint8_t> orders = LoadOrders(file, parsed, max_order);
+  const uint64_t order_count = orders.size() / sizeof(Order);
+
+  if (const auto rate = FlagValue(argc, argv, "--rate"); !rate.empty()) {
+    // orders are paced one period of 1 / rate apart
+    const uint64_t orders_per_second = std::stoul(std::string{rate});
+    if (orders_per_second == 0) {
+      ExitWithUsage(argv[0]);
+    }
+
+    const auto connections = FlagValue(argc, argv, "--connections");
+    const auto trade_port = FlagValue(argc, argv, "--trade-port");
+    const auto drain_ms = FlagValue(argc, argv, "--drain-ms");
+
+    RunLoad(orders, orders_per_second,
+            connections.empty() ? 1 : std::stoul(std::string{connections}),
+            trade_port.empty() ? 8765 : std::stoul(std::string{trade_port}),
+            drain_ms.empty() ? 1000 : std::stoul(std::string{drain_ms}));
+    return 0;
+  }
+
+  if (const auto path = FlagValue(argc, argv, "--shm"); !path.empty()) {
+    std::cout << "writing orders to " << path << "..." << order_count << '\n';
+    SendSharedMemory(path, orders,
+                     FlagValue(argc, argv, "--shm-wait") == "adaptive");
+    return 0;
+  }
+
+  // an engine run with --fix, one session answered in FIX
+  if (HasFlag(argc, argv, "--fix")) {
+    const std::vector<uint8_t> messages = ToFixMessages(orders);
+    TcpSocket conn = ConnectToEngine(9878);
+
+    std::cout << "sending fix orders to matching engine..." << order_count
+              << '\n';
+
+    const int64_t start = NowNs();
+    {
+      std::jthread report_reader(CountFixReports, conn, order_count);
+      SendAll(conn, messages);
+    }
+    std::cout << "answered in " << (NowNs() - start) / 1'000'000 << " ms"
+              << '\n';
+    return 0;
+  }
+
+  TcpSocket conn = ConnectToEngine();
+
+  std::cout << "sending orders to matching engine..." << order_count << '\n';
+
+  // an engine run with --exec-reports answers every order on this connection
+  std::jthread report_reader;
+  if (HasFlag(argc, argv, "--exec-reports")) {
+    report_reader = std::jthread(CountReports, conn, order_count);
+  }
 
-  generate_order(file_path, buffer, max_order);
+  SendAll(conn, orders);
 }
@@ -0,0 +1,74 @@
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include "command_line.h"
+#include "linux/udp.h"
+#include "market_data.h"
+
+namespace {
+void PrintSide(const char* name, std::span<const DepthLevel> levels) {
+  std::printf("%s:", name);
+  for (const DepthLevel& level : levels) {
+    std::printf(" %u@%u", level.Quantity, level.Price);
+  }
+}
+
+void Print(const DepthFeed& feed) {
+  std::printf("sequence: %lu, ", feed.Sequence());
+  PrintSide("bids", feed.View().Side(kBuy));
+  std::printf(", ");
+  PrintSide("asks", feed.View().Side(kSell));
+  std::printf("\n");
+}
+}  // namespace
+
+// prints the book after every datagram of a matching engine run with
+// --depth, e.g. depth_listener --port 8770, or --host 239.1.1.1 for a
+// multicast group
+int main(int argc, char** argv) {
+  const auto port = FlagValue(argc, argv, "--port");
+  if (port.empty()) {
+    std::cout << "Usage: depth_listener [--host <address>] --port <port>"
+              << '\n';
+    return -1;
+  }
+
+  std::string host{FlagValue(argc, argv, "--host")};
+  if (host.empty()) {
+    host = "127.0.0.1";
+  }
+
+  UdpSocket sock;
+  sock.Bind(host, std::stoi(std::string{port}));
+
+  if (IsMulticastAddress(host)) {
+    JoinMulticastGroup(sock, host);
+  }
+
+  DepthFeed feed;
+  std::array<uint8_t, MarketDataPublisher::kMaxPacketLen> packet;
+
+  while (1) {
+    const int byte_recv = sock.Recv(packet);
+    if (byte_recv <= 0) {
+      continue;
+    }
+
+    const bool synced = feed.Synced();
+    const uint64_t gap_count = feed.GapCount();
+
+    if (feed.Apply(std::span{packet}.first(byte_recv))) {
+      if (!synced) {
+        std::cout << "synced at sequence " << feed.Sequence() << '\n';
+      }
+      Print(feed);
+    } else if (feed.GapCount() > gap_count) {
+      std::cout << "gap after sequence " << feed.Sequence()
+                << ", waiting for a snapshot" << '\n';
+    }
+  }
+}
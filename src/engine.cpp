@@ -3,8 +3,17 @@
 #include <cstring>
 #include <iostream>
 #include <ranges>
+#include "state_hash.h"
 
 Engine::Engine() : m_buy_count_{0}, m_sell_count_{0} {
+  BindCaches();
+}
+
+void Engine::Reattach() noexcept {
+  BindCaches();
+}
+
+void Engine::BindCaches() noexcept {
   m_buy_price_caches_ =
       std::span<Price_t>(reinterpret_cast<Price_t*>(m_caches_), kMaxOrders);
 
@@ -38,6 +47,9 @@ void Engine::AddOrder(BuyOrder order) noexcept {
   const ID_t id = order.Id();
   const Quantity_t quantity = order.Quantity();
 
+  m_state_hash_ ^= OrderHash(kBuy, id, price, quantity);
+  ++m_stats_.AddOrders;
+
   if (m_buy_count_ == 0) {
     InsertBuyOrderAt(0, price, ColdCache{.Id = id, .Quantity = quantity});
     ++m_buy_count_;
@@ -65,6 +77,9 @@ void Engine::AddOrder(BuyOrder order) noexcept {
   Price_t current_price = price;
   ColdCache current_item{.Id = id, .Quantity = quantity};
 
+  // the touch is the last slot
+  m_stats_.InsertDistance += m_buy_count_ - index - 1;
+
   ShiftRightByOneAt(index, m_buy_count_ - index, price_slice, item_slice);
 
   InsertBuyOrderAt(index, current_price, current_item);
@@ -80,6 +95,9 @@ void Engine::AddOrder(SellOrder order) noexcept {
   const ID_t id = order.Id();
   const Quantity_t quantity = order.Quantity();
 
+  m_state_hash_ ^= OrderHash(kSell, id, price, quantity);
+  ++m_stats_.AddOrders;
+
   if (m_sell_count_ == 0) {
     InsertSellOrderAt(0, price, ColdCache{.Id = id, .Quantity = quantity});
     ++m_sell_count_;
@@ -107,12 +125,67 @@ void Engine::AddOrder(SellOrder order) noexcept {
   Price_t current_price = price;
   ColdCache current_item{.Id = id, .Quantity = quantity};
 
+  m_stats_.InsertDistance += m_sell_count_ - index - 1;
+
   // shift all the elements to right by 1
   ShiftRightByOneAt(index, m_sell_count_ - index, price_slice, item_slice);
 
   InsertSellOrderAt(index, current_price, current_item);
 }
 
+/**
+ * 1 equal range search for the run of orders at the cancel price
+ * 2 scan the run for the id, buy side first then sell side
+ * 3 shift all the elements after it left by 1
+ */
+Quantity_t Engine::Cancel(CancelOrder order) noexcept {
+  ++m_stats_.Cancels;
+
+  const Quantity_t quantity =
+      CancelAt(order.Id(), order.Price(), kBuy, m_buy_count_,
+               m_buy_price_caches_, m_buy_item_caches_,
+               [](Price_t lhs, Price_t rhs) { return lhs < rhs; });
+
+  if (quantity > 0) {
+    return quantity;
+  }
+
+  return CancelAt(order.Id(), order.Price(), kSell, m_sell_count_,
+                  m_sell_price_caches_, m_sell_item_caches_,
+                  [](Price_t lhs, Price_t rhs) { return lhs > rhs; });
+}
+
+Quantity_t Engine::CancelAt(ID_t id,
+                            Price_t price,
+                            OrderType_t order_type,
+                            uint32_t& count,
+                            std::span<Price_t> price_caches,
+                            std::span<ColdCache> item_caches,
+                            auto&& comp) noexcept {
+  const std::span<Price_t> price_slice{price_caches.data(), count};
+
+  const auto [first, last] =
+      std::ranges::equal_range(price_slice, price, comp);
+
+  for (auto it = first; it != last; ++it) {
+    const uint32_t index = std::distance(std::begin(price_slice), it);
+
+    if (item_caches[index].Id != id) {
+      continue;
+    }
+
+    const Quantity_t quantity = item_caches[index].Quantity;
+    m_state_hash_ ^= OrderHash(order_type, id, price, quantity);
+
+    ShiftLeftByOneAt(index, count - index - 1, price_caches, item_caches);
+    --count;
+
+    return quantity;
+  }
+
+  return 0;
+}
+
 std::vector<TradeResult> Engine::Execute() noexcept {
   std::vector<TradeResult> result;
 
@@ -129,6 +202,11 @@ std::vector<TradeResult> Engine::Execute() noexcept {
     const ID_t buy_id = m_buy_item_caches_[b_i].Id;
     const ID_t sell_id = m_sell_item_caches_[s_i].Id;
 
+    m_state_hash_ ^= FillHash(kBuy, buy_id, buy_price,
+                              m_buy_item_caches_[b_i].Quantity, quantity) ^
+                     FillHash(kSell, sell_id, sell_price,
+                              m_sell_item_caches_[s_i].Quantity, quantity);
+
     m_buy_item_caches_[b_i].Quantity -= quantity;
     m_sell_item_caches_[s_i].Quantity -= quantity;
 
@@ -150,5 +228,27 @@ std::vector<TradeResult> Engine::Execute() noexcept {
     b_i -= buy_shift_count;
   }
 
+  ++m_stats_.Executes;
+  m_stats_.Trades += result.size();
+
   return result;
 }
+
+EngineStats Engine::Stats() const noexcept {
+  auto count_levels = [](std::span<const Price_t> prices) {
+    uint32_t levels = 0;
+    for (uint32_t i = 0; i < prices.size(); ++i) {
+      levels += i == 0 or prices[i] != prices[i - 1];
+    }
+    return levels;
+  };
+
+  EngineStats stats = m_stats_;
+
+  stats.BuyDepth = m_buy_count_;
+  stats.SellDepth = m_sell_count_;
+  stats.BuyLevels = count_levels(m_buy_price_caches_.first(m_buy_count_));
+  stats.SellLevels = count_levels(m_sell_price_caches_.first(m_sell_count_));
+
+  return stats;
+}
@@ -0,0 +1,21 @@
+#include "engine_stats.h"
+
+namespace {
+double PerOp(uint64_t total, uint64_t op_count) {
+  return op_count == 0 ? 0.0 : static_cast<double>(total) / op_count;
+}
+}  // namespace
+
+std::ostream& operator<<(std::ostream& os, const EngineStats& stats) {
+  return os << "adds: " << stats.AddOrders << ", cancels: " << stats.Cancels
+            << ", executes: " << stats.Executes
+            << ", trades per execute: " << PerOp(stats.Trades, stats.Executes)
+            << ", shift bytes per add/cancel: "
+            << PerOp(stats.ShiftBytes, stats.AddOrders + stats.Cancels)
+            << ", insert distance per add: "
+            << PerOp(stats.InsertDistance, stats.AddOrders)
+            << ", sift steps per add/execute: "
+            << PerOp(stats.SiftSteps, stats.AddOrders + stats.Executes)
+            << ", depth: " << stats.BuyDepth << "/" << stats.SellDepth
+            << ", levels: " << stats.BuyLevels << "/" << stats.SellLevels;
+}
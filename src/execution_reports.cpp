@@ -0,0 +1,124 @@
+#include "execution_reports.h"
+#include <algorithm>
+#include <cassert>
+
+ExecutionReports::ExecutionReports()
+    : m_outboxes_{std::make_unique<Outbox[]>(kMaxSessions)} {
+  // as many as the engine can hold
+  m_routes_.reserve(1 << 19);
+}
+
+void ExecutionReports::Accepted(uint64_t session, const Order& order) {
+  m_routes_.insert_or_assign(order.Id(), Route{session, order.Quantity()});
+
+  Report(session, kAccepted, order.Id(), order.Price(), order.Quantity(),
+         order.Quantity());
+}
+
+void ExecutionReports::Rejected(uint64_t session, const Order& order) {
+  Report(session, kRejected, order.Id(), order.Price(), order.Quantity(), 0);
+}
+
+void ExecutionReports::Cancelled(uint64_t session,
+                                 const Order& order,
+                                 Quantity_t quantity) {
+  // unknown or already done
+  if (quantity == 0) {
+    Report(session, kRejected, order.Id(), order.Price(), 0, 0);
+    return;
+  }
+
+  m_routes_.erase(order.Id());
+  Report(session, kCancelled, order.Id(), order.Price(), quantity, 0);
+}
+
+bool ExecutionReports::MayCancel(uint64_t session, const Order& order) const {
+  const auto route = m_routes_.find(order.Id());
+  return route == std::end(m_routes_) or route->second.Session == session;
+}
+
+void ExecutionReports::Filled(const TradeResult& trade_result) {
+  Fill(trade_result.BuyId, trade_result.BuyPrice, trade_result.Quantity);
+  Fill(trade_result.SellId, trade_result.SellPrice, trade_result.Quantity);
+}
+
+void ExecutionReports::Fill(ID_t id, Price_t price, Quantity_t quantity) {
+  const auto route = m_routes_.find(id);
+
+  // e.g. resting since before reports were turned on
+  if (route == std::end(m_routes_)) [[unlikely]] {
+    return;
+  }
+
+  const uint64_t session = route->second.Session;
+  const Quantity_t leaves_quantity =
+      route->second.LeavesQuantity - std::min(quantity,
+                                              route->second.LeavesQuantity);
+
+  if (leaves_quantity == 0) {
+    m_routes_.erase(route);
+    Report(session, kFilled, id, price, quantity, 0);
+  } else {
+    route->second.LeavesQuantity = leaves_quantity;
+    Report(session, kPartiallyFilled, id, price, quantity, leaves_quantity);
+  }
+}
+
+void ExecutionReports::Report(uint64_t session,
+                              ExecType exec_type,
+                              ID_t id,
+                              Price_t price,
+                              Quantity_t quantity,
+                              Quantity_t leaves_quantity) {
+  ExecutionReport* report = Reserve(session);
+
+  if (report == nullptr) [[unlikely]] {
+    return;
+  }
+
+  report->ExecType = exec_type;
+  report->Id = id;
+  report->Price = price;
+  report->Quantity = quantity;
+  report->LeavesQuantity = leaves_quantity;
+}
+
+ExecutionReport* ExecutionReports::Reserve(uint64_t session) {
+  const uint32_t index = session & UINT32_MAX;
+  assert(index < kMaxSessions);
+
+  Outbox& outbox = m_outboxes_[index];
+
+  // the generation in the upper half orders sessions on the same slot
+  if (session < outbox.Session) [[unlikely]] {
+    return nullptr;
+  }
+
+  if (session > outbox.Session) [[unlikely]] {
+    // whatever was left for the earlier session is dropped
+    outbox.Session = session;
+    outbox.Sent = outbox.Written;
+    outbox.Overflowed = false;
+  }
+
+  if (!outbox.Dirty) {
+    outbox.Dirty = true;
+    m_dirty_[m_dirty_count_++] = index;
+  }
+
+  if (outbox.Written - outbox.Sent + sizeof(ExecutionReport) > kOutboxLen)
+      [[unlikely]] {
+    outbox.Overflowed = true;
+    return nullptr;
+  }
+
+  union {
+    uint8_t* raw;
+    ExecutionReport* report;
+  } slot;
+
+  slot.raw = outbox.Ring.Data() + outbox.Written % kOutboxLen;
+  outbox.Written += sizeof(ExecutionReport);
+
+  return slot.report;
+}
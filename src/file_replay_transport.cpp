@@ -0,0 +1,7 @@
+#include "file_replay_transport.h"
+#include "order_file.h"
+
+FileReplayTransport::FileReplayTransport(std::string_view path)
+    : m_file_{path},
+      m_records_{OrderFileRecords(m_file_.Data())},
+      m_remaining_{m_records_} {}
@@ -0,0 +1,181 @@
+#include "fix.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+int64_t FixMessageLength(std::span<const uint8_t> buffer) {
+  const uint64_t prefix = std::min(buffer.size(), kFixBegin.size());
+  if (std::memcmp(buffer.data(), kFixBegin.data(), prefix) != 0) {
+    return -1;
+  }
+
+  // 9=, at least one digit and its SOH
+  if (buffer.size() < kFixBegin.size() + 4) {
+    return 0;
+  }
+
+  const uint8_t* length_field = buffer.data() + kFixBegin.size();
+  if (length_field[0] != '9' or length_field[1] != '=') {
+    return -1;
+  }
+
+  uint64_t body_len = 0;
+  uint32_t i = 2;
+  for (; kFixBegin.size() + i < buffer.size() and length_field[i] != kSoh;
+       ++i) {
+    if (length_field[i] < '0' or length_field[i] > '9' or i > 8) {
+      return -1;
+    }
+    body_len = body_len * 10 + (length_field[i] - '0');
+  }
+
+  if (kFixBegin.size() + i == buffer.size()) {
+    return 0;
+  }
+  if (i == 2) {
+    return -1;
+  }
+
+  const uint64_t len = kFixBegin.size() + i + 1 + body_len + kFixTrailerLen;
+  if (buffer.size() < len) {
+    return 0;
+  }
+
+  const uint8_t* trailer = buffer.data() + len - kFixTrailerLen;
+  if (std::memcmp(trailer, "10=", 3) != 0 or trailer[6] != kSoh) {
+    return -1;
+  }
+  return len;
+}
+
+uint8_t FixChecksum(std::span<const uint8_t> buffer) {
+  const uint8_t* data = buffer.data();
+  const uint64_t len = buffer.size();
+
+  // sums of eight bytes each in both halves
+  __m128i sums = _mm_setzero_si128();
+  uint64_t i = 0;
+  for (; i + 16 <= len; i += 16) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    sums = _mm_add_epi64(sums, _mm_sad_epu8(chunk, _mm_setzero_si128()));
+  }
+
+  uint64_t sum = _mm_cvtsi128_si64(sums) +
+                 _mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums));
+  for (; i < len; ++i) {
+    sum += data[i];
+  }
+  return sum % 256;
+}
+
+std::span<const uint8_t> FixBody(std::span<const uint8_t> message) {
+  const uint64_t end = message.size() - kFixTrailerLen;
+  const uint8_t* trailer = message.data() + end + 3;
+
+  const uint32_t expected = (trailer[0] - '0') * 100 +
+                            (trailer[1] - '0') * 10 + (trailer[2] - '0');
+  if (FixChecksum(message.first(end)) != expected) {
+    return {};
+  }
+
+  // past 9=...SOH
+  const uint8_t* body = static_cast<const uint8_t*>(std::memchr(
+      message.data() + kFixBegin.size(), kSoh, end - kFixBegin.size()));
+  ++body;
+
+  return {body, message.data() + end};
+}
+
+bool ParseFixUint(std::string_view text, uint64_t& value) {
+  if (text.empty() or text.size() > 20) {
+    return false;
+  }
+
+  value = 0;
+  for (const char c : text) {
+    const uint8_t digit = c - '0';
+    if (digit > 9 or __builtin_mul_overflow(value, 10, &value) or
+        __builtin_add_overflow(value, digit, &value)) [[unlikely]] {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ParseFixWholePrice(std::string_view text, uint64_t& value) {
+  const uint64_t point = text.find('.');
+  if (point == std::string_view::npos) {
+    return ParseFixUint(text, value);
+  }
+
+  for (const char c : text.substr(point + 1)) {
+    if (c != '0') {
+      return false;
+    }
+  }
+  return ParseFixUint(text.substr(0, point), value);
+}
+
+FixWriter& FixWriter::Add(uint32_t tag, std::string_view value) {
+  char tag_text[12];
+  const auto tag_end = std::to_chars(tag_text, tag_text + 10, tag).ptr;
+  *tag_end = '=';
+
+  const std::string_view tag_prefix{
+      tag_text, static_cast<uint64_t>(tag_end + 1 - tag_text)};
+
+  // a field which does not fit is left out whole, never cut short
+  if (m_len_ + tag_prefix.size() + value.size() + 1 > kMaxBodyLen)
+      [[unlikely]] {
+    ++m_dropped_count_;
+    return *this;
+  }
+
+  Append(tag_prefix);
+  Append(value);
+  Append({&kSoh, 1});
+  return *this;
+}
+
+FixWriter& FixWriter::Add(uint32_t tag, uint64_t value) {
+  char text[20];
+  const auto end = std::to_chars(text, text + sizeof(text), value).ptr;
+  return Add(tag, std::string_view{text, static_cast<uint64_t>(end - text)});
+}
+
+void FixWriter::Append(std::string_view text) {
+  std::memcpy(m_body_ + m_len_, text.data(), text.size());
+  m_len_ += text.size();
+}
+
+uint32_t FixWriter::Finish(uint8_t* out) {
+  uint8_t* cursor = out;
+
+  std::memcpy(cursor, kFixBegin.data(), kFixBegin.size());
+  cursor += kFixBegin.size();
+
+  *cursor++ = '9';
+  *cursor++ = '=';
+  cursor = reinterpret_cast<uint8_t*>(std::to_chars(
+                reinterpret_cast<char*>(cursor),
+                reinterpret_cast<char*>(cursor) + 10, m_len_)
+                                          .ptr);
+  *cursor++ = kSoh;
+
+  std::memcpy(cursor, m_body_, m_len_);
+  cursor += m_len_;
+
+  const uint8_t checksum = FixChecksum({out, cursor});
+  *cursor++ = '1';
+  *cursor++ = '0';
+  *cursor++ = '=';
+  *cursor++ = '0' + checksum / 100;
+  *cursor++ = '0' + checksum / 10 % 10;
+  *cursor++ = '0' + checksum % 10;
+  *cursor++ = kSoh;
+
+  const uint32_t len = cursor - out;
+  m_len_ = 0;
+  return len;
+}
@@ -0,0 +1,531 @@
+#include "fix_transport.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <new>
+#include <utility>
+
+namespace {
+template <uint64_t N>
+void CopyField(std::array<char, N>& field,
+               uint8_t& len,
+               std::string_view value) {
+  len = std::min<uint64_t>(value.size(), N);
+  std::copy_n(value.data(), len, field.data());
+}
+
+// a value of theirs sent back in an answer, cut short so every answer
+// fits the writer whatever they sent
+std::string_view Echo(std::string_view value) {
+  constexpr uint64_t kMaxEchoLen = 64;
+  return value.substr(0, kMaxEchoLen);
+}
+
+// a number as text in buffer, for fields taking an id as a string
+std::string_view ToText(uint64_t value, char (&buffer)[20]) {
+  const auto end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+  return {buffer, static_cast<uint64_t>(end - buffer)};
+}
+}  // namespace
+
+FixTransport::FixTransport(std::string host, uint16_t port)
+    : m_sessions_{std::move(host), port},
+      m_batch_{std::make_unique<uint8_t[]>(kBatchOrders * sizeof(Order))} {
+  m_orders_.reserve(1 << 19);
+}
+
+int64_t FixTransport::Send(uint64_t session, std::span<const uint8_t> reports) {
+  Session* target = Find(session);
+  if (target == nullptr) {
+    return -1;
+  }
+
+  FlushOutbox(*target);
+
+  uint64_t taken = 0;
+  while (target->Open and
+         reports.size() - taken >= sizeof(ExecutionReport) and
+         HasRoom(*target)) {
+    ExecutionReport report;
+    std::memcpy(&report, reports.data() + taken, sizeof(report));
+
+    Report(*target, report);
+    taken += sizeof(ExecutionReport);
+  }
+
+  FlushOutbox(*target);
+  return target->Open ? static_cast<int64_t>(taken) : -1;
+}
+
+void FixTransport::Disconnect(uint64_t session) {
+  if (Session* target = Find(session)) {
+    std::cout << "disconnecting fix session " << (session & UINT32_MAX)
+              << '\n';
+    CloseSession(*target);
+  }
+}
+
+FixTransport::Session* FixTransport::Find(uint64_t session) {
+  const int64_t index = m_sessions_.Find(session);
+  return index < 0 ? nullptr : &m_sessions_[index];
+}
+
+void FixTransport::Session::Reset() {
+  LoggedOn = false;
+  LoggingOut = false;
+  Written = 0;
+  Sent = 0;
+  NextSeqNum = 1;
+  NextExecId = 1;
+  SymbolLen = 0;
+}
+
+bool FixTransport::ReadOnce(Session& session) {
+  // a full ring holds no whole message, it never will, so it ends too
+  switch (m_sessions_.ReadOnce(Index(session))) {
+    case TcpSessions<Session>::kRead:
+      return true;
+    case TcpSessions<Session>::kEnded:
+      CloseSession(session);
+      return false;
+    default:
+      return false;
+  }
+}
+
+void FixTransport::CloseSession(Session& session) {
+  const uint32_t index = Index(session);
+  const uint64_t key = Key(index);
+
+  m_sessions_.Close(index);
+
+  // their reports have nowhere to go any more
+  std::erase_if(m_orders_, [key](const auto& entry) {
+    return entry.second.Session == key;
+  });
+}
+
+std::span<const uint8_t> FixTransport::Translate(uint32_t index, bool& more) {
+  Session& session = m_sessions_[index];
+
+  m_batch_count_ = 0;
+  more = false;
+
+  while (session.Open and !session.LoggingOut) {
+    if (m_batch_count_ == kBatchOrders) {
+      more = true;
+      break;
+    }
+
+    if (!HasRoom(session)) {
+      FlushOutbox(session);
+
+      if (!HasRoom(session)) {
+        std::cout << "fix session " << index << " does not read, closing"
+                  << '\n';
+        CloseSession(session);
+        break;
+      }
+    }
+
+    const std::span<const uint8_t> pending{
+        session.Ring.Data() + session.Delivered % kRingLen,
+        session.Received - session.Delivered};
+
+    const int64_t len = FixMessageLength(pending);
+    if (len == 0) {
+      break;
+    }
+
+    if (len < 0) [[unlikely]] {
+      std::cout << "garbled fix message on session " << index << ", closing"
+                << '\n';
+      CloseSession(session);
+      break;
+    }
+
+    const std::span<const uint8_t> body = FixBody(pending.first(len));
+    session.Delivered += len;
+
+    // a bad checksum is dropped, as the protocol asks
+    if (body.empty()) [[unlikely]] {
+      continue;
+    }
+
+    Fields fields;
+    const bool parsed = ForEachFixField(
+        body, [&fields](uint32_t tag, std::string_view value) {
+          switch (tag) {
+            case kFixMsgType:
+              fields.MsgType = value;
+              break;
+            case kFixSenderCompId:
+              fields.SenderCompId = value;
+              break;
+            case kFixTargetCompId:
+              fields.TargetCompId = value;
+              break;
+            case kFixClOrdId:
+              fields.ClOrdId = value;
+              break;
+            case kFixOrigClOrdId:
+              fields.OrigClOrdId = value;
+              break;
+            case kFixSymbol:
+              fields.Symbol = value;
+              break;
+            case kFixSide:
+              fields.Side = value;
+              break;
+            case kFixOrderQty:
+              fields.OrderQty = value;
+              break;
+            case kFixOrdType:
+              fields.OrdType = value;
+              break;
+            case kFixPrice:
+              fields.Price = value;
+              break;
+            case kFixTestReqId:
+              fields.TestReqId = value;
+              break;
+            case kFixHeartBtInt:
+              fields.HeartBtInt = value;
+              break;
+            default:
+              break;
+          }
+        });
+
+    if (parsed) [[likely]] {
+      OnMessage(index, fields);
+    }
+  }
+
+  return {m_batch_.get(), m_batch_count_ * sizeof(Order)};
+}
+
+void FixTransport::OnMessage(uint32_t index, const Fields& fields) {
+  Session& session = m_sessions_[index];
+
+  // every message handled here has a one character type
+  if (fields.MsgType.size() != 1) {
+    return;
+  }
+
+  const char msg_type = fields.MsgType[0];
+
+  if (msg_type == 'A') {
+    CopyField(session.SenderCompId, session.SenderCompIdLen,
+              fields.SenderCompId);
+    CopyField(session.TargetCompId, session.TargetCompIdLen,
+              fields.TargetCompId);
+    session.LoggedOn = true;
+
+    Begin(session, 'A')
+        .Add(kFixEncryptMethod, uint64_t{0})
+        .Add(kFixHeartBtInt,
+             fields.HeartBtInt.empty() ? "30" : Echo(fields.HeartBtInt));
+    Finish(session);
+    return;
+  }
+
+  if (!session.LoggedOn) [[unlikely]] {
+    std::cout << "fix session " << index << " did not log on, closing"
+              << '\n';
+    CloseSession(session);
+    return;
+  }
+
+  switch (msg_type) {
+    case 'D':
+      OnNewOrder(index, fields);
+      break;
+    case 'F':
+      OnCancel(index, fields);
+      break;
+    case '1':
+      Begin(session, '0').Add(kFixTestReqId, Echo(fields.TestReqId));
+      Finish(session);
+      break;
+    case '5':
+      Begin(session, '5');
+      Finish(session);
+      session.LoggingOut = true;
+      break;
+    default:
+      // heartbeats and anything not supported
+      break;
+  }
+}
+
+void FixTransport::OnNewOrder(uint32_t index, const Fields& fields) {
+  Session& session = m_sessions_[index];
+
+  uint64_t id;
+  uint64_t quantity;
+  uint64_t price;
+
+  if (!ParseFixUint(fields.ClOrdId, id)) [[unlikely]] {
+    Reject(session, fields, "ClOrdID is not a number");
+    return;
+  }
+  if (fields.Side != "1" and fields.Side != "2") [[unlikely]] {
+    Reject(session, fields, "unsupported Side");
+    return;
+  }
+  if (fields.OrdType != "2") [[unlikely]] {
+    Reject(session, fields, "only limit orders are supported");
+    return;
+  }
+  if (!ParseFixUint(fields.OrderQty, quantity) or quantity == 0 or
+      quantity > UINT16_MAX) [[unlikely]] {
+    Reject(session, fields, "OrderQty out of range");
+    return;
+  }
+  if (!ParseFixWholePrice(fields.Price, price) or price > UINT16_MAX)
+      [[unlikely]] {
+    Reject(session, fields, "Price out of range");
+    return;
+  }
+
+  const auto [order, inserted] = m_orders_.try_emplace(
+      id, LiveOrder{.Session = Key(index),
+                    .Price = static_cast<Price_t>(price),
+                    .OrderQuantity = static_cast<Quantity_t>(quantity),
+                    .Side = fields.Side[0]});
+  if (!inserted) [[unlikely]] {
+    Reject(session, fields, "duplicate ClOrdID");
+    return;
+  }
+
+  CopyField(session.Symbol, session.SymbolLen, fields.Symbol);
+
+  new (m_batch_.get() + m_batch_count_++ * sizeof(Order))
+      Order(fields.Side[0] == '1' ? kBuy : kSell, id,
+            static_cast<Price_t>(price), static_cast<Quantity_t>(quantity));
+}
+
+void FixTransport::OnCancel(uint32_t index, const Fields& fields) {
+  Session& session = m_sessions_[index];
+
+  uint64_t cancel_id;
+  uint64_t orig_id;
+
+  if (!ParseFixUint(fields.ClOrdId, cancel_id) or
+      !ParseFixUint(fields.OrigClOrdId, orig_id)) [[unlikely]] {
+    CancelReject(session, fields.ClOrdId, fields.OrigClOrdId, '8');
+    return;
+  }
+
+  const auto order = m_orders_.find(orig_id);
+
+  // unknown, someone else's, done or already being cancelled
+  if (order == std::end(m_orders_) or order->second.Session != Key(index) or
+      order->second.Done or order->second.CancelPending) [[unlikely]] {
+    CancelReject(session, fields.ClOrdId, fields.OrigClOrdId, '8');
+    return;
+  }
+
+  order->second.CancelPending = true;
+  order->second.CancelClOrdId = cancel_id;
+
+  new (m_batch_.get() + m_batch_count_++ * sizeof(Order))
+      CancelOrder(orig_id, order->second.Price);
+}
+
+bool FixTransport::HasRoom(const Session& session) const {
+  return kOutboxLen - (session.Written - session.Sent) >=
+         FixWriter::kMaxMessageLen;
+}
+
+FixWriter& FixTransport::Begin(Session& session, char msg_type) {
+  return m_writer_.Add(kFixMsgType, msg_type)
+      .Add(kFixSenderCompId, std::string_view{session.TargetCompId.data(),
+                                              session.TargetCompIdLen})
+      .Add(kFixTargetCompId, std::string_view{session.SenderCompId.data(),
+                                              session.SenderCompIdLen})
+      .Add(kFixMsgSeqNum, session.NextSeqNum++)
+      .Add(kFixSendingTime, SendingTime());
+}
+
+void FixTransport::Finish(Session& session) {
+  // contiguous even across the wrap, the second mapping continues it
+  session.Written += m_writer_.Finish(session.Outbox.Data() +
+                                      session.Written % kOutboxLen);
+}
+
+void FixTransport::FlushOutbox(Session& session) {
+  if (!session.Open) {
+    return;
+  }
+
+  if (session.Written > session.Sent) {
+    const int byte_sent =
+        session.Sock.Send({session.Outbox.Data() + session.Sent % kOutboxLen,
+                           session.Written - session.Sent});
+
+    if (byte_sent < 0 and (errno == EAGAIN or errno == EWOULDBLOCK)) {
+      return;
+    }
+
+    if (byte_sent < 0) [[unlikely]] {
+      CloseSession(session);
+      return;
+    }
+    session.Sent += byte_sent;
+  }
+
+  if (session.LoggingOut and session.Sent == session.Written) {
+    CloseSession(session);
+  }
+}
+
+void FixTransport::Reject(Session& session,
+                          const Fields& fields,
+                          std::string_view text) {
+  Begin(session, '8')
+      .Add(kFixOrderId, "NONE")
+      .Add(kFixClOrdId, Echo(fields.ClOrdId))
+      .Add(kFixExecId, session.NextExecId++)
+      .Add(kFixExecType, '8')
+      .Add(kFixOrdStatus, '8')
+      .Add(kFixSymbol, Echo(fields.Symbol))
+      .Add(kFixSide, Echo(fields.Side))
+      .Add(kFixLeavesQty, uint64_t{0})
+      .Add(kFixCumQty, uint64_t{0})
+      .Add(kFixAvgPx, uint64_t{0})
+      .Add(kFixText, text);
+  Finish(session);
+}
+
+void FixTransport::CancelReject(Session& session,
+                                std::string_view cl_ord_id,
+                                std::string_view orig_cl_ord_id,
+                                char ord_status) {
+  Begin(session, '9')
+      .Add(kFixOrderId, Echo(orig_cl_ord_id))
+      .Add(kFixClOrdId, Echo(cl_ord_id))
+      .Add(kFixOrigClOrdId, Echo(orig_cl_ord_id))
+      .Add(kFixOrdStatus, ord_status)
+      // to an order cancel request, the order is unknown or done
+      .Add(kFixCxlRejResponseTo, '1')
+      .Add(kFixCxlRejReason, '1');
+  Finish(session);
+}
+
+FixWriter& FixTransport::BeginReport(Session& session,
+                                     ID_t id,
+                                     ID_t cl_ord_id,
+                                     const LiveOrder& order,
+                                     char exec_type,
+                                     char ord_status,
+                                     Quantity_t leaves_quantity) {
+  const uint64_t avg_price =
+      order.CumQuantity == 0 ? 0 : order.Notional / order.CumQuantity;
+
+  return Begin(session, '8')
+      .Add(kFixOrderId, id)
+      .Add(kFixClOrdId, cl_ord_id)
+      .Add(kFixExecId, session.NextExecId++)
+      .Add(kFixExecType, exec_type)
+      .Add(kFixOrdStatus, ord_status)
+      .Add(kFixSymbol,
+           std::string_view{session.Symbol.data(), session.SymbolLen})
+      .Add(kFixSide, order.Side)
+      .Add(kFixOrderQty, uint64_t{order.OrderQuantity})
+      .Add(kFixPrice, uint64_t{order.Price})
+      .Add(kFixLeavesQty, uint64_t{leaves_quantity})
+      .Add(kFixCumQty, uint64_t{order.CumQuantity})
+      .Add(kFixAvgPx, avg_price);
+}
+
+void FixTransport::Report(Session& session, const ExecutionReport& report) {
+  const auto entry = m_orders_.find(report.Id);
+
+  if (entry == std::end(m_orders_)) [[unlikely]] {
+    return;
+  }
+
+  const ID_t id = entry->first;
+  LiveOrder& order = entry->second;
+
+  switch (report.ExecType) {
+    case kAccepted:
+      BeginReport(session, id, id, order, '0', '0', report.LeavesQuantity);
+      Finish(session);
+      return;
+
+    case kPartiallyFilled:
+    case kFilled: {
+      order.CumQuantity += report.Quantity;
+      order.Notional += uint64_t{report.Quantity} * report.Price;
+
+      const bool filled = report.ExecType == kFilled;
+      BeginReport(session, id, id, order, 'F', filled ? '2' : '1',
+                  report.LeavesQuantity)
+          .Add(kFixLastQty, uint64_t{report.Quantity})
+          .Add(kFixLastPx, uint64_t{report.Price});
+      Finish(session);
+
+      if (filled) {
+        // a cancel on its way still needs its answer
+        if (order.CancelPending) {
+          order.Done = true;
+        } else {
+          m_orders_.erase(entry);
+        }
+      }
+      return;
+    }
+
+    case kCancelled:
+      BeginReport(session, id, order.CancelClOrdId, order, '4', '4', 0)
+          .Add(kFixOrigClOrdId, id);
+      Finish(session);
+      m_orders_.erase(entry);
+      return;
+
+    case kRejected:
+      if (order.CancelPending) {
+        char cancel_id[20];
+        char orig_id[20];
+        const char ord_status =
+            order.Done ? '2' : (order.CumQuantity > 0 ? '1' : '0');
+
+        CancelReject(session, ToText(order.CancelClOrdId, cancel_id),
+                     ToText(id, orig_id), ord_status);
+        order.CancelPending = false;
+
+        if (order.Done) {
+          m_orders_.erase(entry);
+        }
+        return;
+      }
+
+      BeginReport(session, id, id, order, '8', '8', 0);
+      Finish(session);
+      m_orders_.erase(entry);
+      return;
+
+    default:
+      return;
+  }
+}
+
+std::string_view FixTransport::SendingTime() {
+  timespec now;
+  ::clock_gettime(CLOCK_REALTIME, &now);
+
+  if (now.tv_sec != m_time_second_) {
+    tm utc;
+    ::gmtime_r(&now.tv_sec, &utc);
+    std::strftime(m_time_text_, sizeof(m_time_text_), "%Y%m%d-%H:%M:%S",
+                  &utc);
+    m_time_second_ = now.tv_sec;
+  }
+  return {m_time_text_, sizeof(m_time_text_) - 1};
+}
@@ -1,24 +1,79 @@
 #include "heap_based_engine.h"
 #include <algorithm>
+#include <bitset>
 #include <iostream>
 #include <ranges>
+#include "state_hash.h"
 
 namespace {
 static const auto kBuyComp = std::less{};
 static const auto kSellComp = std::greater{};
+
+// restores the heap after the element at `index` has been replaced
+template <class T, class Comp>
+void RestoreHeapAt(std::span<T> heap, uint32_t index, Comp comp) {
+  const uint32_t start = index;
+
+  while (index > 0) {
+    const uint32_t parent = (index - 1) / 2;
+    if (!comp(heap[parent], heap[index])) {
+      break;
+    }
+    std::swap(heap[parent], heap[index]);
+    index = parent;
+  }
+
+  if (index != start) {
+    return;
+  }
+
+  while (1) {
+    const uint32_t left = 2 * index + 1;
+    const uint32_t right = left + 1;
+    uint32_t top = index;
+
+    if (left < heap.size() and comp(heap[top], heap[left])) {
+      top = left;
+    }
+    if (right < heap.size() and comp(heap[top], heap[right])) {
+      top = right;
+    }
+    if (top == index) {
+      break;
+    }
+    std::swap(heap[top], heap[index]);
+    index = top;
+  }
+}
+
+// counts the comparisons a heap operation makes, one per sift step
+template <class Comp>
+auto Counted(Comp comp, uint64_t& steps) {
+  return [comp, &steps](const auto& lhs, const auto& rhs) {
+    ++steps;
+    return comp(lhs, rhs);
+  };
+}
 }  // namespace
 
 HeapBasedEngine::HeapBasedEngine() : m_buy_count_{0}, m_sell_count_{0} {
-  m_buy_caches_ =
-      std::span<Item>(reinterpret_cast<Item*>(m_caches_), kMaxOrders);
+  BindCaches();
 
   std::ranges::fill(std::begin(m_buy_caches_), std::end(m_buy_caches_), Item{});
+  std::ranges::fill(std::begin(m_sell_caches_), std::end(m_sell_caches_),
+                    Item{});
+}
+
+void HeapBasedEngine::Reattach() noexcept {
+  BindCaches();
+}
+
+void HeapBasedEngine::BindCaches() noexcept {
+  m_buy_caches_ =
+      std::span<Item>(reinterpret_cast<Item*>(m_caches_), kMaxOrders);
 
   m_sell_caches_ =
       std::span<Item>(m_buy_caches_.data() + m_buy_caches_.size(), kMaxOrders);
-
-  std::ranges::fill(std::begin(m_sell_caches_), std::end(m_sell_caches_),
-                    Item{});
 }
 
 void HeapBasedEngine::AddOrder(BuyOrder order) noexcept {
@@ -27,6 +82,9 @@ void HeapBasedEngine::AddOrder(BuyOrder order) noexcept {
     return;
   }
 
+  const auto buy_comp = Counted(kBuyComp, m_stats_.SiftSteps);
+  ++m_stats_.AddOrders;
+
   Item& cache = m_buy_caches_[m_buy_count_++];
 
   cache.Price = order.Price();
@@ -34,8 +92,10 @@ void HeapBasedEngine::AddOrder(BuyOrder order) noexcept {
   cache.Id = order.Id();
   cache.Quantity = order.Quantity();
 
+  m_state_hash_ ^= OrderHash(kBuy, cache.Id, cache.Price, cache.Quantity);
+
   std::ranges::push_heap(std::begin(m_buy_caches_),
-                         std::begin(m_buy_caches_) + m_buy_count_, kBuyComp);
+                         std::begin(m_buy_caches_) + m_buy_count_, buy_comp);
 }
 
 void HeapBasedEngine::AddOrder(SellOrder order) noexcept {
@@ -44,6 +104,9 @@ void HeapBasedEngine::AddOrder(SellOrder order) noexcept {
     return;
   }
 
+  const auto sell_comp = Counted(kSellComp, m_stats_.SiftSteps);
+  ++m_stats_.AddOrders;
+
   Item& cache = m_sell_caches_[m_sell_count_++];
 
   cache.Price = order.Price();
@@ -51,18 +114,74 @@ void HeapBasedEngine::AddOrder(SellOrder order) noexcept {
   cache.Id = order.Id();
   cache.Quantity = order.Quantity();
 
+  m_state_hash_ ^= OrderHash(kSell, cache.Id, cache.Price, cache.Quantity);
+
   std::ranges::push_heap(std::begin(m_sell_caches_),
-                         std::begin(m_sell_caches_) + m_sell_count_, kSellComp);
+                         std::begin(m_sell_caches_) + m_sell_count_, sell_comp);
+}
+
+/**
+ * the heap cannot be searched by price, so a cancel is a linear scan, the
+ * last element then takes the slot of the cancelled one and is sifted
+ */
+Quantity_t HeapBasedEngine::Cancel(CancelOrder order) noexcept {
+  const auto buy_comp = Counted(kBuyComp, m_stats_.SiftSteps);
+  const auto sell_comp = Counted(kSellComp, m_stats_.SiftSteps);
+  ++m_stats_.Cancels;
+
+  const Quantity_t quantity = CancelAt(order.Id(), order.Price(), kBuy,
+                                       m_buy_count_, m_buy_caches_, buy_comp);
+
+  if (quantity > 0) {
+    return quantity;
+  }
+
+  return CancelAt(order.Id(), order.Price(), kSell, m_sell_count_,
+                  m_sell_caches_, sell_comp);
+}
+
+Quantity_t HeapBasedEngine::CancelAt(ID_t id,
+                                     Price_t price,
+                                     OrderType_t order_type,
+                                     uint32_t& count,
+                                     std::span<Item> caches,
+                                     auto&& comp) noexcept {
+  const auto found = std::ranges::find_if(
+      std::begin(caches), std::begin(caches) + count,
+      [id, price](const Item& item) {
+        return item.Id == id and item.Price == price;
+      });
+
+  if (found == std::begin(caches) + count) {
+    return 0;
+  }
+
+  const uint32_t index = std::distance(std::begin(caches), found);
+  const Quantity_t quantity = found->Quantity;
+
+  m_state_hash_ ^= OrderHash(order_type, id, price, quantity);
+
+  --count;
+
+  if (index != count) {
+    caches[index] = caches[count];
+    RestoreHeapAt(caches.first(count), index, comp);
+  }
+
+  return quantity;
 }
 
 std::vector<TradeResult> HeapBasedEngine::Execute() noexcept {
+  const auto buy_comp = Counted(kBuyComp, m_stats_.SiftSteps);
+  const auto sell_comp = Counted(kSellComp, m_stats_.SiftSteps);
+
   std::vector<TradeResult> results;
 
   std::ranges::pop_heap(std::begin(m_buy_caches_),
-                        std::begin(m_buy_caches_) + m_buy_count_, kBuyComp);
+                        std::begin(m_buy_caches_) + m_buy_count_, buy_comp);
 
   std::ranges::pop_heap(std::begin(m_sell_caches_),
-                        std::begin(m_sell_caches_) + m_sell_count_, kSellComp);
+                        std::begin(m_sell_caches_) + m_sell_count_, sell_comp);
 
   while (m_buy_count_ > 0 and m_sell_count_ > 0) {
     const uint32_t b_i = m_buy_count_ - 1;
@@ -83,6 +202,10 @@ std::vector<TradeResult> HeapBasedEngine::Execute() noexcept {
                                      .SellPrice = sell.Price,
                                      .Quantity = min_quantity});
 
+    m_state_hash_ ^=
+        FillHash(kBuy, buy.Id, buy.Price, buy.Quantity, min_quantity) ^
+        FillHash(kSell, sell.Id, sell.Price, sell.Quantity, min_quantity);
+
     buy.Quantity -= min_quantity;
     sell.Quantity -= min_quantity;
 
@@ -90,7 +213,7 @@ std::vector<TradeResult> HeapBasedEngine::Execute() noexcept {
       --m_buy_count_;
 
       std::ranges::pop_heap(std::begin(m_buy_caches_),
-                            std::begin(m_buy_caches_) + m_buy_count_, kBuyComp);
+                            std::begin(m_buy_caches_) + m_buy_count_, buy_comp);
     }
 
     if (sell.Quantity == 0) {
@@ -98,7 +221,7 @@ std::vector<TradeResult> HeapBasedEngine::Execute() noexcept {
 
       std::ranges::pop_heap(std::begin(m_sell_caches_),
                             std::begin(m_sell_caches_) + m_sell_count_,
-                            kSellComp);
+                            sell_comp);
     }
   }
 
@@ -106,14 +229,36 @@ std::vector<TradeResult> HeapBasedEngine::Execute() noexcept {
 
   if (m_buy_count_ > 0) {
     std::ranges::push_heap(std::begin(m_buy_caches_),
-                           std::begin(m_buy_caches_) + m_buy_count_, kBuyComp);
+                           std::begin(m_buy_caches_) + m_buy_count_, buy_comp);
   }
 
   if (m_sell_count_ > 0) {
     std::ranges::push_heap(std::begin(m_sell_caches_),
                            std::begin(m_sell_caches_) + m_sell_count_,
-                           kSellComp);
+                           sell_comp);
   }
 
+  ++m_stats_.Executes;
+  m_stats_.Trades += results.size();
+
   return results;
 }
+
+EngineStats HeapBasedEngine::Stats() const noexcept {
+  auto count_levels = [](std::span<const Item> items) {
+    std::bitset<std::numeric_limits<Price_t>::max() + 1> seen;
+    for (const Item& item : items) {
+      seen.set(item.Price);
+    }
+    return static_cast<uint32_t>(seen.count());
+  };
+
+  EngineStats stats = m_stats_;
+
+  stats.BuyDepth = m_buy_count_;
+  stats.SellDepth = m_sell_count_;
+  stats.BuyLevels = count_levels(m_buy_caches_.first(m_buy_count_));
+  stats.SellLevels = count_levels(m_sell_caches_.first(m_sell_count_));
+
+  return stats;
+}
@@ -0,0 +1,55 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+void LatencyHistogram::Reset() noexcept {
+  for (auto& count : Counts) {
+    count.store(0, std::memory_order_relaxed);
+  }
+  Sum.store(0, std::memory_order_relaxed);
+  Max.store(0, std::memory_order_relaxed);
+}
+
+LatencySummary Summarize(const LatencyHistogram& histogram,
+                         double ticks_per_ns) {
+  // a snapshot, the writer may be recording while it is taken
+  uint64_t counts[LatencyHistogram::kBucketCount];
+  uint64_t total = 0;
+
+  for (uint32_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+    counts[i] = histogram.Counts[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+
+  if (total == 0) {
+    return {};
+  }
+
+  const uint64_t max = histogram.Max.load(std::memory_order_relaxed);
+
+  // a bucket bound never exceeds the largest value actually recorded
+  auto percentile = [&](double fraction) -> uint64_t {
+    const uint64_t rank = std::max<uint64_t>(std::ceil(fraction * total), 1);
+    uint64_t seen = 0;
+
+    for (uint32_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+      seen += counts[i];
+      if (seen >= rank) {
+        return std::min(LatencyHistogram::BucketValue(i), max) / ticks_per_ns;
+      }
+    }
+    return 0;
+  };
+
+  const double sum = histogram.Sum.load(std::memory_order_relaxed);
+
+  return LatencySummary{
+      .Count = total,
+      .Mean = sum / total / ticks_per_ns,
+      .P50 = percentile(0.5),
+      .P90 = percentile(0.9),
+      .P99 = percentile(0.99),
+      .P999 = percentile(0.999),
+      .P9999 = percentile(0.9999),
+      .Max = static_cast<uint64_t>(max / ticks_per_ns)};
+}
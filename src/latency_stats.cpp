@@ -0,0 +1,77 @@
+#include "latency_stats.h"
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+std::string_view StageName(Stage stage) {
+  switch (stage) {
+    case Stage::kBatch:
+      return "batch";
+    case Stage::kAddOrder:
+      return "add_order";
+    case Stage::kCancel:
+      return "cancel";
+    case Stage::kExecute:
+      return "execute";
+    case Stage::kPublish:
+      return "publish";
+  }
+  return "";
+}
+
+LatencyStats::LatencyStats(std::string_view path)
+    : m_memory_{path, sizeof(Page)} {
+  m_page_ = std::launder(reinterpret_cast<Page*>(m_memory_.Address()));
+
+  // whichever of the engine or the tool comes first lays out the page
+  if (m_memory_.Created() or
+      m_page_->Magic.load(std::memory_order_acquire) == 0) {
+    m_page_ = new (m_memory_.Address()) Page();
+    m_page_->Version = kVersion;
+    m_page_->Magic.store(kMagic, std::memory_order_release);
+    return;
+  }
+
+  if (m_page_->Magic.load(std::memory_order_acquire) != kMagic or
+      m_page_->Version != kVersion) {
+    throw std::runtime_error("latency stats layout mismatch");
+  }
+}
+
+LatencySummary LatencyStats::Summary(Stage stage) const {
+  return Summarize(m_page_->Stages[static_cast<uint32_t>(stage)],
+                   m_page_->TicksPerNs.load(std::memory_order_relaxed));
+}
+
+void LatencyStats::PublishEngineStats(const EngineStats& stats) noexcept {
+  const uint64_t sequence =
+      m_page_->EngineSequence.load(std::memory_order_relaxed);
+
+  m_page_->EngineSequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  std::memcpy(&m_page_->Engine, &stats, sizeof(stats));
+
+  m_page_->EngineSequence.store(sequence + 2, std::memory_order_release);
+}
+
+EngineStats LatencyStats::EngineSnapshot() const {
+  EngineStats stats;
+
+  while (1) {
+    const uint64_t before =
+        m_page_->EngineSequence.load(std::memory_order_acquire);
+
+    std::memcpy(&stats, &m_page_->Engine, sizeof(stats));
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (before % 2 == 0 and
+        before == m_page_->EngineSequence.load(std::memory_order_relaxed)) {
+      return stats;
+    }
+  }
+}
+
+void LatencyStats::RequestReset() noexcept {
+  m_page_->ResetRequest.fetch_add(1, std::memory_order_release);
+}
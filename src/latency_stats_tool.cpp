@@ -0,0 +1,41 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "command_line.h"
+#include "latency_stats.h"
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0]
+              << " <latency stats file> [--reset] [--watch <seconds>]\n";
+    exit(-1);
+  }
+
+  LatencyStats stats(argv[1]);
+
+  if (HasFlag(argc, argv, "--reset")) {
+    stats.RequestReset();
+    std::cout << "reset requested, applied with the next batch" << '\n';
+    return 0;
+  }
+
+  const auto watch = FlagValue(argc, argv, "--watch");
+
+  while (1) {
+    for (uint32_t i = 0; i < kStageCount; ++i) {
+      const Stage stage = static_cast<Stage>(i);
+      std::cout << StageName(stage) << " (ns): " << stats.Summary(stage)
+                << '\n';
+    }
+    std::cout << "engine: " << stats.EngineSnapshot() << '\n';
+
+    if (watch.empty()) {
+      return 0;
+    }
+
+    std::this_thread::sleep_for(
+        std::chrono::seconds{std::stoul(std::string{watch})});
+    std::cout << '\n';
+  }
+}
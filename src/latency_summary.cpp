@@ -0,0 +1,38 @@
+#include "latency_summary.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+uint64_t Percentile(const std::vector<uint64_t>& sorted, double fraction) {
+  const uint64_t rank = std::ceil(fraction * sorted.size());
+  return sorted[std::max<uint64_t>(rank, 1) - 1];
+}
+}  // namespace
+
+LatencySummary Summarize(std::vector<uint64_t>& samples) {
+  if (samples.empty()) {
+    return {};
+  }
+
+  std::ranges::sort(samples);
+
+  const double total =
+      std::accumulate(std::begin(samples), std::end(samples), 0.0);
+
+  return LatencySummary{.Count = samples.size(),
+                        .Mean = total / samples.size(),
+                        .P50 = Percentile(samples, 0.5),
+                        .P90 = Percentile(samples, 0.9),
+                        .P99 = Percentile(samples, 0.99),
+                        .P999 = Percentile(samples, 0.999),
+                        .P9999 = Percentile(samples, 0.9999),
+                        .Max = samples.back()};
+}
+
+std::ostream& operator<<(std::ostream& os, const LatencySummary& summary) {
+  return os << "count: " << summary.Count << ", mean: " << summary.Mean
+            << ", p50: " << summary.P50 << ", p90: " << summary.P90
+            << ", p99: " << summary.P99 << ", p99.9: " << summary.P999
+            << ", p99.99: " << summary.P9999 << ", max: " << summary.Max;
+}
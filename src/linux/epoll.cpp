@@ -0,0 +1,45 @@
+#include "linux/epoll.h"
+#include <unistd.h>
+#include <cerrno>
+#include "error.h"
+
+Epoll::Epoll() {
+  m_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+
+  if (m_fd_ == -1) {
+    throw EpollCreateError();
+  }
+}
+
+Epoll::~Epoll() {
+  ::close(m_fd_);
+}
+
+void Epoll::Add(int fd, uint64_t tag, bool writable) {
+  epoll_event event;
+  event.events = EPOLLIN | EPOLLRDHUP | EPOLLET | (writable ? EPOLLOUT : 0);
+  event.data.u64 = tag;
+
+  if (::epoll_ctl(m_fd_, EPOLL_CTL_ADD, fd, &event) == -1) {
+    throw EpollCtlError();
+  }
+}
+
+void Epoll::Remove(int fd) {
+  if (::epoll_ctl(m_fd_, EPOLL_CTL_DEL, fd, nullptr) == -1) {
+    throw EpollCtlError();
+  }
+}
+
+int Epoll::Wait(std::span<epoll_event> events, int timeout_ms) {
+  const int count =
+      ::epoll_wait(m_fd_, events.data(), events.size(), timeout_ms);
+
+  if (count == -1) {
+    if (errno == EINTR) {
+      return 0;
+    }
+    throw EpollWaitError();
+  }
+  return count;
+}
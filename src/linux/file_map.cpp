@@ -0,0 +1,46 @@
+#include "linux/file_map.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string>
+#include "error.h"
+
+FileMap::FileMap(std::string_view path) {
+  const std::string file_path{path};
+
+  const int fd = ::open(file_path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw FileOpenError();
+  }
+
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) == -1) {
+    ::close(fd);
+    throw FileOpenError();
+  }
+
+  m_len_ = file_stat.st_size;
+
+  // mmap rejects an empty mapping, an empty file is just an empty span
+  if (m_len_ == 0) {
+    ::close(fd);
+    return;
+  }
+
+  void* address = ::mmap(nullptr, m_len_, PROT_READ,
+                         MAP_PRIVATE | MAP_POPULATE, fd, 0);
+  ::close(fd);
+
+  if (address == MAP_FAILED) {
+    throw MmapMapFailError();
+  }
+
+  m_address_ = reinterpret_cast<const uint8_t*>(address);
+}
+
+FileMap::~FileMap() {
+  if (m_address_ != nullptr) {
+    ::munmap(const_cast<uint8_t*>(m_address_), m_len_);
+  }
+}
@@ -0,0 +1,47 @@
+#include "linux/mirrored_buffer.h"
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cassert>
+#include "error.h"
+
+MirroredBuffer::MirroredBuffer(uint64_t len) : m_len_{len} {
+  assert(len % ::sysconf(_SC_PAGESIZE) == 0);
+
+  const int fd = ::memfd_create("mirrored_buffer", MFD_CLOEXEC);
+  if (fd == -1) {
+    throw MemfdCreateError();
+  }
+
+  if (::ftruncate(fd, len) == -1) {
+    ::close(fd);
+    throw SharedMemoryTruncateError();
+  }
+
+  // reserves the address range for both halves before mapping into it
+  void* reserved =
+      ::mmap(nullptr, 2 * len, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (reserved == MAP_FAILED) {
+    ::close(fd);
+    throw MmapMapFailError();
+  }
+
+  uint8_t* base = static_cast<uint8_t*>(reserved);
+
+  for (uint8_t* half : {base, base + len}) {
+    if (::mmap(half, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd,
+               0) == MAP_FAILED) {
+      ::munmap(base, 2 * len);
+      ::close(fd);
+      throw MmapMapFailError();
+    }
+  }
+
+  // the mappings keep their own reference to the file
+  ::close(fd);
+
+  m_address_ = base;
+}
+
+MirroredBuffer::~MirroredBuffer() {
+  ::munmap(m_address_, 2 * m_len_);
+}
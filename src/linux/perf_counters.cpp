@@ -0,0 +1,174 @@
+#include "linux/perf_counters.h"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+namespace {
+perf_event_attr EventAttr(PerfEvent event) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  // user space only, which perf_event_paranoid 2 still allows
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  switch (event) {
+    case PerfEvent::kCycles:
+      attr.config = PERF_COUNT_HW_CPU_CYCLES;
+      break;
+    case PerfEvent::kInstructions:
+      attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+      break;
+    case PerfEvent::kBranchMisses:
+      attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+      break;
+    case PerfEvent::kL1dMisses:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = PERF_COUNT_HW_CACHE_L1D |
+                    (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      break;
+    case PerfEvent::kLlcMisses:
+      attr.config = PERF_COUNT_HW_CACHE_MISSES;
+      break;
+  }
+  return attr;
+}
+
+int PerfEventOpen(perf_event_attr& attr, int group_fd) {
+  return ::syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+
+std::string ParanoidLevel() {
+  std::ifstream file("/proc/sys/kernel/perf_event_paranoid");
+  std::string level;
+  file >> level;
+  return level.empty() ? "unknown" : level;
+}
+}  // namespace
+
+std::string_view PerfEventName(PerfEvent event) {
+  switch (event) {
+    case PerfEvent::kCycles:
+      return "cycles";
+    case PerfEvent::kInstructions:
+      return "instructions";
+    case PerfEvent::kBranchMisses:
+      return "branch_misses";
+    case PerfEvent::kL1dMisses:
+      return "l1d_misses";
+    case PerfEvent::kLlcMisses:
+      return "llc_misses";
+  }
+  return "";
+}
+
+std::optional<double> PerfReading::PerOp(PerfEvent event,
+                                         uint64_t op_count) const {
+  const auto& value = Values[static_cast<uint32_t>(event)];
+  if (!value or op_count == 0) {
+    return std::nullopt;
+  }
+  return static_cast<double>(*value) / op_count;
+}
+
+std::optional<double> PerfReading::Ipc() const {
+  const auto& cycles = Values[static_cast<uint32_t>(PerfEvent::kCycles)];
+  const auto& instructions =
+      Values[static_cast<uint32_t>(PerfEvent::kInstructions)];
+
+  if (!cycles or !instructions or *cycles == 0) {
+    return std::nullopt;
+  }
+  return static_cast<double>(*instructions) / *cycles;
+}
+
+PerfCounters::PerfCounters() {
+  m_fds_.fill(-1);
+  m_slots_.fill(-1);
+
+  for (uint32_t i = 0; i < kPerfEventCount; ++i) {
+    perf_event_attr attr = EventAttr(static_cast<PerfEvent>(i));
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // the group starts disabled and is switched as a whole by the leader
+    attr.disabled = m_leader_fd_ == -1;
+
+    const int fd = PerfEventOpen(attr, m_leader_fd_);
+    if (fd == -1) {
+      if (m_error_.empty()) {
+        m_error_ = std::string{PerfEventName(static_cast<PerfEvent>(i))} +
+                   ": " + std::strerror(errno) +
+                   " (perf_event_paranoid=" + ParanoidLevel() + ")";
+      }
+      continue;
+    }
+
+    if (m_leader_fd_ == -1) {
+      m_leader_fd_ = fd;
+    }
+    m_fds_[i] = fd;
+    m_slots_[i] = m_slot_count_++;
+  }
+
+  if (Available()) {
+    ::ioctl(m_leader_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  for (const int fd : m_fds_) {
+    if (fd != -1) {
+      ::close(fd);
+    }
+  }
+}
+
+void PerfCounters::Enable() noexcept {
+  if (Available()) {
+    ::ioctl(m_leader_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+void PerfCounters::Disable() noexcept {
+  if (Available()) {
+    ::ioctl(m_leader_fd_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+PerfReading PerfCounters::Read() const {
+  PerfReading reading;
+
+  if (!Available()) {
+    return reading;
+  }
+
+  // { nr, time_enabled, time_running, values[nr] }
+  std::array<uint64_t, 3 + kPerfEventCount> buffer{};
+  if (::read(m_leader_fd_, buffer.data(), sizeof(buffer)) <= 0) {
+    return reading;
+  }
+
+  const uint64_t enabled = buffer[1];
+  const uint64_t running = buffer[2];
+
+  if (running == 0) {
+    return reading;
+  }
+
+  // extrapolated when the pmu was shared with other groups
+  const double scale = static_cast<double>(enabled) / running;
+
+  for (uint32_t i = 0; i < kPerfEventCount; ++i) {
+    if (m_slots_[i] != -1) {
+      reading.Values[i] = buffer[3 + m_slots_[i]] * scale;
+    }
+  }
+  return reading;
+}
@@ -0,0 +1,49 @@
+#include "linux/shared_memory.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <string>
+#include "error.h"
+
+SharedMemory::SharedMemory(std::string_view path, uint64_t len) : m_len_{len} {
+  const std::string file_path{path};
+
+  const int fd = ::open(file_path.c_str(), O_RDWR | O_CREAT, 0600);
+  if (fd == -1) {
+    throw SharedMemoryOpenError();
+  }
+
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) == -1) {
+    ::close(fd);
+    throw SharedMemoryOpenError();
+  }
+
+  if (file_stat.st_size == 0) {
+    if (::ftruncate(fd, len) == -1) {
+      ::close(fd);
+      throw SharedMemoryTruncateError();
+    }
+    m_created_ = true;
+  } else if (static_cast<uint64_t>(file_stat.st_size) != len) {
+    ::close(fd);
+    throw SharedMemorySizeError();
+  }
+
+  void* address =
+      ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+  // the mapping keeps its own reference to the file
+  ::close(fd);
+
+  if (address == MAP_FAILED) {
+    throw MmapMapFailError();
+  }
+
+  m_address_ = address;
+}
+
+SharedMemory::~SharedMemory() {
+  ::munmap(m_address_, m_len_);
+}
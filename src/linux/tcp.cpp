@@ -1,8 +1,10 @@
 #include "linux/tcp.h"
 #include <arpa/inet.h>
+#include <fcntl.h>
 #include <netinet/tcp.h>
 #include <sys/socket.h>
 #include <unistd.h>
+#include <cerrno>
 #include <cstring>
 #include "error.h"
 
@@ -68,10 +70,35 @@ TcpSocket TcpSocket::Accept() {
   return TcpSocket(new_conn);
 }
 
+std::optional<TcpSocket> TcpSocket::TryAccept() {
+  sockaddr_in addr;
+  socklen_t addr_len = sizeof(addr);
+
+  const int new_conn = ::accept4(m_fd_, reinterpret_cast<sockaddr*>(&addr),
+                                 &addr_len, SOCK_NONBLOCK);
+
+  if (new_conn == -1) {
+    // a client which gave up before it was accepted is not an error either
+    if (errno == EAGAIN or errno == EWOULDBLOCK or errno == ECONNABORTED or
+        errno == EINTR) {
+      return std::nullopt;
+    }
+    throw TcpAcceptError();
+  }
+
+  SetSocketNoDelay(new_conn);
+
+  return TcpSocket(new_conn);
+}
+
 int TcpSocket::Recv(std::span<uint8_t> buffer) {
   return ::recv(m_fd_, buffer.data(), buffer.size(), 0);
 }
 
+int TcpSocket::TryRecv(std::span<uint8_t> buffer) {
+  return ::recv(m_fd_, buffer.data(), buffer.size(), MSG_DONTWAIT);
+}
+
 int TcpSocket::Send(std::span<const uint8_t> buffer) {
   return ::send(m_fd_, buffer.data(), buffer.size(), MSG_NOSIGNAL);
 }
@@ -89,6 +116,14 @@ void SetSocketReusable(TcpSocket sock) {
   }
 }
 
+void SetSocketSharedPort(TcpSocket sock) {
+  const int yes = 1;
+  if (-1 ==
+      ::setsockopt(sock.Fd(), SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes))) {
+    throw TcpSocketOptReusePortError();
+  }
+}
+
 void SetSocketNoDelay(TcpSocket sock) {
   const int yes = 1;
   if (-1 ==
@@ -97,6 +132,13 @@ void SetSocketNoDelay(TcpSocket sock) {
   }
 }
 
+void SetSocketNonBlocking(TcpSocket sock) {
+  const int flags = ::fcntl(sock.Fd(), F_GETFL);
+  if (flags == -1 or ::fcntl(sock.Fd(), F_SETFL, flags | O_NONBLOCK) == -1) {
+    throw TcpSocketOptNonBlockingError();
+  }
+}
+
 bool IsNoDelay(TcpSocket sock) {
   int flag;
   socklen_t len = sizeof(flag);
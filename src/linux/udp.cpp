@@ -0,0 +1,78 @@
+#include "linux/udp.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+#include "error.h"
+
+UdpSocket::UdpSocket() {
+  m_fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+
+  if (m_fd_ == -1) {
+    throw UdpSocketCreateError();
+  }
+}
+
+UdpSocket::UdpSocket(int fd) : m_fd_{fd} {}
+
+void UdpSocket::Bind(std::string_view host, unsigned short port) {
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+
+  addr.sin_addr.s_addr = ::inet_addr(host.data());
+  addr.sin_port = ::htons(port);
+  addr.sin_family = AF_INET;
+
+  int err =
+      ::bind(m_fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr));
+
+  if (err == -1) {
+    throw UdpBindError();
+  }
+}
+
+bool UdpSocket::Connect(std::string_view host, unsigned short port) {
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+
+  addr.sin_addr.s_addr = ::inet_addr(host.data());
+  addr.sin_port = ::htons(port);
+  addr.sin_family = AF_INET;
+
+  return -1 != ::connect(m_fd_, reinterpret_cast<const sockaddr*>(&addr),
+                         sizeof(addr));
+}
+
+int UdpSocket::Recv(std::span<uint8_t> buffer) {
+  return ::recv(m_fd_, buffer.data(), buffer.size(), 0);
+}
+
+int UdpSocket::TryRecv(std::span<uint8_t> buffer) {
+  return ::recv(m_fd_, buffer.data(), buffer.size(), MSG_DONTWAIT);
+}
+
+int UdpSocket::Send(std::span<const uint8_t> buffer) {
+  return ::send(m_fd_, buffer.data(), buffer.size(), MSG_DONTWAIT);
+}
+
+void UdpSocket::Close() {
+  ::close(m_fd_);
+}
+
+bool IsMulticastAddress(std::string_view host) {
+  return IN_MULTICAST(::ntohl(::inet_addr(host.data())));
+}
+
+void JoinMulticastGroup(UdpSocket sock, std::string_view group) {
+  ip_mreq request;
+  std::memset(&request, 0, sizeof(request));
+
+  request.imr_multiaddr.s_addr = ::inet_addr(group.data());
+  request.imr_interface.s_addr = ::htonl(INADDR_ANY);
+
+  if (-1 == ::setsockopt(sock.Fd(), IPPROTO_IP, IP_ADD_MEMBERSHIP, &request,
+                         sizeof(request))) {
+    throw UdpSocketOptMulticastError();
+  }
+}
@@ -0,0 +1,224 @@
+#include "linux/uring.h"
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include "error.h"
+
+IoUring::IoUring(uint32_t entries, bool sqpoll) : m_sqpoll_{sqpoll} {
+  io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+
+  if (sqpoll) {
+    params.flags |= IORING_SETUP_SQPOLL;
+    // the poller thread sleeps after a second without submissions
+    params.sq_thread_idle = 1000;
+  }
+
+  m_fd_ = ::syscall(__NR_io_uring_setup, entries, &params);
+  if (m_fd_ == -1) {
+    throw IoUringSetupError();
+  }
+
+  // timed waits and a single ring mapping, 5.11 onwards
+  constexpr uint32_t kRequired =
+      IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+  if ((params.features & kRequired) != kRequired) {
+    ::close(m_fd_);
+    errno = ENOSYS;
+    throw IoUringSetupError();
+  }
+
+  m_sq_ring_len_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  m_cq_ring_len_ =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  m_sq_ring_len_ = m_cq_ring_len_ = std::max(m_sq_ring_len_, m_cq_ring_len_);
+
+  m_sq_ring_ = ::mmap(nullptr, m_sq_ring_len_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, m_fd_, IORING_OFF_SQ_RING);
+  if (m_sq_ring_ == MAP_FAILED) {
+    ::close(m_fd_);
+    throw MmapMapFailError();
+  }
+  m_cq_ring_ = m_sq_ring_;
+
+  m_sqes_len_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = ::mmap(nullptr, m_sqes_len_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, m_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    ::munmap(m_sq_ring_, m_sq_ring_len_);
+    ::close(m_fd_);
+    throw MmapMapFailError();
+  }
+  m_sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+  uint8_t* sq = static_cast<uint8_t*>(m_sq_ring_);
+  m_sq_head_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+  m_sq_tail_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+  m_sq_flags_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.flags);
+  m_sq_array_ = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+  m_sq_mask_ = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+  m_sq_entries_ = params.sq_entries;
+
+  uint8_t* cq = static_cast<uint8_t*>(m_cq_ring_);
+  m_cq_head_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+  m_cq_tail_ = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+  m_cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+  m_cq_mask_ = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+
+  // sqe slots are used in ring order, so the indirection is the identity
+  for (uint32_t i = 0; i < m_sq_entries_; ++i) {
+    m_sq_array_[i] = i;
+  }
+}
+
+IoUring::~IoUring() {
+  ::munmap(m_sqes_, m_sqes_len_);
+  ::munmap(m_sq_ring_, m_sq_ring_len_);
+  ::close(m_fd_);
+}
+
+io_uring_sqe* IoUring::GetSqe() noexcept {
+  const uint32_t head =
+      std::atomic_ref<uint32_t>(*m_sq_head_).load(std::memory_order_acquire);
+
+  if (m_sqe_tail_ - head >= m_sq_entries_) [[unlikely]] {
+    return nullptr;
+  }
+
+  io_uring_sqe* sqe = &m_sqes_[m_sqe_tail_++ & m_sq_mask_];
+  std::memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+uint32_t IoUring::Flush() noexcept {
+  const uint32_t to_submit = m_sqe_tail_ - m_sqe_head_;
+  m_sqe_head_ = m_sqe_tail_;
+
+  std::atomic_ref<uint32_t>(*m_sq_tail_).store(m_sqe_tail_,
+                                               std::memory_order_release);
+  return to_submit;
+}
+
+void IoUring::Submit() {
+  const uint32_t to_submit = Flush();
+
+  if (m_sqpoll_) {
+    // the tail store has to be visible before the poller's flag is read
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (std::atomic_ref<uint32_t>(*m_sq_flags_).load(
+            std::memory_order_relaxed) &
+        IORING_SQ_NEED_WAKEUP) [[unlikely]] {
+      Enter(0, 0, IORING_ENTER_SQ_WAKEUP, nullptr, 0);
+    }
+    return;
+  }
+
+  if (to_submit > 0) {
+    Enter(to_submit, 0, 0, nullptr, 0);
+  }
+}
+
+void IoUring::SubmitAndWait(int timeout_ms) {
+  const uint32_t to_submit = Flush();
+
+  uint32_t flags = IORING_ENTER_GETEVENTS;
+  if (m_sqpoll_) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (std::atomic_ref<uint32_t>(*m_sq_flags_).load(
+            std::memory_order_relaxed) &
+        IORING_SQ_NEED_WAKEUP) {
+      flags |= IORING_ENTER_SQ_WAKEUP;
+    }
+  }
+
+  if (timeout_ms < 0) {
+    Enter(to_submit, 1, flags, nullptr, 0);
+    return;
+  }
+
+  __kernel_timespec timeout;
+  timeout.tv_sec = timeout_ms / 1000;
+  timeout.tv_nsec = (timeout_ms % 1000) * 1'000'000;
+
+  io_uring_getevents_arg arg;
+  std::memset(&arg, 0, sizeof(arg));
+  arg.sigmask_sz = _NSIG / 8;
+  arg.ts = reinterpret_cast<uint64_t>(&timeout);
+
+  Enter(to_submit, 1, flags | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+}
+
+int IoUring::Enter(uint32_t to_submit,
+                   uint32_t min_complete,
+                   uint32_t flags,
+                   const void* arg,
+                   uint64_t arg_len) {
+  const int result = ::syscall(__NR_io_uring_enter, m_fd_, to_submit,
+                               min_complete, flags, arg, arg_len);
+
+  if (result == -1) {
+    // timed out, interrupted, or completions have to be reaped first
+    if (errno == ETIME or errno == EINTR or errno == EBUSY or
+        errno == EAGAIN) {
+      return 0;
+    }
+    throw IoUringEnterError();
+  }
+  return result;
+}
+
+void IoUring::Register(uint32_t opcode, const void* arg, uint32_t count) {
+  if (::syscall(__NR_io_uring_register, m_fd_, opcode, arg, count) == -1) {
+    throw IoUringRegisterError();
+  }
+}
+
+bool IoUring::Supports(uint8_t opcode) {
+  // the probe is followed by an entry for every possible opcode
+  constexpr uint32_t kOpCount = 256;
+  alignas(io_uring_probe) uint8_t
+      buffer[sizeof(io_uring_probe) + kOpCount * sizeof(io_uring_probe_op)];
+  std::memset(buffer, 0, sizeof(buffer));
+
+  auto* probe = reinterpret_cast<io_uring_probe*>(buffer);
+  Register(IORING_REGISTER_PROBE, probe, kOpCount);
+
+  return opcode <= probe->last_op and
+         (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED);
+}
+
+void IoUring::RegisterFiles(std::span<const int> fds) {
+  Register(IORING_REGISTER_FILES, fds.data(), fds.size());
+}
+
+void IoUring::SetFileAllocRange(uint32_t offset, uint32_t len) {
+  io_uring_file_index_range range;
+  std::memset(&range, 0, sizeof(range));
+  range.off = offset;
+  range.len = len;
+
+  Register(IORING_REGISTER_FILE_ALLOC_RANGE, &range, 0);
+}
+
+void IoUring::RegisterBuffer(const void* address, uint64_t len) {
+  const iovec buffer{.iov_base = const_cast<void*>(address), .iov_len = len};
+  Register(IORING_REGISTER_BUFFERS, &buffer, 1);
+}
+
+void IoUring::RegisterBufferRing(io_uring_buf_ring* ring,
+                                 uint32_t entries,
+                                 uint16_t group) {
+  io_uring_buf_reg reg;
+  std::memset(&reg, 0, sizeof(reg));
+  reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+  reg.ring_entries = entries;
+  reg.bgid = group;
+
+  Register(IORING_REGISTER_PBUF_RING, &reg, 1);
+}
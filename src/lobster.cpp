@@ -0,0 +1,21 @@
+#include "lobster.h"
+
+namespace lobster {
+
+bool Translator::ToPrice(int64_t price, Price_t& ticks) {
+  if (m_base_price_ == 0) {
+    m_base_price_ = price;
+  }
+
+  const int64_t offset = (price - m_base_price_) / m_tick_size_;
+  const int64_t shifted = (1 << 15) + offset;
+
+  if (shifted < 1 or shifted > 65535) {
+    return false;
+  }
+
+  ticks = static_cast<Price_t>(shifted);
+  return true;
+}
+
+}  // namespace lobster
@@ -0,0 +1,56 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "command_line.h"
+#include "linux/file_map.h"
+#include "lobster.h"
+#include "order_file.h"
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <lobster message file> <order file> "
+                 "[--tick-size <price units>] [--base-price <price units>]\n";
+    exit(-1);
+  }
+
+  const auto tick_size = FlagValue(argc, argv, "--tick-size");
+  const auto base_price = FlagValue(argc, argv, "--base-price");
+
+  lobster::Translator translator(
+      tick_size.empty() ? lobster::kDefaultTickSize
+                        : std::stoll(std::string{tick_size}),
+      base_price.empty() ? 0 : std::stoll(std::string{base_price}));
+
+  FileMap messages(argv[1]);
+  const std::string_view text{
+      reinterpret_cast<const char*>(messages.Data().data()),
+      messages.Data().size()};
+
+  OrderFileWriter writer(argv[2]);
+
+  const auto start = std::chrono::steady_clock::now();
+
+  const uint64_t malformed =
+      lobster::ParseMessages(text, [&](const lobster::Message& message) {
+        translator.Translate(message, [&writer](const Order& order) {
+          writer.Write(order);
+        });
+      });
+  writer.Close();
+
+  const auto end = std::chrono::steady_clock::now();
+  const double seconds = std::chrono::duration<double>(end - start).count();
+
+  const lobster::TranslateCount& count = translator.Count();
+  std::cout << "submissions: " << count.Submissions
+            << ", cancels: " << count.Cancels
+            << ", executions: " << count.Executions << '\n';
+  std::cout << "skipped: " << count.UnknownOrders << " unknown orders, "
+            << count.OutOfRange << " out of price range, " << count.Ignored
+            << " hidden executions, cross trades or halts, " << malformed
+            << " malformed lines" << '\n';
+  std::cout << "wrote " << writer.Count() << " orders in " << seconds << " s"
+            << '\n';
+}
@@ -1,19 +1,71 @@
 #include <pthread.h>
 #include <sched.h>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <csignal>
 #include <cstdint>
+#include <cstdio>
 #include <iostream>
+#include <memory>
 #include <span>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <vector>
+#include "command_line.h"
 #include "engine.h"
+#include "error.h"
+#include "execution_reports.h"
+#include "file_replay_transport.h"
+#include "fix_transport.h"
 #include "heap_based_engine.h"
+#include "latency_stats.h"
 #include "linux/memory_map.h"
+#include "market_data.h"
 #include "order_handler.h"
+#include "order_pipeline.h"
+#include "order_sequencer.h"
+#include "replication.h"
 #include "server.h"
+#include "shared_book.h"
+#include "shm_transport.h"
+#include "trace_ring.h"
+#include "trade_fanout.h"
 #include "trade_observer.h"
+#include "uring_server.h"
 
-static void PinCurrentThreadToCore() {
-  const int core_id = sched_getcpu();
+namespace {
+// set while a batch is applied to a shared book, an interrupt arriving
+// then is deferred until the batch is complete so the book stays consistent
+std::atomic<bool> g_in_batch{false};
+std::atomic<int> g_pending_signal{0};
+
+// set while tracing, dumped on SIGUSR1 and before exiting on an interrupt
+TraceRing* g_trace_ring{nullptr};
+
+// --io-uring and --sqpoll, for the order gateway and the trade observer
+bool g_io_uring{false};
+bool g_sqpoll{false};
+
+// --shm-orders and --shm-trades replace the sockets with shared memory rings
+std::string_view g_shm_orders;
+std::string_view g_shm_trades;
+// --shm-wait adaptive, otherwise an idle ring is polled without pause
+bool g_adaptive_wait{false};
+
+// --orders-file replays a recorded order file instead of serving sockets
+std::string_view g_orders_file;
+
+// --fix takes FIX 4.4 order entry instead of binary orders
+bool g_fix{false};
+}  // namespace
+
+// stays on the core it currently runs on if none is given
+static void PinCurrentThreadToCore(int core_id = -1) {
+  if (core_id == -1) {
+    core_id = sched_getcpu();
+  }
 
   cpu_set_t cpuset;
   CPU_ZERO(&cpuset);
@@ -26,30 +78,454 @@ void SignalSetup() {
   std::memset(&action, 0, sizeof(action));
 
   auto handler = +[](int num) {
+    if (g_in_batch.load(std::memory_order_acquire)) {
+      g_pending_signal.store(num, std::memory_order_release);
+      return;
+    }
     std::cout << "Interrupt Signal: " << strsignal(num) << '\n';
+    if (g_trace_ring != nullptr) {
+      g_trace_ring->Dump(kTraceDumpExit);
+    }
     exit(num);
   };
 
   action.sa_handler = handler;
 
   sigaction(SIGINT, &action, nullptr);
+
+  struct sigaction dump_action;
+  std::memset(&dump_action, 0, sizeof(dump_action));
+
+  dump_action.sa_handler = +[](int) {
+    if (g_trace_ring != nullptr) {
+      g_trace_ring->RequestDump();
+    }
+  };
+  // the dump itself happens at the next batch, recv and accept carry on
+  dump_action.sa_flags = SA_RESTART;
+
+  sigaction(SIGUSR1, &dump_action, nullptr);
 }
 
-int main(int, char**) {
-  SignalSetup();
+static TradeObserver MakeTradeObserver() {
+  if (!g_shm_trades.empty()) {
+    return TradeObserver(g_shm_trades);
+  }
+  return TradeObserver("127.0.0.1", 8765);
+}
 
-  PinCurrentThreadToCore();
+// falls back to the blocking socket if io_uring is not available
+static void EnableIoUring(TradeObserver& trade_observer) {
+  if (!g_io_uring) {
+    return;
+  }
 
-  Mmap<uint8_t> allocated_memory(sizeof(HeapBasedEngine));
-  HeapBasedEngine* engine = new (allocated_memory.Address()) HeapBasedEngine();
+  try {
+    trade_observer.EnableIoUring(g_sqpoll);
+  } catch (const BaseIOError& error) {
+    std::cout << "trade observer stays on sockets, " << error.what() << '\n';
+  }
+}
 
-  TradeObserver trade_observer("127.0.0.1", 8765);
+// subscribers are always served from plain sockets
+static void EnableIoUring(TradeFanout&) {}
 
-  Server server("127.0.0.1", 5678, OrderHandler{*engine, trade_observer});
+// replays the whole file, then keeps the process up so the trade observer
+// can finish publishing
+template <class Handler>
+static void ReplayOrders(Handler handler) {
+  BasicServer<FileReplayTransport, Handler> server(std::move(handler),
+                                                   g_orders_file);
+
+  const auto start = std::chrono::steady_clock::now();
+  server.Run();
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  const uint64_t order_count = server.GetTransport().OrderCount();
+  std::cout << "replayed " << order_count << " orders from " << g_orders_file
+            << " in " << elapsed.count() << "s, "
+            << static_cast<uint64_t>(order_count / elapsed.count())
+            << " orders/s" << '\n';
+
+  while (1) {
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+  }
+}
+
+// the order gateway on the calling thread, a recorded file, a shared memory
+// ring, FIX sessions, or through io_uring if asked for and available, the
+// epoll server otherwise, the handler is inlined into every one but io_uring
+template <class Handler>
+static void RunGateway(Handler handler) {
+  if (!g_orders_file.empty()) {
+    ReplayOrders(std::move(handler));
+  }
+
+  if (!g_shm_orders.empty()) {
+    BasicServer<ShmTransport, Handler> server(std::move(handler),
+                                              g_shm_orders, g_adaptive_wait);
+    server.Run();
+  }
+
+  if (g_fix) {
+    BasicServer<FixTransport, Handler> server(std::move(handler), "127.0.0.1",
+                                              9878);
+    server.Run();
+  }
+
+  if (g_io_uring) {
+    std::unique_ptr<UringServer> server;
+
+    try {
+      server = std::make_unique<UringServer>("127.0.0.1", 5678, handler,
+                                             g_sqpoll);
+    } catch (const BaseIOError& error) {
+      std::cout << "order gateway stays on sockets, " << error.what() << '\n';
+    }
+
+    if (server) {
+      server->Run();
+    }
+  }
+
+  BasicServer<TcpTransport, Handler> server(std::move(handler), "127.0.0.1",
+                                            5678);
+  server.Run();
+}
+
+// the trades go to one TradeObserver or to the subscribers of a TradeFanout
+template <class Publisher, class Handler>
+static void Serve(Publisher& trade_observer, Handler handler) {
+  EnableIoUring(trade_observer);
 
   std::jthread observer_thread([&trade_observer]() {
     PinCurrentThreadToCore();
     trade_observer.Run();
   });
-  server.Run();
+  RunGateway(std::move(handler));
+}
+
+static void ServeSharedBook(std::string_view path) {
+  SharedBook<HeapBasedEngine> book(path);
+
+  std::cout << (book.Reattached() ? "reattached to" : "created")
+            << " shared book " << path << '\n';
+
+  TradeObserver trade_observer("127.0.0.1", 8765, book.Queue());
+  OrderHandler order_handler{book.GetEngine(), trade_observer};
+
+  Serve(trade_observer, [&](std::span<const uint8_t> buffer) {
+    g_in_batch.store(true, std::memory_order_release);
+    book.BeginUpdate();
+
+    order_handler(buffer);
+
+    book.EndUpdate();
+    g_in_batch.store(false, std::memory_order_release);
+
+    if (const int num = g_pending_signal.load(std::memory_order_acquire))
+        [[unlikely]] {
+      std::cout << "Interrupt Signal: " << strsignal(num) << '\n';
+      exit(num);
+    }
+  });
+}
+
+static void ServePrimary(uint16_t replication_port) {
+  Mmap<uint8_t> allocated_memory(sizeof(HeapBasedEngine));
+  HeapBasedEngine* engine = new (allocated_memory.Address()) HeapBasedEngine();
+
+  ReplicationPublisher publisher("127.0.0.1", replication_port);
+
+  TradeObserver trade_observer = MakeTradeObserver();
+  OrderHandler order_handler{*engine, trade_observer};
+
+  Serve(trade_observer, [&](std::span<const uint8_t> buffer) {
+    publisher.Publish(buffer);
+    order_handler(buffer);
+    publisher.Checkpoint(engine->StateHash());
+  });
+}
+
+static void ServeFollower(uint16_t primary_port) {
+  Mmap<uint8_t> allocated_memory(sizeof(HeapBasedEngine));
+  HeapBasedEngine* engine = new (allocated_memory.Address()) HeapBasedEngine();
+
+  {
+    ReplicationFollower follower("127.0.0.1", primary_port);
+
+    StandbyObserver standby_observer;
+    OrderHandler standby_handler{*engine, standby_observer};
+
+    follower.Run(standby_handler, [engine]() { return engine->StateHash(); });
+
+    std::cout << "primary lost after " << follower.Sequence()
+              << " orders, taking over" << '\n';
+  }
+
+  TradeObserver trade_observer = MakeTradeObserver();
+
+  Serve(trade_observer, OrderHandler{*engine, trade_observer});
+}
+
+// the book's top levels over udp next to the trades, the publisher sleeps
+// between intervals so it shares a core with anything
+static void ServeMarketData(HeapBasedEngine& engine,
+                            TradeObserver& trade_observer,
+                            uint16_t port,
+                            int argc,
+                            char** argv) {
+  auto value = [argc, argv](std::string_view flag, uint32_t fallback) {
+    const auto text = FlagValue(argc, argv, flag);
+    return text.empty() ? fallback : std::stoul(std::string{text});
+  };
+
+  std::string host{FlagValue(argc, argv, "--depth-host")};
+  if (host.empty()) {
+    host = "127.0.0.1";
+  }
+
+  MarketDataPublisher market_data(
+      host, port, value("--depth-levels", 10),
+      std::chrono::milliseconds{value("--depth-interval-ms", 10)},
+      std::chrono::milliseconds{value("--snapshot-interval-ms", 1000)});
+
+  OrderHandler order_handler{engine, trade_observer, NoInstrumentation{},
+                             DepthReports{market_data.Book()}};
+
+  std::jthread market_data_thread([&market_data]() { market_data.Run(); });
+
+  Serve(trade_observer, [&](std::span<const uint8_t> buffer) {
+    order_handler(buffer);
+    market_data.Update();
+  });
+}
+
+// tcp gateways sharing the order port, each on its own thread, the kernel
+// spreads the connections over them and all of them feed the sequencer
+static void ServeGateways(OrderSequencer& sequencer, uint32_t gateway_count) {
+  auto publish = [&sequencer](std::span<const uint8_t> buffer) {
+    sequencer.Publish(buffer);
+  };
+  using Gateway = BasicServer<TcpTransport, decltype(publish)>;
+
+  std::vector<std::jthread> gateways;
+  for (uint32_t i = 1; i < gateway_count; ++i) {
+    gateways.emplace_back([publish]() {
+      Gateway gateway(publish, "127.0.0.1", 5678, true);
+      gateway.Run();
+    });
+  }
+
+  Gateway gateway(publish, "127.0.0.1", 5678, true);
+  gateway.Run();
+}
+
+// network, matching and publishing each on their own thread, e.g.
+// --cores 2,3,4 pins them in that order, with more than one gateway the
+// network stage is that many threads, the first one on the network core
+static void ServePipeline(std::string_view cores, uint32_t gateway_count) {
+  std::array<int, 3> core_ids{-1, -1, -1};
+
+  if (!cores.empty() and std::sscanf(std::string{cores}.c_str(), "%d,%d,%d",
+                                     &core_ids[0], &core_ids[1],
+                                     &core_ids[2]) != 3) {
+    std::cout << "Usage: matching_engine --pipeline "
+                 "[--cores <network>,<matching>,<publisher>] "
+                 "[--gateways <n>]"
+              << '\n';
+    exit(-1);
+  }
+
+  Mmap<uint8_t> allocated_memory(sizeof(HeapBasedEngine));
+  HeapBasedEngine* engine = new (allocated_memory.Address()) HeapBasedEngine();
+
+  TradeObserver trade_observer = MakeTradeObserver();
+  OrderHandler order_handler{*engine, trade_observer};
+
+  EnableIoUring(trade_observer);
+
+  std::jthread publisher_thread([&trade_observer, &core_ids]() {
+    PinCurrentThreadToCore(core_ids[2]);
+    trade_observer.Run();
+  });
+
+  if (gateway_count > 1) {
+    OrderSequencer sequencer;
+
+    std::jthread matching_thread([&sequencer, &order_handler, &core_ids]() {
+      PinCurrentThreadToCore(core_ids[1]);
+      sequencer.Run(order_handler);
+    });
+
+    PinCurrentThreadToCore(core_ids[0]);
+    ServeGateways(sequencer, gateway_count);
+    return;
+  }
+
+  OrderPipeline pipeline;
+
+  std::jthread matching_thread([&pipeline, &order_handler, &core_ids]() {
+    PinCurrentThreadToCore(core_ids[1]);
+    pipeline.Run(order_handler);
+  });
+
+  PinCurrentThreadToCore(core_ids[0]);
+  RunGateway([&pipeline](std::span<const uint8_t> buffer) {
+    pipeline.Publish(buffer);
+  });
+}
+
+int main(int argc, char** argv) {
+  SignalSetup();
+
+  g_io_uring = HasFlag(argc, argv, "--io-uring");
+  g_sqpoll = HasFlag(argc, argv, "--sqpoll");
+
+  // e.g. /dev/shm/matching_engine_orders and /dev/shm/matching_engine_trades
+  g_shm_orders = FlagValue(argc, argv, "--shm-orders");
+  g_shm_trades = FlagValue(argc, argv, "--shm-trades");
+  g_adaptive_wait = FlagValue(argc, argv, "--shm-wait") == "adaptive";
+  // e.g. an order file written by order_converter or workload_generator
+  g_orders_file = FlagValue(argc, argv, "--orders-file");
+  g_fix = HasFlag(argc, argv, "--fix");
+
+  // FIX sessions are answered with execution reports, which only the
+  // default mode sends, without them no order would ever be acknowledged
+  // and the transport would never forget one
+  if (g_fix) {
+    for (const std::string_view mode :
+         {"--shm-book", "--replicate", "--follow", "--pipeline", "--fanout",
+          "--latency-stats", "--trace", "--depth"}) {
+      if (HasFlag(argc, argv, mode)) {
+        std::cout << "Usage: matching_engine --fix, not with " << mode
+                  << '\n';
+        exit(-1);
+      }
+    }
+  }
+
+  PinCurrentThreadToCore();
+
+  // e.g. /dev/shm/matching_engine_book or a file on a hugetlbfs mount
+  if (const auto path = FlagValue(argc, argv, "--shm-book"); !path.empty()) {
+    ServeSharedBook(path);
+    return 0;
+  }
+
+  if (const auto port = FlagValue(argc, argv, "--replicate"); !port.empty()) {
+    ServePrimary(std::stoi(std::string{port}));
+    return 0;
+  }
+
+  if (const auto port = FlagValue(argc, argv, "--follow"); !port.empty()) {
+    ServeFollower(std::stoi(std::string{port}));
+    return 0;
+  }
+
+  if (HasFlag(argc, argv, "--pipeline")) {
+    const auto gateways = FlagValue(argc, argv, "--gateways");
+    const uint32_t gateway_count =
+        gateways.empty() ? 1 : std::stoul(std::string{gateways});
+
+    if (gateway_count > 1 and (g_io_uring or !g_shm_orders.empty() or
+                               !g_orders_file.empty())) {
+      std::cout << "Usage: matching_engine --pipeline --gateways <n>, on the "
+                   "tcp order gateway only"
+                << '\n';
+      exit(-1);
+    }
+
+    ServePipeline(FlagValue(argc, argv, "--cores"), gateway_count);
+    return 0;
+  }
+
+  Mmap<uint8_t> allocated_memory(sizeof(HeapBasedEngine));
+  HeapBasedEngine* engine = new (allocated_memory.Address()) HeapBasedEngine();
+
+  // e.g. --fanout 8766, trade_result_server --subscribe 8766 as many times
+  // as there are consumers, instead of the one consumer on 8765
+  if (const auto port = FlagValue(argc, argv, "--fanout"); !port.empty()) {
+    TradeFanout fanout("127.0.0.1", std::stoi(std::string{port}));
+
+    Serve(fanout, OrderHandler{*engine, fanout});
+    return 0;
+  }
+
+  TradeObserver trade_observer = MakeTradeObserver();
+
+  // e.g. --depth 8770, read with depth_listener --port 8770, see
+  // ServeMarketData for the other --depth flags
+  if (const auto port = FlagValue(argc, argv, "--depth"); !port.empty()) {
+    if (HasFlag(argc, argv, "--exec-reports")) {
+      std::cout << "Usage: matching_engine --depth <port>, without execution "
+                   "reports"
+                << '\n';
+      exit(-1);
+    }
+
+    ServeMarketData(*engine, trade_observer, std::stoi(std::string{port}),
+                    argc, argv);
+    return 0;
+  }
+
+  // e.g. /dev/shm/matching_engine_latency, read with latency_stats
+  if (const auto path = FlagValue(argc, argv, "--latency-stats");
+      !path.empty()) {
+    LatencyStats stats(path);
+    const double ticks_per_ns = CalibrateTsc();
+    stats.SetTicksPerNs(ticks_per_ns);
+
+    OrderHandler order_handler{*engine, trade_observer,
+                               StageInstrumentation{stats}};
+
+    // the book shape costs a pass over the book, published once a second
+    const uint64_t publish_interval = 1'000'000'000 * ticks_per_ns;
+    uint64_t next_publish = 0;
+
+    Serve(trade_observer, [&](std::span<const uint8_t> buffer) {
+      order_handler(buffer);
+
+      if (const uint64_t now = ReadTsc(); now >= next_publish) {
+        stats.PublishEngineStats(engine->Stats());
+        next_publish = now + publish_interval;
+      }
+    });
+    return 0;
+  }
+
+  // e.g. /var/tmp/matching_engine.trace, read with trace_decoder
+  if (const auto path = FlagValue(argc, argv, "--trace"); !path.empty()) {
+    const auto spike_us = FlagValue(argc, argv, "--trace-spike-us");
+    const uint64_t spike_ns =
+        spike_us.empty() ? 100'000 : std::stoul(std::string{spike_us}) * 1000;
+
+    TraceRing trace_ring(path, spike_ns);
+    g_trace_ring = &trace_ring;
+
+    Serve(trade_observer, OrderHandler{*engine, trade_observer,
+                                       TraceInstrumentation{trace_ring}});
+    return 0;
+  }
+
+  // acks, rejects and fills back on the connection each order came in on,
+  // FIX sessions always get theirs
+  if (g_fix or HasFlag(argc, argv, "--exec-reports")) {
+    if (g_io_uring or !g_shm_orders.empty() or !g_orders_file.empty()) {
+      std::cout << "Usage: matching_engine [--exec-reports | --fix], on the "
+                   "tcp order gateway only"
+                << '\n';
+      exit(-1);
+    }
+
+    ExecutionReports reports;
+
+    Serve(trade_observer, OrderHandler{*engine, trade_observer,
+                                       NoInstrumentation{},
+                                       SessionReports{reports}});
+    return 0;
+  }
+
+  Serve(trade_observer, OrderHandler{*engine, trade_observer});
 }
@@ -0,0 +1,260 @@
+#include "market_data.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace {
+// where a level of price belongs on its side, best first
+bool Before(OrderType_t side, Price_t price, Price_t other) {
+  return side == kBuy ? price > other : price < other;
+}
+
+const DepthLevel* Find(std::span<const DepthLevel> levels, Price_t price) {
+  const auto found =
+      std::ranges::find_if(levels, [price](const DepthLevel& level) {
+        return level.Price == price;
+      });
+  return found == std::end(levels) ? nullptr : &*found;
+}
+}  // namespace
+
+void DepthView::Apply(const DepthUpdate& update) {
+  auto& levels = Levels[update.Side];
+  uint32_t& count = Count[update.Side];
+
+  uint32_t index = 0;
+  while (index < count and Before(update.Side, levels[index].Price,
+                                  update.Price)) {
+    ++index;
+  }
+
+  const bool found = index < count and levels[index].Price == update.Price;
+
+  if (update.Quantity == 0) {
+    if (found) {
+      std::memmove(&levels[index], &levels[index + 1],
+                   (count - index - 1) * sizeof(DepthLevel));
+      --count;
+    }
+    return;
+  }
+
+  if (found) {
+    levels[index].Quantity = update.Quantity;
+    return;
+  }
+
+  if (index == kMaxDepthLevels) {
+    return;
+  }
+
+  count = std::min(count + 1, kMaxDepthLevels);
+  std::memmove(&levels[index + 1], &levels[index],
+               (count - index - 1) * sizeof(DepthLevel));
+  levels[index] = DepthLevel{update.Price, update.Quantity};
+}
+
+bool operator==(const DepthView& lhs, const DepthView& rhs) {
+  for (const OrderType_t side : {kBuy, kSell}) {
+    if (lhs.Count[side] != rhs.Count[side] or
+        std::memcmp(lhs.Levels[side].data(), rhs.Levels[side].data(),
+                    lhs.Count[side] * sizeof(DepthLevel)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t DiffDepth(const DepthView& before,
+                   const DepthView& after,
+                   std::span<DepthUpdate> out) {
+  uint32_t count = 0;
+
+  // removals first, so a receiver never holds more than a side's levels
+  for (const OrderType_t side : {kBuy, kSell}) {
+    for (const DepthLevel& level : before.Side(side)) {
+      if (Find(after.Side(side), level.Price) == nullptr) {
+        out[count++] = DepthUpdate{side, level.Price, 0};
+      }
+    }
+  }
+
+  for (const OrderType_t side : {kBuy, kSell}) {
+    for (const DepthLevel& level : after.Side(side)) {
+      const DepthLevel* sent = Find(before.Side(side), level.Price);
+
+      if (sent == nullptr or sent->Quantity != level.Quantity) {
+        out[count++] = DepthUpdate{side, level.Price, level.Quantity};
+      }
+    }
+  }
+  return count;
+}
+
+MarketDataPublisher::MarketDataPublisher(
+    std::string_view host,
+    uint16_t port,
+    uint32_t depth,
+    std::chrono::milliseconds interval,
+    std::chrono::milliseconds snapshot_interval)
+    : m_depth_{std::min(depth, kMaxDepthLevels)},
+      m_interval_{interval},
+      m_snapshot_interval_{snapshot_interval} {
+  // nobody listening is not an error, the feed is sent regardless
+  m_sock_.Connect(host, port);
+}
+
+void MarketDataPublisher::Update() noexcept {
+  if (m_book_.Version() == m_book_version_) [[likely]] {
+    return;
+  }
+  m_book_version_ = m_book_.Version();
+
+  for (const OrderType_t side : {kBuy, kSell}) {
+    m_top_.Count[side] =
+        m_book_.Top(side, std::span{m_top_.Levels[side]}.first(m_depth_));
+  }
+
+  // only this thread writes the latest view, it may read it unlocked
+  if (m_top_ == m_latest_) {
+    return;
+  }
+
+  const uint64_t version = m_latest_version_.load(std::memory_order_relaxed);
+
+  m_latest_version_.store(version + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  std::memcpy(&m_latest_, &m_top_, sizeof(m_top_));
+
+  m_latest_version_.store(version + 2, std::memory_order_release);
+}
+
+void MarketDataPublisher::ReadLatest(DepthView& view) const noexcept {
+  while (1) {
+    const uint64_t version =
+        m_latest_version_.load(std::memory_order_acquire);
+
+    if (version & 1) [[unlikely]] {
+      continue;
+    }
+
+    std::memcpy(&view, &m_latest_, sizeof(view));
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (m_latest_version_.load(std::memory_order_relaxed) == version)
+        [[likely]] {
+      return;
+    }
+  }
+}
+
+void MarketDataPublisher::Run() {
+  auto next_incremental = std::chrono::steady_clock::now();
+  auto next_snapshot = next_incremental;
+
+  while (1) {
+    std::this_thread::sleep_until(std::min(next_incremental, next_snapshot));
+    const auto now = std::chrono::steady_clock::now();
+
+    if (now >= next_incremental) {
+      SendIncremental();
+      // an interval missed is skipped, not caught up on
+      next_incremental = std::max(next_incremental + m_interval_, now);
+    }
+
+    if (now >= next_snapshot) {
+      SendSnapshot();
+      next_snapshot = now + m_snapshot_interval_;
+    }
+  }
+}
+
+bool MarketDataPublisher::SendIncremental() {
+  ReadLatest(m_read_);
+
+  std::array<DepthUpdate, 4 * kMaxDepthLevels> updates;
+  const uint32_t count = DiffDepth(m_sent_, m_read_, updates);
+
+  if (count == 0) {
+    return false;
+  }
+
+  m_sent_ = m_read_;
+  ++m_sequence_;
+  SendPacket(kIncremental, std::span{updates}.first(count));
+  return true;
+}
+
+void MarketDataPublisher::SendSnapshot() {
+  std::array<DepthUpdate, 4 * kMaxDepthLevels> levels;
+  const uint32_t count = DiffDepth(DepthView{}, m_sent_, levels);
+
+  SendPacket(kSnapshot, std::span{levels}.first(count));
+}
+
+void MarketDataPublisher::SendPacket(DepthPacketKind kind,
+                                     std::span<const DepthUpdate> updates) {
+  std::array<uint8_t, kMaxPacketLen> packet;
+
+  uint32_t len = Encoder<DepthPacketMessage>(packet)
+                     .Set<DepthPacketMessage::kSequence>(m_sequence_)
+                     .Set<DepthPacketMessage::kKind>(kind)
+                     .Set<DepthPacketMessage::kLevelCount>(updates.size())
+                     .Length();
+
+  for (const DepthUpdate& update : updates) {
+    len += Encoder<DepthLevelMessage>(std::span{packet}.subspan(len))
+               .Set<DepthLevelMessage::kSide>(update.Side)
+               .Set<DepthLevelMessage::kPrice>(update.Price)
+               .Set<DepthLevelMessage::kQuantity>(update.Quantity)
+               .Length();
+  }
+
+  // udp drops what it cannot take, subscribers recover from the next
+  // snapshot
+  m_sock_.Send(std::span{packet}.first(len));
+}
+
+bool DepthFeed::Apply(std::span<const uint8_t> packet) {
+  const auto header = Decoder<DepthPacketMessage>::Wrap(packet);
+  if (!header) {
+    return false;
+  }
+
+  const auto levels = packet.subspan(header->Length());
+  const uint64_t sequence = header->Get<DepthPacketMessage::kSequence>();
+  const uint32_t level_count = header->Get<DepthPacketMessage::kLevelCount>();
+
+  if (levels.size() !=
+      level_count * Encoder<DepthLevelMessage>::kLength) [[unlikely]] {
+    return false;
+  }
+
+  if (header->Get<DepthPacketMessage::kKind>() == kSnapshot) {
+    m_view_ = DepthView{};
+    m_sequence_ = sequence;
+    m_synced_ = true;
+  } else if (!m_synced_ or sequence <= m_sequence_) {
+    return false;
+  } else if (sequence != m_sequence_ + 1) [[unlikely]] {
+    ++m_gap_count_;
+    m_synced_ = false;
+    return false;
+  } else {
+    m_sequence_ = sequence;
+  }
+
+  ForEachMessage(levels, [this](uint16_t, std::span<const uint8_t> message) {
+    const auto level = Decoder<DepthLevelMessage>::Wrap(message);
+    if (!level or level->Get<DepthLevelMessage::kSide>() > kSell)
+        [[unlikely]] {
+      return;
+    }
+
+    m_view_.Apply(DepthUpdate{level->Get<DepthLevelMessage::kSide>(),
+                              level->Get<DepthLevelMessage::kPrice>(),
+                              level->Get<DepthLevelMessage::kQuantity>()});
+  });
+  return true;
+}
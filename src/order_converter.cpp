@@ -0,0 +1,32 @@
+#include <chrono>
+#include <iostream>
+#include <string_view>
+#include "csv_order_parser.h"
+#include "linux/file_map.h"
+#include "order_file.h"
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <csv file> <order file>\n";
+    exit(-1);
+  }
+
+  FileMap csv(argv[1]);
+  const std::string_view text{reinterpret_cast<const char*>(csv.Data().data()),
+                              csv.Data().size()};
+
+  OrderFileWriter writer(argv[2]);
+
+  const auto start = std::chrono::steady_clock::now();
+
+  const uint64_t malformed = ParseCsvOrders(
+      text, [&writer](const Order& order) { writer.Write(order); });
+  writer.Close();
+
+  const auto end = std::chrono::steady_clock::now();
+  const double seconds = std::chrono::duration<double>(end - start).count();
+
+  std::cout << "converted " << writer.Count() << " orders, skipped "
+            << malformed << " malformed lines in " << seconds << " s ("
+            << (writer.Count() + malformed) / seconds << " lines/s)" << '\n';
+}
@@ -0,0 +1,107 @@
+#include "order_file.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "error.h"
+
+namespace {
+OrderFileHeader ReadHeader(std::span<const uint8_t> file) {
+  OrderFileHeader header;
+  std::memcpy(&header, file.data(), sizeof(header));
+  return header;
+}
+}  // namespace
+
+bool IsOrderFile(std::span<const uint8_t> file) {
+  return file.size() >= sizeof(OrderFileHeader) and
+         std::memcmp(ReadHeader(file).Magic, kOrderFileMagic,
+                     sizeof(kOrderFileMagic)) == 0;
+}
+
+std::span<const uint8_t> OrderFileRecords(std::span<const uint8_t> file) {
+  if (!IsOrderFile(file)) {
+    throw std::runtime_error("not an order file");
+  }
+
+  const OrderFileHeader header = ReadHeader(file);
+
+  if (header.Version != kOrderFileVersion or
+      header.RecordSize != sizeof(Order)) {
+    throw std::runtime_error("unsupported order file version");
+  }
+
+  const std::span<const uint8_t> records =
+      file.subspan(sizeof(OrderFileHeader));
+
+  if (records.size() != header.Count * sizeof(Order)) {
+    throw std::runtime_error("truncated order file");
+  }
+
+  return records;
+}
+
+OrderFileWriter::OrderFileWriter(std::string_view path) {
+  const std::string file_path{path};
+
+  m_fd_ = ::open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (m_fd_ == -1) {
+    throw FileOpenError();
+  }
+
+  m_buffer_.reserve(kBufferSize);
+}
+
+OrderFileWriter::~OrderFileWriter() {
+  if (m_fd_ == -1) {
+    return;
+  }
+
+  // best effort, a caller which has to know the file is whole closes it
+  try {
+    Close();
+  } catch (const BaseIOError&) {
+  }
+}
+
+void OrderFileWriter::Close() {
+  OrderFileHeader header{};
+  std::memcpy(header.Magic, kOrderFileMagic, sizeof(kOrderFileMagic));
+  header.Version = kOrderFileVersion;
+  header.RecordSize = sizeof(Order);
+  header.Count = m_count_;
+
+  // the descriptor goes either way, a failed write is not retried
+  try {
+    Flush();
+    // the header goes last, an interrupted conversion fails validation
+    WriteAt({reinterpret_cast<const uint8_t*>(&header), sizeof(header)}, 0);
+  } catch (const BaseIOError&) {
+    ::close(m_fd_);
+    m_fd_ = -1;
+    throw;
+  }
+
+  ::close(m_fd_);
+  m_fd_ = -1;
+}
+
+void OrderFileWriter::Flush() {
+  WriteAt(m_buffer_, m_offset_);
+  m_offset_ += m_buffer_.size();
+  m_buffer_.clear();
+}
+
+void OrderFileWriter::WriteAt(std::span<const uint8_t> buffer,
+                              uint64_t offset) {
+  while (!buffer.empty()) {
+    const ssize_t written =
+        ::pwrite(m_fd_, buffer.data(), buffer.size(), offset);
+    if (written <= 0) {
+      throw FileWriteError();
+    }
+    buffer = buffer.subspan(written);
+    offset += written;
+  }
+}
@@ -1,6 +1,15 @@
 import random
+import struct
 import sys
 
+# see include/order_file.h: magic, version, record size, count, reserved
+ORDER_FILE_HEADER_FORMAT = "<8sIIQ8x"
+ORDER_FILE_MAGIC = b"PTMEORD\0"
+ORDER_FILE_VERSION = 1
+# wire layout of Order: uint8 type, uint64 id, uint16 price, uint16 quantity
+ORDER_FORMAT = "<BQHH"
+ORDER_TYPES = {"B": 0, "S": 1, "C": 2}
+
 
 def generate_orders(num_orders):
     orders = []
@@ -9,25 +18,44 @@ def generate_orders(num_orders):
         order_type = random.choice(["B", "S"])
         price = random.randint(1, 255)
         quantity = random.randint(1, 65535)
-        order = f"{order_type},{unique_id},{price},{quantity}\n"
-        orders.append(order)
+        orders.append((order_type, unique_id, price, quantity))
         unique_id += 1
     return orders
 
 
 def write_orders_to_file(file_path, orders):
     with open(file_path, "w") as f:
-        f.writelines(orders)
+        f.writelines(f"{t},{i},{p},{q}\n" for t, i, p, q in orders)
+
+
+def write_binary_orders_to_file(file_path, orders):
+    with open(file_path, "wb") as f:
+        f.write(
+            struct.pack(
+                ORDER_FILE_HEADER_FORMAT,
+                ORDER_FILE_MAGIC,
+                ORDER_FILE_VERSION,
+                struct.calcsize(ORDER_FORMAT),
+                len(orders),
+            )
+        )
+        for t, i, p, q in orders:
+            f.write(struct.pack(ORDER_FORMAT, ORDER_TYPES[t], i, p, q))
 
 
 if __name__ == "__main__":
-    if len(sys.argv) != 3:
-        print("Usage: python script.py <num_orders> <output_file>")
+    if len(sys.argv) not in (3, 4) or (
+        len(sys.argv) == 4 and sys.argv[3] != "--binary"
+    ):
+        print("Usage: python script.py <num_orders> <output_file> [--binary]")
         sys.exit(1)
 
     num_orders = int(sys.argv[1])
     output_file = sys.argv[2]
 
     orders = generate_orders(num_orders)
-    write_orders_to_file(output_file, orders)
+    if len(sys.argv) == 4:
+        write_binary_orders_to_file(output_file, orders)
+    else:
+        write_orders_to_file(output_file, orders)
     print(f"{num_orders} orders generated and written to {output_file}")
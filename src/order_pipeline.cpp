@@ -0,0 +1,58 @@
+#include "order_pipeline.h"
+#include <algorithm>
+#include <cassert>
+
+// zero initialized, so the ring is paged in before the first order
+OrderPipeline::OrderPipeline() : m_queue_{std::make_unique<OrderQueue>()} {}
+
+bool OrderPipeline::Valid(const Order& order) noexcept {
+  switch (order.OrderType()) {
+    case kBuy:
+    case kSell:
+      return order.Quantity() > 0;
+    case kCancel:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void OrderPipeline::Publish(std::span<const uint8_t> buffer) noexcept {
+  assert(buffer.size() % sizeof(Order) == 0);
+
+  union {
+    const uint8_t* raw;
+    const Order* order;
+  } msg;
+
+  msg.raw = buffer.data();
+  const std::span<const Order> orders{msg.order,
+                                      buffer.size() / sizeof(Order)};
+
+  // runs of valid orders go into the ring as they are, only the invalid
+  // ones in between are skipped
+  uint64_t run_start = 0;
+
+  for (uint64_t i = 0; i < orders.size(); ++i) {
+    if (!Valid(orders[i])) [[unlikely]] {
+      Sequence(orders.subspan(run_start, i - run_start));
+      ++m_rejected_;
+      run_start = i + 1;
+    }
+  }
+  Sequence(orders.subspan(run_start));
+}
+
+void OrderPipeline::Sequence(std::span<const Order> orders) noexcept {
+  // larger than the ring only if the caller's buffer is, pushed in parts
+  while (!orders.empty()) {
+    const std::span<const Order> part =
+        orders.first(std::min<uint64_t>(orders.size(), OrderQueue::kCapacity));
+
+    while (!m_queue_->TryPush(part)) {
+    }
+
+    m_sequenced_ += part.size();
+    orders = orders.subspan(part.size());
+  }
+}
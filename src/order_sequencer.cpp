@@ -0,0 +1,26 @@
+#include "order_sequencer.h"
+#include <algorithm>
+#include <cassert>
+
+OrderSequencer::OrderSequencer()
+    : m_queue_{std::make_unique<OrderQueue>()} {}
+
+void OrderSequencer::Publish(std::span<const uint8_t> buffer) noexcept {
+  assert(buffer.size() % sizeof(Order) == 0);
+
+  union {
+    const uint8_t* raw;
+    const Order* order;
+  } msg;
+
+  msg.raw = buffer.data();
+  std::span<const Order> orders{msg.order, buffer.size() / sizeof(Order)};
+
+  while (!orders.empty()) {
+    const std::span<const Order> part =
+        orders.first(std::min<uint64_t>(orders.size(), kMaxClaim));
+
+    m_queue_->Push(part);
+    orders = orders.subspan(part.size());
+  }
+}
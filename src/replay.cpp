@@ -0,0 +1,207 @@
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "command_line.h"
+#include "engine.h"
+#include "engine_interface.h"
+#include "heap_based_engine.h"
+#include "latency_summary.h"
+#include "linux/file_map.h"
+#include "linux/perf_counters.h"
+#include "order.h"
+#include "order_file.h"
+#include "order_handler.h"
+
+namespace {
+// counts trades instead of sending them anywhere
+class CountingObserver {
+ public:
+  bool Send(std::span<const TradeResult> results) noexcept {
+    m_trade_count_ += results.size();
+    return true;
+  }
+
+  uint64_t TradeCount() const { return m_trade_count_; }
+
+ private:
+  uint64_t m_trade_count_{0};
+};
+
+using Clock = std::chrono::steady_clock;
+
+uint64_t ElapsedNs(Clock::time_point start, Clock::time_point end) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+      .count();
+}
+
+void PrintPerf(std::string_view op,
+               const PerfCounters& counters,
+               uint64_t op_count) {
+  const PerfReading reading = counters.Read();
+
+  auto print = [](std::optional<double> value) {
+    if (value) {
+      std::cout << *value;
+    } else {
+      std::cout << "n/a";
+    }
+  };
+
+  std::cout << op << " per op: ";
+  for (uint32_t i = 0; i < kPerfEventCount; ++i) {
+    const PerfEvent event = static_cast<PerfEvent>(i);
+    std::cout << PerfEventName(event) << ": ";
+    print(reading.PerOp(event, op_count));
+    std::cout << ", ";
+  }
+  std::cout << "ipc: ";
+  print(reading.Ipc());
+  std::cout << '\n';
+}
+}  // namespace
+
+/**
+ * two passes over the same orders, each on a fresh engine
+ * 1 the whole file in a single handler call, for throughput
+ * 2 one handler call per order, for the per order latency distribution
+ */
+template <Engine_t Engine>
+void Replay(std::string_view name, std::span<const uint8_t> orders) {
+  const uint64_t order_count = orders.size() / sizeof(Order);
+
+  std::cout << "engine: " << name << '\n';
+
+  {
+    auto engine = std::make_unique<Engine>();
+    CountingObserver observer;
+    OrderHandler handler{*engine, observer};
+
+    const auto start = Clock::now();
+    handler(orders);
+    const auto end = Clock::now();
+
+    const double seconds = ElapsedNs(start, end) / 1e9;
+
+    std::cout << "orders: " << order_count
+              << ", trades: " << observer.TradeCount() << '\n';
+    std::cout << "throughput: " << order_count / seconds << " orders/s, "
+              << observer.TradeCount() / seconds << " trades/s" << '\n';
+    std::cout << "engine: " << engine->Stats() << '\n';
+  }
+
+  {
+    auto engine = std::make_unique<Engine>();
+    CountingObserver observer;
+    OrderHandler handler{*engine, observer};
+
+    std::vector<uint64_t> samples;
+    samples.reserve(order_count);
+
+    for (uint64_t i = 0; i < order_count; ++i) {
+      const auto start = Clock::now();
+      handler(orders.subspan(i * sizeof(Order), sizeof(Order)));
+      const auto end = Clock::now();
+
+      samples.push_back(ElapsedNs(start, end));
+    }
+
+    std::cout << "latency (ns): " << Summarize(samples) << '\n';
+  }
+}
+
+/**
+ * a third pass straight on the engine, AddOrder (or Cancel) and Execute are
+ * each counted by their own perf_event group, enabled just around the call
+ */
+template <Engine_t Engine>
+void ReplayPerf(std::span<const uint8_t> orders) {
+  const uint64_t order_count = orders.size() / sizeof(Order);
+
+  union {
+    const uint8_t* data;
+    const Order* order;
+    const BuyOrder* buy_order;
+    const SellOrder* sell_order;
+    const CancelOrder* cancel_order;
+  } msg;
+  msg.data = orders.data();
+
+  auto engine = std::make_unique<Engine>();
+  PerfCounters add_counters;
+  PerfCounters execute_counters;
+
+  if (!add_counters.Available()) {
+    std::cout << "perf counters unavailable, " << add_counters.Error()
+              << '\n';
+    return;
+  }
+
+  uint64_t execute_count = 0;
+
+  for (uint64_t i = 0; i < order_count; ++i) {
+    add_counters.Enable();
+    switch (msg.order[i].OrderType()) {
+      case kBuy:
+        engine->AddOrder(msg.buy_order[i]);
+        break;
+      case kSell:
+        engine->AddOrder(msg.sell_order[i]);
+        break;
+      case kCancel:
+        engine->Cancel(msg.cancel_order[i]);
+        add_counters.Disable();
+        continue;
+      default:
+        break;
+    }
+    add_counters.Disable();
+
+    execute_counters.Enable();
+    engine->Execute();
+    execute_counters.Disable();
+    ++execute_count;
+  }
+
+  PrintPerf("AddOrder/Cancel", add_counters, order_count);
+  PrintPerf("Execute", execute_counters, execute_count);
+}
+
+int main(int argc, char** argv) {
+  const std::string_view engine_name =
+      argc > 2 and argv[2][0] != '-' ? argv[2] : "all";
+
+  if (argc < 2 or (engine_name != "sorted" and engine_name != "heap" and
+                   engine_name != "all")) {
+    std::cerr << "Usage: " << argv[0]
+              << " <order file> [sorted | heap | all] [--perf]\n";
+    exit(-1);
+  }
+  const bool perf = HasFlag(argc, argv, "--perf");
+
+  FileMap file(argv[1]);
+  const std::span<const uint8_t> orders = OrderFileRecords(file.Data());
+
+  if (orders.empty()) {
+    std::cerr << "order file is empty\n";
+    exit(-1);
+  }
+
+  if (engine_name == "sorted" or engine_name == "all") {
+    Replay<Engine>("Engine", orders);
+    if (perf) {
+      ReplayPerf<Engine>(orders);
+    }
+  }
+
+  if (engine_name == "heap" or engine_name == "all") {
+    Replay<HeapBasedEngine>("HeapBasedEngine", orders);
+    if (perf) {
+      ReplayPerf<HeapBasedEngine>(orders);
+    }
+  }
+}
@@ -0,0 +1,136 @@
+#include "replication.h"
+#include <iostream>
+#include <stdexcept>
+
+ReplicationPublisher::ReplicationPublisher(std::string_view host,
+                                           uint16_t port) {
+  SetSocketReusable(m_listen_sock_);
+
+  m_listen_sock_.Bind(host, port);
+  m_listen_sock_.Listen(1);
+
+  std::cout << "waiting for replication follower on port " << port << '\n';
+  m_follower_sock_ = m_listen_sock_.Accept();
+  m_connected_ = true;
+  std::cout << "replication follower connected" << '\n';
+}
+
+void ReplicationPublisher::Publish(std::span<const uint8_t> orders) noexcept {
+  if (!m_connected_) [[unlikely]] {
+    return;
+  }
+
+  Send(replication::kOrders, orders);
+  m_sequence_ += orders.size() / sizeof(Order);
+}
+
+void ReplicationPublisher::Checkpoint(uint64_t state_hash) noexcept {
+  if (!m_connected_ or m_sequence_ < m_next_checkpoint_) [[likely]] {
+    return;
+  }
+
+  const replication::Checkpoint checkpoint{.Sequence = m_sequence_,
+                                           .StateHash = state_hash};
+
+  m_history_[m_history_count_++ % kHistorySize] = checkpoint;
+  m_next_checkpoint_ = m_sequence_ + replication::kCheckpointInterval;
+
+  Send(replication::kCheckpoint,
+       {reinterpret_cast<const uint8_t*>(&checkpoint), sizeof(checkpoint)});
+
+  VerifyEchoes();
+}
+
+void ReplicationPublisher::Send(uint8_t type,
+                                std::span<const uint8_t> payload) noexcept {
+  const replication::MessageHeader header{
+      .Type = type, .Length = static_cast<uint32_t>(payload.size())};
+
+  // one syscall per message, copying a batch is cheaper than a second send
+  m_send_buffer_.resize(sizeof(header) + payload.size());
+  std::memcpy(m_send_buffer_.data(), &header, sizeof(header));
+  std::memcpy(m_send_buffer_.data() + sizeof(header), payload.data(),
+              payload.size());
+
+  std::span<const uint8_t> pending{m_send_buffer_};
+
+  while (!pending.empty()) {
+    const int byte_sent = m_follower_sock_.Send(pending);
+
+    if (byte_sent <= 0) {
+      Disconnect();
+      return;
+    }
+    pending = pending.subspan(byte_sent);
+  }
+}
+
+void ReplicationPublisher::VerifyEchoes() noexcept {
+  while (1) {
+    const int byte_recv = m_follower_sock_.TryRecv(
+        {m_echo_buffer_.data() + m_echo_offset_,
+         m_echo_buffer_.size() - m_echo_offset_});
+
+    if (byte_recv <= 0) {
+      return;
+    }
+
+    const uint32_t len = m_echo_offset_ + byte_recv;
+    const uint32_t count = len / sizeof(replication::Checkpoint);
+
+    for (uint32_t i = 0; i < count; ++i) {
+      replication::Checkpoint echo;
+      std::memcpy(&echo, m_echo_buffer_.data() + i * sizeof(echo),
+                  sizeof(echo));
+
+      const auto found = std::ranges::find_if(
+          m_history_, [&](const replication::Checkpoint& checkpoint) {
+            return checkpoint.Sequence == echo.Sequence;
+          });
+
+      if (found != std::end(m_history_) and
+          found->StateHash != echo.StateHash) [[unlikely]] {
+        std::cerr << "follower diverged at sequence " << echo.Sequence
+                  << '\n';
+      }
+    }
+
+    m_echo_offset_ = len % sizeof(replication::Checkpoint);
+    std::memmove(m_echo_buffer_.data(),
+                 m_echo_buffer_.data() + (len - m_echo_offset_),
+                 m_echo_offset_);
+  }
+}
+
+void ReplicationPublisher::Disconnect() noexcept {
+  std::cerr << "replication follower lost, continuing without standby"
+            << '\n';
+  m_follower_sock_.Close();
+  m_connected_ = false;
+}
+
+ReplicationFollower::ReplicationFollower(std::string_view host,
+                                         uint16_t port) {
+  SetSocketNoDelay(m_primary_sock_);
+
+  if (!m_primary_sock_.Connect(host, port)) {
+    throw std::runtime_error("unable to connect to replication primary");
+  }
+  std::cout << "following primary on port " << port << '\n';
+}
+
+void ReplicationFollower::Verify(const replication::Checkpoint& checkpoint,
+                                 uint64_t state_hash) {
+  if (checkpoint.Sequence != m_sequence_ or
+      checkpoint.StateHash != state_hash) [[unlikely]] {
+    ++m_divergences_;
+    std::cerr << "state diverged from primary at sequence "
+              << checkpoint.Sequence << '\n';
+  }
+
+  const replication::Checkpoint echo{.Sequence = m_sequence_,
+                                     .StateHash = state_hash};
+
+  m_primary_sock_.Send(
+      {reinterpret_cast<const uint8_t*>(&echo), sizeof(echo)});
+}
@@ -0,0 +1,4 @@
+#include "shm_transport.h"
+
+ShmTransport::ShmTransport(std::string_view path, bool adaptive_wait)
+    : m_ring_{path}, m_idle_wait_{adaptive_wait} {}
@@ -0,0 +1,46 @@
+#include "tcp_transport.h"
+#include <cerrno>
+#include <iostream>
+#include <utility>
+
+TcpTransport::TcpTransport(std::string host, uint16_t port, bool shared_port)
+    : m_sessions_{std::move(host), port, shared_port} {}
+
+bool TcpTransport::ReadOnce(uint32_t index) {
+  // less than an order is ever left behind, so there is always room
+  switch (m_sessions_.ReadOnce(index)) {
+    case TcpSessions<TcpSession>::kRead:
+      return true;
+    case TcpSessions<TcpSession>::kEnded:
+      m_sessions_.Close(index);
+      return false;
+    default:
+      return false;
+  }
+}
+
+int64_t TcpTransport::Send(uint64_t session, std::span<const uint8_t> buffer) {
+  const int64_t index = m_sessions_.Find(session);
+  if (index < 0) {
+    return -1;
+  }
+
+  const int byte_sent = m_sessions_[index].Sock.Send(buffer);
+
+  if (byte_sent < 0 and (errno == EAGAIN or errno == EWOULDBLOCK)) {
+    return 0;
+  }
+
+  if (byte_sent < 0) [[unlikely]] {
+    m_sessions_.Close(index);
+    return -1;
+  }
+  return byte_sent;
+}
+
+void TcpTransport::Disconnect(uint64_t session) {
+  if (const int64_t index = m_sessions_.Find(session); index >= 0) {
+    std::cout << "disconnecting session " << index << '\n';
+    m_sessions_.Close(index);
+  }
+}
@@ -0,0 +1,166 @@
+#include <time.h>
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "command_line.h"
+#include "latency_stats.h"
+#include "linux/file_map.h"
+#include "trace_ring.h"
+
+namespace {
+std::string_view ReasonName(uint8_t reason) {
+  switch (reason) {
+    case kTraceDumpRequested:
+      return "requested";
+    case kTraceDumpSpike:
+      return "spike";
+    case kTraceDumpExit:
+      return "exit";
+  }
+  return "unknown";
+}
+
+// UTC, nanosecond precision
+std::string FormatWallTime(int64_t wall_ns) {
+  const time_t seconds = wall_ns / 1'000'000'000;
+  struct tm utc;
+  gmtime_r(&seconds, &utc);
+
+  char buffer[64];
+  const size_t len = std::strftime(buffer, sizeof(buffer), "%F %T", &utc);
+  std::snprintf(buffer + len, sizeof(buffer) - len, ".%09ld",
+                static_cast<long>(wall_ns % 1'000'000'000));
+  return buffer;
+}
+
+struct DecodeOptions {
+  ID_t OrderId;    // 0 for every order
+  uint64_t MinNs;  // orders spanning less are not printed
+};
+
+/**
+ * one line per order: wall clock time of its first stage, then every stage
+ * as the offset from that time and the time it took
+ */
+void DecodeDump(const TraceDumpHeader& header,
+                std::span<const TraceEvent> events,
+                const DecodeOptions& options) {
+  auto to_ns = [&header](uint64_t ticks) {
+    return static_cast<int64_t>(ticks / header.TicksPerNs);
+  };
+  auto to_wall_ns = [&](uint64_t tsc) {
+    return header.BaseWallNs + to_ns(tsc - header.BaseTsc);
+  };
+
+  std::vector<ID_t> order_ids;
+  std::unordered_map<ID_t, std::vector<TraceEvent>> timelines;
+  uint64_t batch_count = 0;
+  uint64_t slowest_batch = 0;
+
+  // a batch is recorded after its orders, but started before them
+  uint64_t earliest = UINT64_MAX;
+  uint64_t latest = 0;
+
+  for (const TraceEvent& event : events) {
+    earliest = std::min<uint64_t>(earliest, event.StartTsc);
+    latest = std::max<uint64_t>(latest, event.StartTsc + event.Ticks);
+
+    if (event.EventStage == Stage::kBatch) {
+      ++batch_count;
+      slowest_batch = std::max<uint64_t>(slowest_batch, event.Ticks);
+      continue;
+    }
+
+    auto [timeline, inserted] = timelines.try_emplace(event.OrderId);
+    if (inserted) {
+      order_ids.push_back(event.OrderId);
+    }
+    timeline->second.push_back(event);
+  }
+
+  std::cout << "dump: " << ReasonName(header.Reason) << ", "
+            << header.Count << " events";
+  if (!events.empty()) {
+    std::cout << " from " << FormatWallTime(to_wall_ns(earliest)) << " to "
+              << FormatWallTime(to_wall_ns(latest));
+  }
+  std::cout << ", " << batch_count << " batches, slowest "
+            << to_ns(slowest_batch) << " ns" << '\n';
+
+  for (const ID_t id : order_ids) {
+    if (options.OrderId != 0 and id != options.OrderId) {
+      continue;
+    }
+
+    const std::vector<TraceEvent>& timeline = timelines[id];
+    const uint64_t first = timeline.front().StartTsc;
+    const uint64_t last = timeline.back().StartTsc + timeline.back().Ticks;
+
+    if (static_cast<uint64_t>(to_ns(last - first)) < options.MinNs) {
+      continue;
+    }
+
+    std::cout << "order " << id << " at " << FormatWallTime(to_wall_ns(first));
+    for (const TraceEvent& event : timeline) {
+      std::cout << ", " << StageName(event.EventStage) << " +"
+                << to_ns(event.StartTsc - first) << " ns "
+                << to_ns(event.Ticks) << " ns";
+    }
+    std::cout << '\n';
+  }
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0]
+              << " <trace dump file> [--order <id>] [--min-ns <ns>]\n";
+    exit(-1);
+  }
+
+  const auto order_id = FlagValue(argc, argv, "--order");
+  const auto min_ns = FlagValue(argc, argv, "--min-ns");
+
+  const DecodeOptions options{
+      .OrderId = order_id.empty() ? 0 : std::stoull(std::string{order_id}),
+      .MinNs = min_ns.empty() ? 0 : std::stoull(std::string{min_ns})};
+
+  FileMap file(argv[1]);
+  std::span<const uint8_t> data = file.Data();
+
+  while (!data.empty()) {
+    TraceDumpHeader header;
+
+    if (data.size() < sizeof(header)) {
+      std::cerr << "truncated dump header" << '\n';
+      exit(-1);
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (std::memcmp(header.Magic, kTraceDumpMagic, sizeof(header.Magic)) !=
+            0 or
+        header.Version != kTraceDumpVersion) {
+      std::cerr << "not a trace dump" << '\n';
+      exit(-1);
+    }
+
+    const uint64_t len = header.Count * sizeof(TraceEvent);
+    if (data.size() - sizeof(header) < len) {
+      std::cerr << "truncated dump" << '\n';
+      exit(-1);
+    }
+
+    // the events are packed, copied out rather than read in place
+    std::vector<TraceEvent> events(header.Count);
+    std::memcpy(events.data(), data.data() + sizeof(header), len);
+
+    DecodeDump(header, events, options);
+
+    data = data.subspan(sizeof(header) + len);
+  }
+}
@@ -0,0 +1,135 @@
+#include "trace_ring.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+bool WriteAll(int fd, const void* data, uint64_t len) {
+  const uint8_t* cursor = static_cast<const uint8_t*>(data);
+
+  while (len > 0) {
+    const ssize_t written = ::write(fd, cursor, len);
+    if (written <= 0) {
+      return false;
+    }
+    cursor += written;
+    len -= written;
+  }
+  return true;
+}
+}  // namespace
+
+TraceRing::TraceRing(std::string_view dump_path, uint64_t spike_ns)
+    : m_events_{std::make_unique<TraceEvent[]>(kCapacity)},
+      m_snapshot_{std::make_unique<TraceEvent[]>(kCapacity)},
+      m_dump_path_{dump_path} {
+  // zero initialized above, so both are paged in before the first event
+  m_ticks_per_ns_ = CalibrateTsc();
+
+  m_spike_ticks_ = spike_ns * m_ticks_per_ns_;
+  m_spike_cooldown_ticks_ = 1'000'000'000 * m_ticks_per_ns_;
+
+  m_base_tsc_ = ReadTsc();
+  m_base_wall_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count();
+
+  m_writer_ = std::thread([this] { WriteSnapshots(); });
+}
+
+TraceRing::~TraceRing() {
+  while (1) {
+    SnapshotState state = kIdle;
+    if (m_snapshot_state_.compare_exchange_weak(state, kStopping)) {
+      break;
+    }
+    m_snapshot_state_.wait(kTaken, std::memory_order_acquire);
+  }
+
+  m_snapshot_state_.notify_all();
+  m_writer_.join();
+}
+
+bool TraceRing::Dump(uint8_t reason) noexcept {
+  const uint64_t head = m_head_.load(std::memory_order_acquire);
+  const uint64_t count = head < kCapacity ? head : kCapacity;
+  const uint64_t oldest = (head - count) & (kCapacity - 1);
+
+  // the oldest events run to the end of the ring, the rest wrap to the front
+  const uint64_t first = std::min(count, kCapacity - oldest);
+
+  return Write(reason, {m_events_.get() + oldest, first},
+               {m_events_.get(), count - first});
+}
+
+void TraceRing::WaitForDump() const noexcept {
+  m_snapshot_state_.wait(kTaken, std::memory_order_acquire);
+}
+
+bool TraceRing::Snapshot(uint8_t reason) noexcept {
+  if (m_snapshot_state_.load(std::memory_order_acquire) != kIdle) {
+    return false;
+  }
+
+  const uint64_t head = m_head_.load(std::memory_order_relaxed);
+  const uint64_t count = head < kCapacity ? head : kCapacity;
+  const uint64_t oldest = (head - count) & (kCapacity - 1);
+  const uint64_t first = std::min(count, kCapacity - oldest);
+
+  // a plain copy, the writer's file i/o stays off the matching thread
+  std::memcpy(m_snapshot_.get(), m_events_.get() + oldest,
+              first * sizeof(TraceEvent));
+  std::memcpy(m_snapshot_.get() + first, m_events_.get(),
+              (count - first) * sizeof(TraceEvent));
+
+  m_snapshot_count_ = count;
+  m_snapshot_reason_ = reason;
+
+  m_snapshot_state_.store(kTaken, std::memory_order_release);
+  m_snapshot_state_.notify_all();
+  return true;
+}
+
+void TraceRing::WriteSnapshots() noexcept {
+  while (1) {
+    m_snapshot_state_.wait(kIdle, std::memory_order_acquire);
+
+    if (m_snapshot_state_.load(std::memory_order_acquire) == kStopping) {
+      return;
+    }
+
+    Write(m_snapshot_reason_, {m_snapshot_.get(), m_snapshot_count_}, {});
+
+    m_snapshot_state_.store(kIdle, std::memory_order_release);
+    m_snapshot_state_.notify_all();
+  }
+}
+
+bool TraceRing::Write(uint8_t reason,
+                      std::span<const TraceEvent> older,
+                      std::span<const TraceEvent> newer) const noexcept {
+  TraceDumpHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.Magic, kTraceDumpMagic, sizeof(header.Magic));
+  header.Version = kTraceDumpVersion;
+  header.Reason = reason;
+  header.Count = older.size() + newer.size();
+  header.BaseTsc = m_base_tsc_;
+  header.BaseWallNs = m_base_wall_ns_;
+  header.TicksPerNs = m_ticks_per_ns_;
+
+  const int fd =
+      ::open(m_dump_path_.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (fd == -1) {
+    return false;
+  }
+
+  const bool written = WriteAll(fd, &header, sizeof(header)) and
+                       WriteAll(fd, older.data(), older.size_bytes()) and
+                       WriteAll(fd, newer.data(), newer.size_bytes());
+
+  ::close(fd);
+  return written;
+}
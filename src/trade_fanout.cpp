@@ -0,0 +1,201 @@
+#include "trade_fanout.h"
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+TradeFanout::TradeFanout(std::string_view host,
+                         uint16_t port,
+                         uint64_t log_trades)
+    : m_log_{log_trades * sizeof(TradeResult)} {
+  SetSocketReusable(m_server_fd_);
+  SetSocketNonBlocking(m_server_fd_);
+
+  m_server_fd_.Bind(host, port);
+  m_server_fd_.Listen(kMaxSubscribers);
+
+  m_epoll_.Add(m_server_fd_.Fd(), kListenerTag);
+
+  std::cout << "trade subscribers connect on port " << port << '\n';
+}
+
+bool TradeFanout::Send(std::span<const TradeResult> results) noexcept {
+  assert(results.size_bytes() <= m_log_.Len());
+
+  const uint64_t head = m_head_.load(std::memory_order_relaxed);
+  const uint64_t len = results.size_bytes();
+
+  // announced before the first byte is overwritten, readers check it
+  // after their send to tell whether what they sent was intact
+  m_reserved_.store(head + len, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  // never split, the second mapping continues the first
+  std::memcpy(m_log_.Data() + head % m_log_.Len(), results.data(), len);
+
+  m_head_.store(head + len, std::memory_order_release);
+  return true;
+}
+
+void TradeFanout::Run() {
+  while (1) {
+    Poll();
+  }
+}
+
+bool TradeFanout::Poll() {
+  std::array<epoll_event, kMaxSubscribers + 1> events;
+
+  const int event_count = m_epoll_.Wait(events, 0);
+
+  for (int i = 0; i < event_count; ++i) {
+    if (events[i].data.u64 == kListenerTag) {
+      AcceptAll();
+    } else {
+      OnEvent(events[i].data.u64, events[i].events);
+    }
+  }
+
+  bool sent = false;
+
+  for (Subscriber& subscriber : m_subscribers_) {
+    if (!subscriber.Open) {
+      continue;
+    }
+
+    // a blocked one is never sent to, so it is checked here
+    if (Lapped(subscriber)) [[unlikely]] {
+      Drop(subscriber, "lapped by the trade log");
+      continue;
+    }
+
+    if (!subscriber.Blocked) {
+      sent |= Flush(subscriber);
+    }
+  }
+  return sent;
+}
+
+void TradeFanout::AcceptAll() {
+  while (auto conn = m_server_fd_.TryAccept()) {
+    uint32_t index = 0;
+    while (index < kMaxSubscribers and m_subscribers_[index].Open) {
+      ++index;
+    }
+
+    if (index == kMaxSubscribers) [[unlikely]] {
+      std::cout << "subscriber limit reached, rejecting connection" << '\n';
+      conn->Close();
+      continue;
+    }
+
+    const uint64_t head = m_head_.load(std::memory_order_acquire);
+    const uint64_t behind = m_log_.Len() / 2;
+
+    Subscriber& subscriber = m_subscribers_[index];
+    subscriber.Sock = *conn;
+    subscriber.Open = true;
+    subscriber.Blocked = false;
+    // half the log is a whole number of trades as the log is
+    subscriber.Cursor = head > behind ? head - behind : 0;
+    ++m_subscriber_count_;
+
+    const uint64_t sequence = subscriber.Cursor / sizeof(TradeResult);
+    if (subscriber.Sock.Send({reinterpret_cast<const uint8_t*>(&sequence),
+                              sizeof(sequence)}) != sizeof(sequence))
+        [[unlikely]] {
+      subscriber.Sock.Close();
+      subscriber.Open = false;
+      --m_subscriber_count_;
+      continue;
+    }
+
+    m_epoll_.Add(subscriber.Sock.Fd(), index, true);
+
+    std::cout << "trade subscriber " << index << " starts at trade "
+              << sequence << '\n';
+  }
+}
+
+void TradeFanout::OnEvent(uint32_t index, uint32_t events) {
+  Subscriber& subscriber = m_subscribers_[index];
+
+  if (!subscriber.Open) {
+    return;
+  }
+
+  if (events & EPOLLOUT) {
+    subscriber.Blocked = false;
+  }
+
+  if (!(events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))) {
+    return;
+  }
+
+  // subscribers have nothing to say, whatever they send is dropped, the
+  // end of their stream ends the subscription
+  std::array<uint8_t, 256> discard;
+  while (1) {
+    const int byte_recv = subscriber.Sock.TryRecv(discard);
+
+    if (byte_recv < 0 and (errno == EAGAIN or errno == EWOULDBLOCK)) {
+      return;
+    }
+
+    if (byte_recv <= 0) {
+      Drop(subscriber, "disconnected");
+      return;
+    }
+  }
+}
+
+bool TradeFanout::Flush(Subscriber& subscriber) {
+  const uint64_t head = m_head_.load(std::memory_order_acquire);
+
+  if (subscriber.Cursor == head) {
+    return false;
+  }
+
+  const int byte_sent = subscriber.Sock.Send(
+      {m_log_.Data() + subscriber.Cursor % m_log_.Len(),
+       head - subscriber.Cursor});
+
+  if (byte_sent < 0 and (errno == EAGAIN or errno == EWOULDBLOCK)) {
+    subscriber.Blocked = true;
+    return false;
+  }
+
+  if (byte_sent <= 0) [[unlikely]] {
+    Drop(subscriber, "disconnected");
+    return false;
+  }
+
+  // the writer may have started on the bytes while they were copied out
+  if (Lapped(subscriber)) [[unlikely]] {
+    Drop(subscriber, "lapped by the trade log");
+    return false;
+  }
+
+  subscriber.Cursor += byte_sent;
+  return true;
+}
+
+bool TradeFanout::Lapped(const Subscriber& subscriber) const {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return m_reserved_.load(std::memory_order_relaxed) - subscriber.Cursor >
+         m_log_.Len();
+}
+
+void TradeFanout::Drop(Subscriber& subscriber, std::string_view reason) {
+  std::cout << "dropping trade subscriber "
+            << &subscriber - m_subscribers_.data() << ", " << reason
+            << " at trade " << subscriber.Cursor / sizeof(TradeResult)
+            << '\n';
+
+  m_epoll_.Remove(subscriber.Sock.Fd());
+  subscriber.Sock.Close();
+
+  subscriber.Open = false;
+  --m_subscriber_count_;
+  ++m_dropped_count_;
+}
@@ -1,13 +1,32 @@
 #include "trade_observer.h"
+#include <sys/socket.h>
 #include <algorithm>
-#include <cassert>
 #include <iostream>
-#include <ranges>
+#include <stdexcept>
+#include "error.h"
+
+TradeObserver::TradeObserver(std::string_view host, uint16_t port)
+    : m_owned_queue_{std::make_unique<TradeQueue>()},
+      m_queue_{*m_owned_queue_} {
+  Connect(host, port);
+}
 
 TradeObserver::TradeObserver(std::string_view host,
                              uint16_t port,
-                             uint32_t queue_size)
-    : m_queue_(queue_size) {
+                             TradeQueue& queue)
+    : m_queue_{queue} {
+  Connect(host, port);
+}
+
+TradeObserver::TradeObserver(std::string_view shm_path)
+    : m_shm_ring_{std::make_unique<ShmTradeRing>(shm_path)},
+      m_queue_{m_shm_ring_->GetRing()} {
+  std::cout << "trades go to " << shm_path << '\n';
+}
+
+void TradeObserver::Connect(std::string_view host, uint16_t port) {
+  m_client_sock_ = TcpSocket();
+
   std::cout << "connecting to trade observer" << '\n';
   if (!m_client_sock_.Connect(host, port)) {
     throw std::runtime_error("unable to connect to trade observer");
@@ -16,45 +35,137 @@ TradeObserver::TradeObserver(std::string_view host,
 }
 
 bool TradeObserver::Send(std::span<const TradeResult> results) noexcept {
-  while (m_flag_.test_and_set(std::memory_order_relaxed)) {
+  if (results.size() <= TradeQueue::kCapacity) [[likely]] {
+    return m_queue_.TryPush(results);
   }
 
-  if (results.size() + m_count_ > m_queue_.size()) [[unlikely]] {
-    m_flag_.clear();
-    return false;
+  // e.g. one aggressor sweeping more resting orders than the queue holds,
+  // it could never go in whole, so it goes in parts as the queue drains
+  while (!results.empty()) {
+    const std::span<const TradeResult> part = results.first(
+        std::min<uint64_t>(results.size(), TradeQueue::kCapacity));
+
+    while (!m_queue_.TryPush(part)) {
+    }
+    results = results.subspan(part.size());
   }
+  return true;
+}
 
-  std::ranges::copy(std::begin(results), std::end(results),
-                    std::begin(m_queue_) + m_count_);
+void TradeObserver::Run() {
+  if (m_shm_ring_) {
+    return;
+  }
 
-  m_count_ += results.size();
-  m_flag_.clear();
+  while (1) {
+    const std::span<const TradeResult> pending = m_queue_.Front();
 
-  return true;
+    if (!pending.empty()) {
+      if (m_ring_) {
+        SendZeroCopy(pending);
+      } else {
+        SendAll(pending);
+      }
+      m_queue_.Pop(pending.size());
+    }
+  }
 }
 
-void TradeObserver::Run() {
+void TradeObserver::EnableIoUring(bool sqpoll) {
+  if (m_shm_ring_) {
+    return;
+  }
+
+  // a single send is in flight at a time
+  auto ring = std::make_unique<IoUring>(4, sqpoll);
+
+  // zero copy sends came with 6.0, the ring itself sets up from 5.11
+  if (!ring->Supports(IORING_OP_SEND_ZC)) {
+    throw IoUringOpUnsupportedError();
+  }
+
+  const int fd = m_client_sock_.Fd();
+  ring->RegisterFiles({&fd, 1});
+
+  const std::span<const std::byte> storage = m_queue_.Storage();
+  ring->RegisterBuffer(storage.data(), storage.size());
+
+  m_ring_ = std::move(ring);
+}
+
+void TradeObserver::SendAll(std::span<const TradeResult> results) {
   union {
     const TradeResult* result;
     const uint8_t* buffer;
   } msg;
 
-  msg.result = m_queue_.data();
+  msg.result = results.data();
+  uint64_t remaining = results.size_bytes();
 
-  while (1) {
-    while (m_flag_.test_and_set(std::memory_order_relaxed)) {
+  // the slots are only handed back once the socket took all of them
+  while (remaining > 0) {
+    const int byte_sent = m_client_sock_.Send({msg.buffer, remaining});
+
+    if (byte_sent <= 0) {
+      throw std::runtime_error("unable to send to trade observer");
+    }
+    msg.buffer += byte_sent;
+    remaining -= byte_sent;
+  }
+}
+
+void TradeObserver::SendZeroCopy(std::span<const TradeResult> results) {
+  union {
+    const TradeResult* result;
+    const uint8_t* buffer;
+  } msg;
+
+  msg.result = results.data();
+  const uint64_t len = results.size_bytes();
+
+  uint64_t sent = 0;
+  bool in_flight = false;
+  // the kernel may still read the slots until every send is notified
+  uint32_t notifications = 0;
+  int error = 0;
+
+  while (sent < len or in_flight or notifications > 0) {
+    if (!in_flight and sent < len) {
+      io_uring_sqe* sqe = m_ring_->GetSqe();
+
+      sqe->opcode = IORING_OP_SEND_ZC;
+      sqe->fd = 0;
+      sqe->flags = IOSQE_FIXED_FILE;
+      sqe->ioprio = IORING_RECVSEND_FIXED_BUF;
+      sqe->buf_index = 0;
+      sqe->addr = reinterpret_cast<uint64_t>(msg.buffer + sent);
+      sqe->len = len - sent;
+      sqe->msg_flags = MSG_WAITALL | MSG_NOSIGNAL;
+
+      m_ring_->Submit();
+      in_flight = true;
     }
 
-    if (m_count_ > 0) {
-      const int byte_sent =
-          m_client_sock_.Send({msg.buffer, sizeof(TradeResult) * m_count_});
+    m_ring_->ForEachCqe([&](const io_uring_cqe& cqe) {
+      if (cqe.flags & IORING_CQE_F_NOTIF) {
+        --notifications;
+        return;
+      }
 
-      if (byte_sent <= 0) {
-        throw std::runtime_error("unable to send to trade observer");
+      if (cqe.flags & IORING_CQE_F_MORE) {
+        ++notifications;
       }
-      m_count_ = 0;
-    }
 
-    m_flag_.clear();
+      in_flight = false;
+      if (cqe.res <= 0) {
+        error = cqe.res;
+        return;
+      }
+      sent += cqe.res;
+    });
+
+    if (error != 0) [[unlikely]] {
+      throw std::runtime_error("unable to send to trade observer");
+    }
   }
 }
@@ -3,22 +3,52 @@
 #include <cstdio>
 #include <cstring>
 #include <iostream>
-#include <vector>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "command_line.h"
+#include "idle_wait.h"
 #include "linux/tcp.h"
+#include "trade_observer.h"
 #include "trade_result.h"
 
-int main() {
-  TcpSocket server_fd;
+namespace {
+void Print(const TradeResult& result) {
+  std::printf(
+      "buy id: %ld, sell id: %ld, buy price: %d, sell price: %d, "
+      "quantity: "
+      "%d\n",
+      result.BuyId, result.SellId, result.BuyPrice, result.SellPrice,
+      result.Quantity);
+}
 
-  SetSocketReusable(server_fd);
-  SetSocketNoDelay(server_fd);
+// trades straight from the matching engine's queue in shared memory
+void ConsumeSharedMemory(std::string_view path, bool adaptive_wait) {
+  ShmTradeRing ring(path);
+  IdleWait idle_wait(adaptive_wait);
 
-  server_fd.Bind("127.0.0.1", 8765);
-  server_fd.Listen(5);
+  std::cout << "reading trades from " << path << '\n';
 
-  std::array<uint8_t, 8192> buffer;
+  while (1) {
+    const std::span<const TradeResult> pending = ring.GetRing().Front();
+
+    if (pending.empty()) {
+      idle_wait.Idle();
+      continue;
+    }
+    idle_wait.Reset();
 
-  std::vector<TradeResult> all_results;
+    for (const TradeResult& result : pending) {
+      Print(result);
+    }
+    ring.GetRing().Pop(pending.size());
+  }
+}
+
+// prints the trades of one connection until it ends
+void PrintTrades(TcpSocket conn) {
+  std::array<uint8_t, 8192> buffer;
 
   union {
     const uint8_t* buf;
@@ -30,33 +60,83 @@ int main() {
   int offset = 0;
 
   while (1) {
-    TcpSocket conn = server_fd.Accept();
+    const int byte_recv =
+        conn.Recv({buffer.data() + offset, buffer.size() - offset}) + offset;
 
-    while (1) {
-      const int byte_recv =
-          conn.Recv({buffer.data() + offset, buffer.size() - offset}) + offset;
+    if (byte_recv <= 0) {
+      break;
+    }
+
+    const int count = byte_recv / sizeof(TradeResult);
+    const int trancated_len = byte_recv % sizeof(TradeResult);
+
+    for (int i = 0; i < count; ++i) {
+      const TradeResult& result = msg.result[i];
+
+      Print(result);
+    }
 
-      if (byte_recv <= 0) {
-        break;
-      }
+    std::memcpy(buffer.data(), buffer.data() + (byte_recv - trancated_len),
+                trancated_len);
+    offset = trancated_len;
+  }
+  conn.Close();
+}
 
-      const int count = byte_recv / sizeof(TradeResult);
-      const int trancated_len = byte_recv % sizeof(TradeResult);
+// one of the subscribers of a matching engine run with --fanout
+void Subscribe(uint16_t port) {
+  TcpSocket conn;
 
-      for (int i = 0; i < count; ++i) {
-        const TradeResult& result = msg.result[i];
+  // the engine only listens once it has started
+  while (!conn.Connect("127.0.0.1", port)) {
+    conn.Close();
+    conn = TcpSocket();
+    std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  }
 
-        std::printf(
-            "buy id: %ld, sell id: %ld, buy price: %d, sell price: %d, "
-            "quantity: "
-            "%d\n",
-            result.BuyId, result.SellId, result.BuyPrice, result.SellPrice,
-            result.Quantity);
-      }
+  uint64_t sequence;
+  uint64_t received = 0;
+  while (received < sizeof(sequence)) {
+    const int byte_recv = conn.Recv(
+        {reinterpret_cast<uint8_t*>(&sequence) + received,
+         sizeof(sequence) - received});
 
-      std::memcpy(buffer.data(), buffer.data() + (byte_recv - trancated_len),
-                  trancated_len);
-      offset = trancated_len;
+    if (byte_recv <= 0) {
+      std::cerr << "trade fanout closed the connection" << '\n';
+      return;
     }
+    received += byte_recv;
+  }
+
+  std::cout << "subscribed from trade " << sequence << '\n';
+  PrintTrades(conn);
+  std::cout << "subscription ended" << '\n';
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  // e.g. /dev/shm/matching_engine_trades, as given to the matching engine
+  if (const auto path = FlagValue(argc, argv, "--shm"); !path.empty()) {
+    ConsumeSharedMemory(path,
+                        FlagValue(argc, argv, "--shm-wait") == "adaptive");
+    return 0;
+  }
+
+  // e.g. 8766, as given to the matching engine's --fanout
+  if (const auto port = FlagValue(argc, argv, "--subscribe"); !port.empty()) {
+    Subscribe(std::stoi(std::string{port}));
+    return 0;
+  }
+
+  TcpSocket server_fd;
+
+  SetSocketReusable(server_fd);
+  SetSocketNoDelay(server_fd);
+
+  server_fd.Bind("127.0.0.1", 8765);
+  server_fd.Listen(5);
+
+  while (1) {
+    PrintTrades(server_fd.Accept());
   }
 }
@@ -0,0 +1,21 @@
+#include "tsc.h"
+#include <thread>
+
+double CalibrateTsc(std::chrono::milliseconds duration) {
+  using Clock = std::chrono::steady_clock;
+
+  const auto clock_start = Clock::now();
+  const uint64_t tsc_start = ReadTsc();
+
+  std::this_thread::sleep_for(duration);
+
+  const auto clock_end = Clock::now();
+  const uint64_t tsc_end = ReadTsc();
+
+  const auto elapsed_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(clock_end -
+                                                           clock_start)
+          .count();
+
+  return static_cast<double>(tsc_end - tsc_start) / elapsed_ns;
+}
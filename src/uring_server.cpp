@@ -0,0 +1,232 @@
+#include "uring_server.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include "error.h"
+
+UringServer::UringServer(std::string host,
+                         uint16_t port,
+                         RecvCallBack recv_callback,
+                         bool sqpoll)
+    : m_recv_callback_{recv_callback},
+      m_ring_{2 * kMaxSessions, sqpoll},
+      m_pool_{std::make_unique<BufferPool>()},
+      m_sessions_{std::make_unique<Session[]>(kMaxSessions)} {
+  // closed again on failure, the plain server falls back to the port
+  try {
+    SetSocketReusable(m_server_fd_);
+    SetSocketNoDelay(m_server_fd_);
+
+    // registered before binding, so a kernel refusing any of it leaves the
+    // port free for the plain server
+    std::array<int, kMaxSessions + 1> files;
+    files.fill(-1);
+    files[kListenerSlot] = m_server_fd_.Fd();
+
+    m_ring_.RegisterFiles(files);
+    m_ring_.SetFileAllocRange(0, kMaxSessions);
+
+    m_ring_.RegisterBufferRing(
+        reinterpret_cast<io_uring_buf_ring*>(m_pool_->Ring), kBufferCount,
+        kBufferGroup);
+
+    m_server_fd_.Bind(host, port);
+    m_server_fd_.Listen(kMaxSessions);
+  } catch (const BaseIOError&) {
+    m_server_fd_.Close();
+    throw;
+  }
+
+  for (uint32_t i = 0; i < kBufferCount; ++i) {
+    ProvideBuffer(i);
+  }
+
+  ArmAccept();
+  m_ring_.Submit();
+}
+
+void UringServer::Run() {
+  while (1) {
+    Poll(-1);
+  }
+}
+
+void UringServer::Poll(int timeout_ms) {
+  m_ring_.SubmitAndWait(timeout_ms);
+
+  m_ring_.ForEachCqe([this](const io_uring_cqe& cqe) {
+    const uint32_t slot = cqe.user_data & UINT32_MAX;
+
+    switch (cqe.user_data >> 32) {
+      case kAccept:
+        OnAccept(cqe);
+        break;
+      case kRecv:
+        OnRecv(slot, cqe);
+        break;
+      case kClose:
+        OnClose();
+        break;
+      default:
+        break;
+    }
+  });
+
+  // re-armed requests and returned buffers
+  m_ring_.Submit();
+}
+
+io_uring_sqe* UringServer::NextSqe() {
+  io_uring_sqe* sqe = m_ring_.GetSqe();
+
+  while (sqe == nullptr) [[unlikely]] {
+    m_ring_.Submit();
+    sqe = m_ring_.GetSqe();
+  }
+  return sqe;
+}
+
+void UringServer::ArmAccept() {
+  io_uring_sqe* sqe = NextSqe();
+
+  sqe->opcode = IORING_OP_ACCEPT;
+  sqe->fd = kListenerSlot;
+  sqe->flags = IOSQE_FIXED_FILE;
+  sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+  // the kernel picks a free slot in the alloc range
+  sqe->file_index = IORING_FILE_INDEX_ALLOC;
+  sqe->user_data = Tag(kAccept, kListenerSlot);
+
+  m_accepting_ = true;
+}
+
+void UringServer::ArmRecv(uint32_t slot) {
+  io_uring_sqe* sqe = NextSqe();
+
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = slot;
+  sqe->flags = IOSQE_FIXED_FILE | IOSQE_BUFFER_SELECT;
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->buf_group = kBufferGroup;
+  sqe->user_data = Tag(kRecv, slot);
+}
+
+void UringServer::CloseSession(uint32_t slot) {
+  io_uring_sqe* sqe = NextSqe();
+
+  sqe->opcode = IORING_OP_CLOSE;
+  // direct descriptors are closed by slot plus one
+  sqe->file_index = slot + 1;
+  sqe->user_data = Tag(kClose, slot);
+
+  m_sessions_[slot].Open = false;
+  --m_session_count_;
+}
+
+void UringServer::ProvideBuffer(uint16_t buffer_id) {
+  io_uring_buf& buffer = m_pool_->Ring[m_buffer_tail_ & (kBufferCount - 1)];
+
+  buffer.addr = reinterpret_cast<uint64_t>(m_pool_->Buffers[buffer_id]);
+  buffer.len = kBufferSize;
+  buffer.bid = buffer_id;
+
+  // the ring's tail overlays the reserved field of its first entry
+  auto* ring = reinterpret_cast<io_uring_buf_ring*>(m_pool_->Ring);
+  std::atomic_ref<uint16_t>(ring->tail).store(++m_buffer_tail_,
+                                              std::memory_order_release);
+}
+
+void UringServer::OnAccept(const io_uring_cqe& cqe) {
+  if (cqe.res == -ENFILE) [[unlikely]] {
+    // the table is full and the connection stays in the backlog, an accept
+    // now would fail straight away, OnClose accepts again once a slot is
+    // free
+    std::cout << "session limit reached, connection left pending" << '\n';
+    m_accepting_ = false;
+    return;
+  }
+
+  if (!(cqe.flags & IORING_CQE_F_MORE)) [[unlikely]] {
+    ArmAccept();
+  }
+
+  if (cqe.res < 0) [[unlikely]] {
+    return;
+  }
+
+  const uint32_t slot = cqe.res;
+
+  Session& session = m_sessions_[slot];
+  session.Open = true;
+  session.CarryLen = 0;
+  ++m_session_count_;
+
+  ArmRecv(slot);
+}
+
+void UringServer::OnClose() {
+  // the slot is free only now that the close has completed
+  if (!m_accepting_) {
+    ArmAccept();
+  }
+}
+
+void UringServer::OnRecv(uint32_t slot, const io_uring_cqe& cqe) {
+  Session& session = m_sessions_[slot];
+
+  if (cqe.flags & IORING_CQE_F_BUFFER) {
+    const uint16_t buffer_id = cqe.flags >> IORING_CQE_BUFFER_SHIFT;
+
+    if (cqe.res > 0 and session.Open) [[likely]] {
+      Deliver(session, {m_pool_->Buffers[buffer_id],
+                        static_cast<uint64_t>(cqe.res)});
+    }
+    ProvideBuffer(buffer_id);
+  }
+
+  if (cqe.flags & IORING_CQE_F_MORE) [[likely]] {
+    return;
+  }
+
+  if (!session.Open) {
+    return;
+  }
+
+  // end of stream or a broken connection
+  if (cqe.res == 0 or (cqe.res < 0 and cqe.res != -ENOBUFS)) {
+    CloseSession(slot);
+    return;
+  }
+
+  // the kernel stopped the recv, e.g. it ran out of buffers or the
+  // completion queue filled up, data keeps queueing in the socket
+  ArmRecv(slot);
+}
+
+void UringServer::Deliver(Session& session, std::span<const uint8_t> data) {
+  if (session.CarryLen > 0) {
+    const uint64_t missing = sizeof(Order) - session.CarryLen;
+    const uint64_t take = std::min<uint64_t>(missing, data.size());
+
+    std::memcpy(session.Carry + session.CarryLen, data.data(), take);
+    session.CarryLen += take;
+    data = data.subspan(take);
+
+    if (session.CarryLen < sizeof(Order)) {
+      return;
+    }
+    m_recv_callback_({session.Carry, sizeof(Order)});
+    session.CarryLen = 0;
+  }
+
+  const uint64_t whole = data.size() - data.size() % sizeof(Order);
+  if (whole > 0) [[likely]] {
+    m_recv_callback_(data.first(whole));
+  }
+
+  session.CarryLen = data.size() - whole;
+  std::memcpy(session.Carry, data.data() + whole, session.CarryLen);
+}
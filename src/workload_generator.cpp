@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "command_line.h"
+#include "order.h"
+#include "order_file.h"
+
+/**
+ * order flow shaped like a real book rather than uniform noise
+ *
+ * the mid price follows a gaussian random walk, passive orders rest a
+ * geometrically distributed number of ticks away from the touch, sizes
+ * cluster on round lots with a lognormal tail, a share of the flow cancels
+ * random resting orders and another share crosses the spread
+ *
+ * an order file has no timestamps, so a burst is a run of aggressive orders
+ * on one side which drags the mid along with it, like a sweep after news
+ */
+namespace {
+
+constexpr double kMid = 1 << 15;
+// keeps every generated price inside Price_t
+constexpr double kMidMargin = 4096;
+constexpr Quantity_t kRoundLot = 100;
+
+struct Scenario {
+  double MidVolatility;   // standard deviation of the mid per order, in ticks
+  double TouchDecay;      // the larger, the closer passive orders rest
+  double CancelRatio;     // share of the flow cancelling a resting order
+  double AggressorRatio;  // share of the flow crossing the spread
+  uint32_t BurstEvery;    // orders between bursts, 0 disables them
+  uint32_t BurstLength;   // aggressive orders in a burst
+};
+
+constexpr Scenario kSteady{.MidVolatility = 0.05,
+                           .TouchDecay = 0.4,
+                           .CancelRatio = 0.3,
+                           .AggressorRatio = 0.05,
+                           .BurstEvery = 0,
+                           .BurstLength = 0};
+
+constexpr Scenario kVolatile{.MidVolatility = 0.5,
+                             .TouchDecay = 0.2,
+                             .CancelRatio = 0.4,
+                             .AggressorRatio = 0.15,
+                             .BurstEvery = 0,
+                             .BurstLength = 0};
+
+constexpr Scenario kBursty{.MidVolatility = 0.1,
+                           .TouchDecay = 0.4,
+                           .CancelRatio = 0.3,
+                           .AggressorRatio = 0.05,
+                           .BurstEvery = 10'000,
+                           .BurstLength = 200};
+
+struct FlowCount {
+  uint64_t Passive{0};
+  uint64_t Aggressive{0};
+  uint64_t Cancel{0};
+};
+
+class WorkloadGenerator {
+ public:
+  WorkloadGenerator(const Scenario& scenario, uint64_t seed)
+      : m_scenario_{scenario}, m_random_{seed} {}
+
+  Order Next() {
+    StepMid();
+
+    if (m_burst_left_ > 0) {
+      --m_burst_left_;
+      m_mid_ += m_burst_side_ == kBuy ? 1.0 : -1.0;
+      return Aggressive(m_burst_side_);
+    }
+
+    if (m_scenario_.BurstEvery > 0 and
+        ++m_since_burst_ >= m_scenario_.BurstEvery) {
+      m_since_burst_ = 0;
+      m_burst_left_ = m_scenario_.BurstLength;
+      m_burst_side_ = RandomSide();
+    }
+
+    const double roll = m_uniform_(m_random_);
+
+    if (roll < m_scenario_.CancelRatio and !m_live_.empty()) {
+      return Cancel();
+    }
+
+    if (roll < m_scenario_.CancelRatio + m_scenario_.AggressorRatio) {
+      return Aggressive(RandomSide());
+    }
+
+    return Passive(RandomSide());
+  }
+
+  const FlowCount& Count() const { return m_count_; }
+
+ private:
+  struct LiveOrder {
+    ID_t Id;
+    Price_t Price;
+  };
+
+  void StepMid() {
+    m_mid_ += std::normal_distribution<double>{
+        0.0, m_scenario_.MidVolatility}(m_random_);
+    m_mid_ = std::clamp(m_mid_, kMidMargin, 65535 - kMidMargin);
+  }
+
+  Price_t Touch() const { return static_cast<Price_t>(std::lround(m_mid_)); }
+
+  Order Passive(OrderType_t side) {
+    const int offset =
+        1 + std::geometric_distribution<int>{m_scenario_.TouchDecay}(m_random_);
+    const int price = side == kBuy ? Touch() - offset : Touch() + offset;
+
+    const Price_t clamped = std::clamp(price, 1, 65535);
+    m_live_.push_back(LiveOrder{.Id = m_next_id_, .Price = clamped});
+    ++m_count_.Passive;
+
+    return Order(side, m_next_id_++, clamped, Size());
+  }
+
+  // priced through the touch, sweeping a few levels on the other side
+  Order Aggressive(OrderType_t side) {
+    const int sweep = 1 + std::geometric_distribution<int>{0.5}(m_random_);
+    const int price = side == kBuy ? Touch() + sweep : Touch() - sweep;
+
+    ++m_count_.Aggressive;
+
+    return Order(side, m_next_id_++, std::clamp(price, 1, 65535), Size());
+  }
+
+  // a random earlier order, which may already have been filled
+  Order Cancel() {
+    const uint64_t index =
+        std::uniform_int_distribution<uint64_t>{0, m_live_.size() - 1}(
+            m_random_);
+    const LiveOrder order = m_live_[index];
+
+    m_live_[index] = m_live_.back();
+    m_live_.pop_back();
+    ++m_count_.Cancel;
+
+    return CancelOrder(order.Id, order.Price);
+  }
+
+  // mostly a few round lots, otherwise an odd lot from a lognormal tail
+  Quantity_t Size() {
+    if (m_uniform_(m_random_) < 0.7) {
+      const int lots = 1 + std::geometric_distribution<int>{0.5}(m_random_);
+      return std::min(lots * kRoundLot, 65535);
+    }
+
+    const double size =
+        std::lognormal_distribution<double>{4.0, 1.0}(m_random_);
+    return static_cast<Quantity_t>(std::clamp(std::round(size), 1.0, 65535.0));
+  }
+
+  OrderType_t RandomSide() {
+    return m_uniform_(m_random_) < 0.5 ? kBuy : kSell;
+  }
+
+ private:
+  Scenario m_scenario_;
+  std::mt19937_64 m_random_;
+  std::uniform_real_distribution<double> m_uniform_{0.0, 1.0};
+
+  double m_mid_{kMid};
+  ID_t m_next_id_{1};
+  std::vector<LiveOrder> m_live_;
+
+  uint32_t m_since_burst_{0};
+  uint32_t m_burst_left_{0};
+  OrderType_t m_burst_side_{kBuy};
+
+  FlowCount m_count_;
+};
+
+bool SelectScenario(std::string_view name, Scenario& scenario) {
+  if (name == "steady") {
+    scenario = kSteady;
+  } else if (name == "volatile") {
+    scenario = kVolatile;
+  } else if (name == "bursty") {
+    scenario = kBursty;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// overrides `value` with the flag's argument when the flag is given
+template <class T>
+void Override(int argc, char** argv, std::string_view flag, T& value) {
+  if (const auto arg = FlagValue(argc, argv, flag); !arg.empty()) {
+    if constexpr (std::is_integral_v<T>) {
+      value = std::stoull(std::string{arg});
+    } else {
+      value = std::stod(std::string{arg});
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <num orders> <order file> "
+                 "[--scenario steady|volatile|bursty] [--seed <n>] "
+                 "[--mid-volatility <ticks>] [--touch-decay <p>] "
+                 "[--cancel-ratio <r>] [--aggressor-ratio <r>] "
+                 "[--burst-every <n>] [--burst-length <n>]\n";
+    exit(-1);
+  }
+
+  const uint64_t order_count = std::stoul(argv[1]);
+
+  const auto scenario_name = FlagValue(argc, argv, "--scenario");
+  Scenario scenario = kSteady;
+
+  if (!scenario_name.empty() and !SelectScenario(scenario_name, scenario)) {
+    std::cerr << "unknown scenario: " << scenario_name << '\n';
+    exit(-1);
+  }
+
+  Override(argc, argv, "--mid-volatility", scenario.MidVolatility);
+  Override(argc, argv, "--touch-decay", scenario.TouchDecay);
+  Override(argc, argv, "--cancel-ratio", scenario.CancelRatio);
+  Override(argc, argv, "--aggressor-ratio", scenario.AggressorRatio);
+  Override(argc, argv, "--burst-every", scenario.BurstEvery);
+  Override(argc, argv, "--burst-length", scenario.BurstLength);
+
+  uint64_t seed = 1;
+  Override(argc, argv, "--seed", seed);
+
+  WorkloadGenerator generator(scenario, seed);
+  OrderFileWriter writer(argv[2]);
+
+  const auto start = std::chrono::steady_clock::now();
+
+  for (uint64_t i = 0; i < order_count; ++i) {
+    writer.Write(generator.Next());
+  }
+  writer.Close();
+
+  const auto end = std::chrono::steady_clock::now();
+  const double seconds = std::chrono::duration<double>(end - start).count();
+
+  const FlowCount& count = generator.Count();
+  std::cout << "generated " << writer.Count() << " orders ("
+            << count.Passive << " passive, " << count.Aggressive
+            << " aggressive, " << count.Cancel << " cancels) in " << seconds
+            << " s (" << writer.Count() / seconds << " orders/s)" << '\n';
+}
@@ -9,5 +9,6 @@ class MockEngine {
  public:
   MOCK_METHOD(void, AddOrder, (const BuyOrder&), ());
   MOCK_METHOD(void, AddOrder, (const SellOrder&), ());
+  MOCK_METHOD(Quantity_t, Cancel, (const CancelOrder&), ());
   MOCK_METHOD(std::vector<TradeResult>, Execute, (), ());
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <gmock/gmock.h>
+#include <span>
 #include <vector>
 #include "trade_result.h"
 
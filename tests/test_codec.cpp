@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include "codec.h"
+#include "messages.h"
+#include "order.h"
+
+namespace {
+// the order message with a field appended in a later version
+struct OrderMessageV2
+    : Schema<1, 2, OrderType_t, ID_t, Price_t, Quantity_t, uint32_t> {
+  enum : uint32_t { kOrderType, kId, kPrice, kQuantity, kAccount };
+};
+
+void EncodeOrder(std::vector<uint8_t>& buffer, ID_t id) {
+  constexpr uint32_t kLength = Encoder<OrderMessage>::kLength;
+
+  const uint64_t offset = buffer.size();
+  buffer.resize(offset + kLength);
+
+  Encoder<OrderMessage>({buffer.data() + offset, kLength})
+      .Set<OrderMessage::kOrderType>(kSell)
+      .Set<OrderMessage::kId>(id)
+      .Set<OrderMessage::kPrice>(31)
+      .Set<OrderMessage::kQuantity>(7);
+}
+}  // namespace
+
+TEST(CodecTest, OrderBlockIsTheWireOrder) {
+  std::vector<uint8_t> buffer;
+  EncodeOrder(buffer, 42);
+
+  ASSERT_EQ(buffer.size(), sizeof(MessageHeader) + sizeof(Order));
+
+  MessageHeader header;
+  std::memcpy(&header, buffer.data(), sizeof(header));
+  EXPECT_EQ(header.TemplateId, OrderMessage::kTemplateId);
+  EXPECT_EQ(header.Version, 1);
+  EXPECT_EQ(header.BlockLength, sizeof(Order));
+
+  const auto decoder = Decoder<OrderMessage>::Wrap(buffer);
+  ASSERT_TRUE(decoder);
+  EXPECT_EQ(decoder->Get<OrderMessage::kId>(), 42);
+  EXPECT_EQ(decoder->Get<OrderMessage::kQuantity>(), 7);
+
+  // the block is what the order handler takes, without a copy
+  const SellOrder expected(ID_t{42}, Price_t{31}, Quantity_t{7});
+  ASSERT_EQ(decoder->Block().size(), sizeof(Order));
+  EXPECT_EQ(std::memcmp(decoder->Block().data(), &expected, sizeof(Order)), 0);
+  EXPECT_EQ(decoder->Block().data(), buffer.data() + sizeof(MessageHeader));
+
+  EXPECT_FALSE(Decoder<TradeResultMessage>::Wrap(buffer));
+  EXPECT_FALSE(Decoder<OrderMessage>::Wrap(std::span{buffer}.first(10)));
+}
+
+TEST(CodecTest, VersionsReadEachOther) {
+  std::vector<uint8_t> buffer(Encoder<OrderMessageV2>::kLength);
+  Encoder<OrderMessageV2>(buffer)
+      .Set<OrderMessageV2::kId>(1)
+      .Set<OrderMessageV2::kAccount>(900);
+  EncodeOrder(buffer, 2);
+
+  std::vector<std::pair<ID_t, uint32_t>> decoded;
+  std::vector<uint16_t> versions;
+
+  // an old message to a new decoder and the other way round
+  const uint64_t consumed = ForEachMessage(
+      buffer, [&](uint16_t template_id, std::span<const uint8_t> message) {
+        ASSERT_EQ(template_id, OrderMessage::kTemplateId);
+
+        const auto current = Decoder<OrderMessage>::Wrap(message);
+        const auto next = Decoder<OrderMessageV2>::Wrap(message);
+        ASSERT_TRUE(current and next);
+
+        EXPECT_EQ(current->Get<OrderMessage::kId>(),
+                  next->Get<OrderMessageV2::kId>());
+        EXPECT_EQ(current->Length(), message.size());
+
+        decoded.emplace_back(next->Get<OrderMessageV2::kId>(),
+                             next->Get<OrderMessageV2::kAccount>());
+        versions.push_back(next->Version());
+      });
+
+  EXPECT_EQ(consumed, buffer.size());
+  EXPECT_EQ(decoded, (std::vector<std::pair<ID_t, uint32_t>>{{1, 900},
+                                                             {2, 0}}));
+  EXPECT_EQ(versions, (std::vector<uint16_t>{2, 1}));
+}
+
+TEST(CodecTest, LeavesAPartialMessage) {
+  std::vector<uint8_t> buffer;
+  EncodeOrder(buffer, 1);
+  EncodeOrder(buffer, 2);
+
+  uint32_t count = 0;
+  const uint64_t consumed = ForEachMessage(
+      std::span{buffer}.first(buffer.size() - 3),
+      [&count](uint16_t, std::span<const uint8_t>) { ++count; });
+
+  EXPECT_EQ(count, 1);
+  EXPECT_EQ(consumed, Encoder<OrderMessage>::kLength);
+}
@@ -0,0 +1,228 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <span>
+#include <vector>
+#include "execution_report.h"
+#include "execution_reports.h"
+#include "mock_engine.h"
+#include "mock_observer.h"
+#include "order.h"
+#include "order_handler.h"
+#include "trade_result.h"
+
+namespace {
+// two sessions on different slots, as TcpTransport keys them
+constexpr uint64_t kFirst = uint64_t{1} << 32 | 0;
+constexpr uint64_t kSecond = uint64_t{1} << 32 | 1;
+
+class FakeSender {
+ public:
+  // at most this much per send, as a socket with a full buffer would
+  explicit FakeSender(uint64_t limit = UINT64_MAX) : m_limit_{limit} {}
+
+  int64_t Send(uint64_t session, std::span<const uint8_t> buffer) {
+    const uint64_t len = std::min<uint64_t>(buffer.size(), m_limit_);
+    auto& received = Received[session];
+    received.insert(std::end(received), buffer.data(), buffer.data() + len);
+    ++SendCount;
+    return len;
+  }
+
+  void Disconnect(uint64_t session) { Disconnected.push_back(session); }
+
+  std::vector<ExecutionReport> Reports(uint64_t session) {
+    const auto& received = Received[session];
+    std::vector<ExecutionReport> reports(received.size() /
+                                         sizeof(ExecutionReport));
+    std::memcpy(reports.data(), received.data(),
+                reports.size() * sizeof(ExecutionReport));
+    return reports;
+  }
+
+  std::map<uint64_t, std::vector<uint8_t>> Received;
+  std::vector<uint64_t> Disconnected;
+  uint32_t SendCount{0};
+
+ private:
+  uint64_t m_limit_;
+};
+
+void ExpectReport(const ExecutionReport& report,
+                  ExecType exec_type,
+                  ID_t id,
+                  Quantity_t quantity,
+                  Quantity_t leaves_quantity) {
+  EXPECT_EQ(report.ExecType, exec_type);
+  EXPECT_EQ(report.Id, id);
+  EXPECT_EQ(report.Quantity, quantity);
+  EXPECT_EQ(report.LeavesQuantity, leaves_quantity);
+}
+}  // namespace
+
+TEST(ExecutionReportsTest, FillsGoBackToTheSessionWhichPlacedTheOrder) {
+  ExecutionReports reports;
+  FakeSender sender;
+
+  reports.Accepted(kFirst, SellOrder(ID_t{5}, Price_t{30}, Quantity_t{10}));
+  reports.Accepted(kSecond, BuyOrder(ID_t{6}, Price_t{31}, Quantity_t{4}));
+  reports.Filled(TradeResult{6, 5, 31, 30, 4});
+
+  reports.Cancelled(kFirst, CancelOrder(ID_t{5}, Price_t{30}), 6);
+  // nothing left to cancel
+  reports.Cancelled(kFirst, CancelOrder(ID_t{5}, Price_t{30}), 0);
+
+  reports.Flush(sender);
+
+  // one send per session, however many reports it had
+  EXPECT_EQ(sender.SendCount, 2);
+
+  const auto first = sender.Reports(kFirst);
+  ASSERT_EQ(first.size(), 4);
+  ExpectReport(first[0], kAccepted, 5, 10, 10);
+  ExpectReport(first[1], kPartiallyFilled, 5, 4, 6);
+  EXPECT_EQ(first[1].Price, 30);
+  ExpectReport(first[2], kCancelled, 5, 6, 0);
+  ExpectReport(first[3], kRejected, 5, 0, 0);
+
+  const auto second = sender.Reports(kSecond);
+  ASSERT_EQ(second.size(), 2);
+  ExpectReport(second[0], kAccepted, 6, 4, 4);
+  ExpectReport(second[1], kFilled, 6, 4, 0);
+  EXPECT_EQ(second[1].Price, 31);
+
+  EXPECT_EQ(reports.LiveOrders(), 0);
+
+  // nothing new, nothing sent
+  reports.Flush(sender);
+  EXPECT_EQ(sender.SendCount, 2);
+}
+
+TEST(ExecutionReportsTest, KeepsWhatAFullSocketDidNotTake) {
+  ExecutionReports reports;
+  FakeSender sender(20);
+
+  for (ID_t id = 1; id <= 10; ++id) {
+    reports.Accepted(kFirst,
+                     BuyOrder(id, Price_t{30}, static_cast<Quantity_t>(id)));
+  }
+
+  for (int flush = 0; flush < 10; ++flush) {
+    reports.Flush(sender);
+  }
+
+  const auto received = sender.Reports(kFirst);
+  ASSERT_EQ(received.size(), 10);
+  for (ID_t id = 1; id <= 10; ++id) {
+    ExpectReport(received[id - 1], kAccepted, id, id, id);
+  }
+}
+
+TEST(ExecutionReportsTest, DropsEarlierSessionsAndCutsOffSlowOnes) {
+  ExecutionReports reports;
+  FakeSender sender;
+
+  reports.Accepted(kFirst, SellOrder(ID_t{5}, Price_t{30}, Quantity_t{10}));
+  reports.Flush(sender);
+
+  // a later connection on the first session's slot
+  const uint64_t next = uint64_t{2} << 32 | 0;
+  reports.Accepted(next, BuyOrder(ID_t{6}, Price_t{30}, Quantity_t{10}));
+  reports.Filled(TradeResult{6, 5, 30, 30, 10});
+  reports.Flush(sender);
+
+  EXPECT_EQ(sender.Reports(kFirst).size(), 1);
+  ASSERT_EQ(sender.Reports(next).size(), 2);
+  ExpectReport(sender.Reports(next)[1], kFilled, 6, 10, 0);
+
+  // far more than an outbox holds without a flush in between
+  for (ID_t id = 0; id < 100'000; ++id) {
+    reports.Rejected(kSecond, BuyOrder(id, Price_t{30}, Quantity_t{0}));
+  }
+  reports.Flush(sender);
+
+  EXPECT_EQ(sender.Disconnected, (std::vector<uint64_t>{kSecond}));
+  EXPECT_TRUE(sender.Reports(kSecond).empty());
+}
+
+TEST(ExecutionReportsTest, OrderHandlerAnswersEveryOrder) {
+  MockEngine mock_engine;
+  MockObserver mock_observer;
+  ExecutionReports reports;
+  FakeSender sender;
+
+  EXPECT_CALL(mock_engine, AddOrder(::testing::A<const BuyOrder&>()))
+      .Times(1);
+  EXPECT_CALL(mock_engine, AddOrder(::testing::A<const SellOrder&>()))
+      .Times(0);
+  EXPECT_CALL(mock_engine, Execute())
+      .WillOnce(::testing::Return(std::vector<TradeResult>{}));
+  EXPECT_CALL(mock_engine, Cancel(::testing::_))
+      .WillOnce(::testing::Return(Quantity_t{0}));
+
+  OrderHandler handler(mock_engine, mock_observer, NoInstrumentation{},
+                       SessionReports{reports});
+
+  const std::vector<Order> orders{
+      BuyOrder(ID_t{1}, Price_t{30}, Quantity_t{10}),
+      // an empty order never reaches the engine
+      SellOrder(ID_t{2}, Price_t{31}, Quantity_t{0}),
+      CancelOrder(ID_t{3}, Price_t{30}),
+  };
+
+  handler({reinterpret_cast<const uint8_t*>(orders.data()),
+           orders.size() * sizeof(Order)},
+          kFirst);
+  handler.Flush(sender);
+
+  const auto received = sender.Reports(kFirst);
+  ASSERT_EQ(received.size(), 3);
+  ExpectReport(received[0], kAccepted, 1, 10, 10);
+  ExpectReport(received[1], kRejected, 2, 0, 0);
+  ExpectReport(received[2], kRejected, 3, 0, 0);
+}
+
+TEST(ExecutionReportsTest, OnlyTheOwnerCancelsItsOrder) {
+  MockEngine mock_engine;
+  MockObserver mock_observer;
+  ExecutionReports reports;
+  FakeSender sender;
+
+  EXPECT_CALL(mock_engine, AddOrder(::testing::A<const BuyOrder&>()))
+      .Times(1);
+  EXPECT_CALL(mock_engine, Execute())
+      .WillOnce(::testing::Return(std::vector<TradeResult>{}));
+  // only the owner's cancel reaches the engine
+  EXPECT_CALL(mock_engine, Cancel(::testing::_))
+      .WillOnce(::testing::Return(Quantity_t{10}));
+
+  OrderHandler handler(mock_engine, mock_observer, NoInstrumentation{},
+                       SessionReports{reports});
+
+  const BuyOrder order(ID_t{1}, Price_t{30}, Quantity_t{10});
+  const CancelOrder cancel(ID_t{1}, Price_t{30});
+  auto bytes = [](const auto& message) {
+    return std::span<const uint8_t>{
+        reinterpret_cast<const uint8_t*>(&message), sizeof(Order)};
+  };
+
+  handler(bytes(order), kFirst);
+  handler(bytes(cancel), kSecond);
+  handler.Flush(sender);
+
+  ASSERT_EQ(sender.Reports(kSecond).size(), 1);
+  ExpectReport(sender.Reports(kSecond)[0], kRejected, 1, 0, 0);
+  ASSERT_EQ(sender.Reports(kFirst).size(), 1);
+  EXPECT_EQ(reports.LiveOrders(), 1);
+
+  handler(bytes(cancel), kFirst);
+  handler.Flush(sender);
+
+  const auto received = sender.Reports(kFirst);
+  ASSERT_EQ(received.size(), 2);
+  ExpectReport(received[1], kCancelled, 1, 10, 0);
+  EXPECT_EQ(reports.LiveOrders(), 0);
+}
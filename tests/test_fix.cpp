@@ -0,0 +1,301 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "execution_report.h"
+#include "fix.h"
+#include "fix_transport.h"
+#include "linux/tcp.h"
+#include "order.h"
+#include "server.h"
+
+namespace {
+constexpr uint16_t kTestPort = 15690;
+
+std::span<const uint8_t> AsBytes(std::string_view text) {
+  return {reinterpret_cast<const uint8_t*>(text.data()), text.size()};
+}
+
+std::string Finish(FixWriter& writer) {
+  std::string message(FixWriter::kMaxMessageLen, '\0');
+  message.resize(writer.Finish(reinterpret_cast<uint8_t*>(message.data())));
+  return message;
+}
+
+// a message around body as a client may send it, of any length
+std::string Frame(std::string_view body) {
+  std::string message{kFixBegin};
+  message += "9=" + std::to_string(body.size()) + '\x01';
+  message += body;
+
+  const uint8_t checksum = FixChecksum(AsBytes(message));
+  char trailer[8];
+  std::snprintf(trailer, sizeof(trailer), "10=%03u\x01", checksum);
+  return message + trailer;
+}
+
+// a tag sent twice fails the test, FIX allows each at most once
+std::map<uint32_t, std::string> Fields(std::span<const uint8_t> body) {
+  std::map<uint32_t, std::string> fields;
+  EXPECT_TRUE(ForEachFixField(body, [&](uint32_t tag, std::string_view value) {
+    EXPECT_TRUE(fields.emplace(tag, value).second) << "repeated tag " << tag;
+  }));
+  return fields;
+}
+
+// the fields of every whole message which arrives within a few polls
+std::vector<std::map<uint32_t, std::string>> ReadMessages(
+    TcpSocket& client,
+    uint32_t count,
+    auto&& poll) {
+  std::vector<std::map<uint32_t, std::string>> messages;
+  std::vector<uint8_t> buffer(1 << 16);
+  uint64_t buffered = 0;
+
+  for (int attempt = 0; attempt < 100 and messages.size() < count;
+       ++attempt) {
+    poll();
+
+    const int byte_recv = client.TryRecv(
+        {buffer.data() + buffered, buffer.size() - buffered});
+    if (byte_recv <= 0) {
+      continue;
+    }
+    buffered += byte_recv;
+
+    std::span<const uint8_t> pending{buffer.data(), buffered};
+    int64_t len;
+    while ((len = FixMessageLength(pending)) > 0) {
+      messages.push_back(Fields(FixBody(pending.first(len))));
+      pending = pending.subspan(len);
+    }
+    std::memmove(buffer.data(), pending.data(), pending.size());
+    buffered = pending.size();
+  }
+  return messages;
+}
+}  // namespace
+
+TEST(FixTest, FramesMessagesAndChecksTheirChecksum) {
+  FixWriter writer;
+  writer.Add(kFixMsgType, '0').Add(kFixMsgSeqNum, uint64_t{7});
+  const std::string message = Finish(writer);
+
+  EXPECT_EQ(message, std::string_view{"8=FIX.4.4\x01" "9=10\x01"
+                                      "35=0\x01" "34=7\x01" "10=171\x01"});
+
+  // every prefix is incomplete, not garbled
+  for (uint64_t len = 0; len < message.size(); ++len) {
+    EXPECT_EQ(FixMessageLength(AsBytes(message).first(len)), 0);
+  }
+  EXPECT_EQ(FixMessageLength(AsBytes(message + message)),
+            static_cast<int64_t>(message.size()));
+
+  const auto fields = Fields(FixBody(AsBytes(message)));
+  EXPECT_EQ(fields.at(kFixMsgType), "0");
+  EXPECT_EQ(fields.at(kFixMsgSeqNum), "7");
+
+  std::string corrupted = message;
+  corrupted[message.find("34=7") + 3] = '8';
+  EXPECT_TRUE(FixBody(AsBytes(corrupted)).empty());
+
+  EXPECT_EQ(FixMessageLength(AsBytes("8=FIX.4.2\x01" "9=5\x01")), -1);
+  EXPECT_EQ(FixMessageLength(AsBytes("8=FIX.4.4\x01" "9=x\x01")), -1);
+}
+
+TEST(FixTest, LeavesOutAFieldTheBodyHasNoRoomFor) {
+  FixWriter writer;
+  writer.Add(kFixMsgType, '0')
+      .Add(kFixTestReqId, std::string(1000, 'x'))
+      .Add(kFixMsgSeqNum, uint64_t{7});
+  const std::string message = Finish(writer);
+
+  EXPECT_EQ(writer.DroppedCount(), 1);
+  const auto fields = Fields(FixBody(AsBytes(message)));
+  EXPECT_FALSE(fields.contains(kFixTestReqId));
+  EXPECT_EQ(fields.at(kFixMsgSeqNum), "7");
+}
+
+TEST(FixTest, ScansFieldsAcrossChunks) {
+  // long enough for several sixteen byte chunks and a tail, with a value
+  // holding '=' and a field straddling a chunk boundary
+  const std::string_view body =
+      "35=D\x01" "11=123456789012\x01" "58=a=b and some more text\x01"
+      "55=PTME\x01" "54=1\x01" "38=100\x01" "40=2\x01" "44=30000\x01";
+
+  const auto fields = Fields(AsBytes(body));
+  ASSERT_EQ(fields.size(), 8);
+  EXPECT_EQ(fields.at(kFixMsgType), "D");
+  EXPECT_EQ(fields.at(kFixClOrdId), "123456789012");
+  EXPECT_EQ(fields.at(kFixText), "a=b and some more text");
+  EXPECT_EQ(fields.at(kFixSymbol), "PTME");
+  EXPECT_EQ(fields.at(kFixPrice), "30000");
+
+  const auto ignore = [](uint32_t, std::string_view) {};
+  EXPECT_FALSE(ForEachFixField(AsBytes("35=D\x01" "11\x01"), ignore));
+  EXPECT_FALSE(ForEachFixField(AsBytes("35=D\x01" "x=1\x01"), ignore));
+  EXPECT_FALSE(ForEachFixField(AsBytes("35=D\x01" "11=1"), ignore));
+}
+
+TEST(FixTest, ParsesNumbersWithoutOverflow) {
+  uint64_t value;
+
+  EXPECT_TRUE(ParseFixUint("0", value));
+  EXPECT_EQ(value, 0);
+  EXPECT_TRUE(ParseFixUint("18446744073709551615", value));
+  EXPECT_EQ(value, UINT64_MAX);
+
+  EXPECT_FALSE(ParseFixUint("18446744073709551616", value));
+  EXPECT_FALSE(ParseFixUint("", value));
+  EXPECT_FALSE(ParseFixUint("12a", value));
+  EXPECT_FALSE(ParseFixUint("-1", value));
+
+  EXPECT_TRUE(ParseFixWholePrice("100.00", value));
+  EXPECT_EQ(value, 100);
+  EXPECT_TRUE(ParseFixWholePrice("100", value));
+  EXPECT_EQ(value, 100);
+  EXPECT_FALSE(ParseFixWholePrice("100.5", value));
+}
+
+TEST(FixTest, TranslatesOrdersAndAnswersInFix) {
+  std::vector<std::pair<Order, uint64_t>> received;
+  auto collect = [&received](std::span<const uint8_t> buffer,
+                             uint64_t session) {
+    for (uint64_t offset = 0; offset < buffer.size();
+         offset += sizeof(Order)) {
+      Order order = BuyOrder(0, 0, 0);
+      std::memcpy(&order, buffer.data() + offset, sizeof(Order));
+      received.emplace_back(order, session);
+    }
+  };
+
+  BasicServer<FixTransport, decltype(collect)> server(collect, "127.0.0.1",
+                                                      kTestPort);
+  auto poll = [&server]() { server.Poll(10); };
+
+  TcpSocket client;
+  ASSERT_TRUE(client.Connect("127.0.0.1", kTestPort));
+
+  FixWriter writer;
+  auto begin = [&writer](char msg_type) -> FixWriter& {
+    return writer.Add(kFixMsgType, msg_type)
+        .Add(kFixSenderCompId, "CLIENT")
+        .Add(kFixTargetCompId, "ENGINE");
+  };
+
+  std::string messages;
+  begin('A').Add(kFixEncryptMethod, uint64_t{0}).Add(kFixHeartBtInt, "30");
+  messages += Finish(writer);
+  begin('D')
+      .Add(kFixClOrdId, uint64_t{42})
+      .Add(kFixSymbol, "PTME")
+      .Add(kFixSide, '2')
+      .Add(kFixOrderQty, uint64_t{10})
+      .Add(kFixOrdType, '2')
+      .Add(kFixPrice, "30.0");
+  messages += Finish(writer);
+  // a market order never reaches the engine
+  begin('D')
+      .Add(kFixClOrdId, uint64_t{43})
+      .Add(kFixSide, '1')
+      .Add(kFixOrderQty, uint64_t{10})
+      .Add(kFixOrdType, '1');
+  messages += Finish(writer);
+  begin('F').Add(kFixClOrdId, uint64_t{1000}).Add(kFixOrigClOrdId,
+                                                   uint64_t{42});
+  messages += Finish(writer);
+
+  // split mid message, the rest follows on the next read
+  client.Send(AsBytes(messages).first(30));
+  poll();
+  client.Send(AsBytes(messages).subspan(30));
+
+  const auto answers = ReadMessages(client, 2, poll);
+  ASSERT_EQ(answers.size(), 2);
+  EXPECT_EQ(answers[0].at(kFixMsgType), "A");
+  EXPECT_EQ(answers[0].at(kFixSenderCompId), "ENGINE");
+  EXPECT_EQ(answers[0].at(kFixTargetCompId), "CLIENT");
+  EXPECT_EQ(answers[1].at(kFixMsgType), "8");
+  EXPECT_EQ(answers[1].at(kFixClOrdId), "43");
+  EXPECT_EQ(answers[1].at(kFixExecType), "8");
+
+  ASSERT_EQ(received.size(), 2);
+  const uint64_t session = received[0].second;
+  EXPECT_EQ(received[0].first.OrderType(), kSell);
+  EXPECT_EQ(received[0].first.Id(), 42);
+  EXPECT_EQ(received[0].first.Price(), 30);
+  EXPECT_EQ(received[0].first.Quantity(), 10);
+  EXPECT_EQ(received[1].first.OrderType(), kCancel);
+  EXPECT_EQ(received[1].first.Id(), 42);
+  EXPECT_EQ(received[1].first.Price(), 30);
+
+  // the engine's answers, as ExecutionReports sends them
+  const ExecutionReport reports[] = {
+      {kAccepted, 42, 30, 10, 10},
+      {kPartiallyFilled, 42, 30, 4, 6},
+      {kCancelled, 42, 30, 6, 0},
+  };
+  FixTransport& transport = server.GetTransport();
+  ASSERT_EQ(transport.Send(session, {reinterpret_cast<const uint8_t*>(reports),
+                                     sizeof(reports)}),
+            sizeof(reports));
+
+  const auto reported = ReadMessages(client, 3, poll);
+  ASSERT_EQ(reported.size(), 3);
+  EXPECT_EQ(reported[0].at(kFixExecType), "0");
+  EXPECT_EQ(reported[0].at(kFixLeavesQty), "10");
+  EXPECT_EQ(reported[1].at(kFixExecType), "F");
+  EXPECT_EQ(reported[1].at(kFixOrdStatus), "1");
+  EXPECT_EQ(reported[1].at(kFixLastQty), "4");
+  EXPECT_EQ(reported[1].at(kFixCumQty), "4");
+  EXPECT_EQ(reported[1].at(kFixAvgPx), "30");
+  EXPECT_EQ(reported[2].at(kFixExecType), "4");
+  EXPECT_EQ(reported[2].at(kFixClOrdId), "1000");
+  EXPECT_EQ(reported[2].at(kFixOrigClOrdId), "42");
+
+  // sequence numbers carry on from the logon
+  EXPECT_EQ(reported[2].at(kFixMsgSeqNum), "5");
+
+  // the order is gone, a second cancel is turned down by the transport
+  begin('F').Add(kFixClOrdId, uint64_t{1001}).Add(kFixOrigClOrdId,
+                                                   uint64_t{42});
+  client.Send(AsBytes(Finish(writer)));
+
+  const auto turned_down = ReadMessages(client, 1, poll);
+  ASSERT_EQ(turned_down.size(), 1);
+  EXPECT_EQ(turned_down[0].at(kFixMsgType), "9");
+  EXPECT_EQ(turned_down[0].at(kFixClOrdId), "1001");
+  EXPECT_EQ(received.size(), 2);
+}
+
+TEST(FixTest, CutsShortWhatItEchoesBack) {
+  auto ignore = [](std::span<const uint8_t>, uint64_t) {};
+
+  BasicServer<FixTransport, decltype(ignore)> server(ignore, "127.0.0.1",
+                                                     kTestPort + 1);
+  auto poll = [&server]() { server.Poll(10); };
+
+  TcpSocket client;
+  ASSERT_TRUE(client.Connect("127.0.0.1", kTestPort + 1));
+
+  // far more than an answer has room for
+  const std::string test_req_id(1000, 'x');
+  const std::string messages =
+      Frame("35=A\x01" "49=CLIENT\x01" "56=ENGINE\x01" "98=0\x01"
+            "108=30\x01") +
+      Frame("35=1\x01" "49=CLIENT\x01" "56=ENGINE\x01" "112=" +
+            test_req_id + "\x01");
+  client.Send(AsBytes(messages));
+
+  const auto answers = ReadMessages(client, 2, poll);
+  ASSERT_EQ(answers.size(), 2);
+  EXPECT_EQ(answers[1].at(kFixMsgType), "0");
+  EXPECT_EQ(answers[1].at(kFixTestReqId), test_req_id.substr(0, 64));
+  client.Close();
+}
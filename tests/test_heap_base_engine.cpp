@@ -2,6 +2,7 @@
 #include <memory>
 #include "heap_based_engine.h"
 #include "order.h"
+#include "state_hash.h"
 
 TEST(HeapBasedEngineTest, SimpleBuyOrdersAddAndExecute) {
   auto engine = std::make_unique<HeapBasedEngine>();
@@ -337,3 +338,81 @@ TEST(HeapBasedEngineTest, LargeQuantityOrders) {
   EXPECT_EQ(trade_results[0].SellId, ID_t{2});
   EXPECT_EQ(trade_results[0].Quantity, Quantity_t{10000});
 }
+
+TEST(HeapBasedEngineTest, StateHashTracksRestingOrders) {
+  auto engine = std::make_unique<HeapBasedEngine>();
+  EXPECT_EQ(engine->StateHash(), uint64_t{0});
+
+  engine->AddOrder(BuyOrder(ID_t{1}, Price_t{30}, Quantity_t{20}));
+  engine->AddOrder(SellOrder(ID_t{2}, Price_t{30}, Quantity_t{15}));
+  engine->Execute();
+
+  // only the partially filled buy order is left resting
+  EXPECT_EQ(engine->StateHash(),
+            OrderHash(kBuy, ID_t{1}, Price_t{30}, Quantity_t{5}));
+
+  engine->AddOrder(SellOrder(ID_t{3}, Price_t{30}, Quantity_t{5}));
+  engine->Execute();
+
+  EXPECT_EQ(engine->StateHash(), uint64_t{0});
+}
+
+TEST(HeapBasedEngineTest, CancelRemovesRestingOrder) {
+  auto engine = std::make_unique<HeapBasedEngine>();
+
+  engine->AddOrder(BuyOrder(ID_t{1}, Price_t{30}, Quantity_t{20}));
+  engine->AddOrder(BuyOrder(ID_t{2}, Price_t{30}, Quantity_t{10}));
+  engine->AddOrder(BuyOrder(ID_t{3}, Price_t{25}, Quantity_t{5}));
+  engine->AddOrder(SellOrder(ID_t{4}, Price_t{40}, Quantity_t{7}));
+
+  EXPECT_EQ(engine->Cancel(CancelOrder(ID_t{1}, Price_t{30})), Quantity_t{20});
+  EXPECT_EQ(engine->Cancel(CancelOrder(ID_t{4}, Price_t{40})), Quantity_t{7});
+
+  // already cancelled, or not resting at that price
+  EXPECT_EQ(engine->Cancel(CancelOrder(ID_t{1}, Price_t{30})), Quantity_t{0});
+  EXPECT_EQ(engine->Cancel(CancelOrder(ID_t{3}, Price_t{30})), Quantity_t{0});
+
+  EXPECT_EQ(engine->StateHash(),
+            OrderHash(kBuy, ID_t{2}, Price_t{30}, Quantity_t{10}) ^
+                OrderHash(kBuy, ID_t{3}, Price_t{25}, Quantity_t{5}));
+
+  engine->AddOrder(SellOrder(ID_t{5}, Price_t{20}, Quantity_t{15}));
+
+  auto trade_results = engine->Execute();
+  EXPECT_EQ(trade_results.size(), 2);
+
+  // the cancelled order no longer has time priority at 30
+  EXPECT_EQ(trade_results[0].BuyId, ID_t{2});
+  EXPECT_EQ(trade_results[0].Quantity, Quantity_t{10});
+  EXPECT_EQ(trade_results[1].BuyId, ID_t{3});
+  EXPECT_EQ(trade_results[1].Quantity, Quantity_t{5});
+
+  EXPECT_EQ(engine->StateHash(), uint64_t{0});
+}
+
+TEST(HeapBasedEngineTest, StatsTrackBookShape) {
+  auto engine = std::make_unique<HeapBasedEngine>();
+
+  engine->AddOrder(BuyOrder(ID_t{1}, Price_t{30}, Quantity_t{20}));
+  engine->AddOrder(BuyOrder(ID_t{2}, Price_t{30}, Quantity_t{10}));
+  engine->AddOrder(BuyOrder(ID_t{3}, Price_t{25}, Quantity_t{5}));
+  engine->AddOrder(SellOrder(ID_t{4}, Price_t{40}, Quantity_t{7}));
+  engine->Execute();
+
+  engine->AddOrder(SellOrder(ID_t{5}, Price_t{30}, Quantity_t{25}));
+  engine->Execute();
+
+  const EngineStats stats = engine->Stats();
+
+  EXPECT_EQ(stats.AddOrders, 5);
+  EXPECT_EQ(stats.Executes, 2);
+  EXPECT_EQ(stats.Trades, 2);
+
+  // order 2 is left with 5 at 30, order 3 rests at 25
+  EXPECT_EQ(stats.BuyDepth, 2);
+  EXPECT_EQ(stats.BuyLevels, 2);
+  EXPECT_EQ(stats.SellDepth, 1);
+  EXPECT_EQ(stats.SellLevels, 1);
+
+  EXPECT_GT(stats.SiftSteps, 0);
+}
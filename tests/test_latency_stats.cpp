@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "engine.h"
+#include "instrumentation_interface.h"
+#include "latency_histogram.h"
+#include "latency_stats.h"
+#include "mock_observer.h"
+#include "order.h"
+#include "order_handler.h"
+
+TEST(LatencyStatsTest, BucketsWithinOneSixteenth) {
+  for (uint64_t value : {uint64_t{0}, uint64_t{15}, uint64_t{16},
+                         uint64_t{1000}, uint64_t{123'456'789},
+                         ~uint64_t{0}}) {
+    const uint32_t index = LatencyHistogram::BucketIndex(value);
+    ASSERT_LT(index, LatencyHistogram::kBucketCount);
+
+    const uint64_t upper = LatencyHistogram::BucketValue(index);
+    EXPECT_GE(upper, value);
+    EXPECT_LE(upper - value, value / LatencyHistogram::kSubBucketCount);
+  }
+}
+
+TEST(LatencyStatsTest, SummarizeHistogram) {
+  auto histogram = std::make_unique<LatencyHistogram>();
+
+  for (uint64_t value = 1; value <= 1000; ++value) {
+    histogram->Record(value);
+  }
+
+  const LatencySummary summary = Summarize(*histogram, 1.0);
+
+  EXPECT_EQ(summary.Count, 1000);
+  EXPECT_DOUBLE_EQ(summary.Mean, 500.5);
+  EXPECT_EQ(summary.Max, 1000);
+  EXPECT_GE(summary.P50, 500);
+  EXPECT_LE(summary.P50, 500 + 500 / 16);
+  EXPECT_GE(summary.P99, 990);
+  EXPECT_LE(summary.P99, 990 + 990 / 16);
+}
+
+namespace {
+struct CountingInstrumentation {
+  uint64_t Now() const noexcept { return 0; }
+  void Record(Stage stage, ID_t, uint64_t, uint64_t) noexcept {
+    ++(*Counts)[static_cast<uint32_t>(stage)];
+  }
+  void Poll() noexcept {}
+
+  std::vector<uint32_t>* Counts;
+};
+}  // namespace
+
+TEST(LatencyStatsTest, OrderHandlerRecordsStages) {
+  auto engine = std::make_unique<Engine>();
+  MockObserver observer;
+  EXPECT_CALL(observer, Send(::testing::_))
+      .WillRepeatedly(::testing::Return(true));
+
+  std::vector<uint32_t> counts(kStageCount);
+  OrderHandler handler{*engine, observer,
+                       CountingInstrumentation{.Counts = &counts}};
+
+  const Order orders[] = {BuyOrder(ID_t{1}, Price_t{30}, Quantity_t{20}),
+                          BuyOrder(ID_t{2}, Price_t{29}, Quantity_t{20}),
+                          CancelOrder(ID_t{2}, Price_t{29}),
+                          SellOrder(ID_t{3}, Price_t{30}, Quantity_t{20})};
+
+  handler({reinterpret_cast<const uint8_t*>(orders), sizeof(orders)});
+
+  EXPECT_EQ(counts[static_cast<uint32_t>(Stage::kBatch)], 1);
+  EXPECT_EQ(counts[static_cast<uint32_t>(Stage::kAddOrder)], 3);
+  EXPECT_EQ(counts[static_cast<uint32_t>(Stage::kCancel)], 1);
+  EXPECT_EQ(counts[static_cast<uint32_t>(Stage::kExecute)], 3);
+  EXPECT_EQ(counts[static_cast<uint32_t>(Stage::kPublish)], 1);
+}
+
+TEST(LatencyStatsTest, ResetRequestAppliedByWriter) {
+  const std::string path = ::testing::TempDir() + "latency_stats_test";
+  std::remove(path.c_str());
+
+  LatencyStats writer(path);
+  writer.Record(Stage::kExecute, 100);
+
+  LatencyStats reader(path);
+  EXPECT_EQ(reader.Summary(Stage::kExecute).Count, 1);
+
+  reader.RequestReset();
+  EXPECT_EQ(reader.Summary(Stage::kExecute).Count, 1);
+
+  writer.Poll();
+  EXPECT_EQ(reader.Summary(Stage::kExecute).Count, 0);
+
+  std::remove(path.c_str());
+}
+
+TEST(LatencyStatsTest, EngineStatsSnapshotRoundTrip) {
+  const std::string path = ::testing::TempDir() + "latency_stats_engine";
+  std::remove(path.c_str());
+
+  LatencyStats writer(path);
+  LatencyStats reader(path);
+  EXPECT_EQ(reader.EngineSnapshot().AddOrders, 0);
+
+  auto engine = std::make_unique<Engine>();
+  engine->AddOrder(BuyOrder(ID_t{1}, Price_t{30}, Quantity_t{20}));
+  engine->AddOrder(SellOrder(ID_t{2}, Price_t{40}, Quantity_t{20}));
+  writer.PublishEngineStats(engine->Stats());
+
+  const EngineStats stats = reader.EngineSnapshot();
+  EXPECT_EQ(stats.AddOrders, 2);
+  EXPECT_EQ(stats.BuyDepth, 1);
+  EXPECT_EQ(stats.SellLevels, 1);
+
+  std::remove(path.c_str());
+}
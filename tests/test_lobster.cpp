@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <string_view>
+#include <vector>
+#include "lobster.h"
+#include "order.h"
+
+TEST(LobsterTest, ParseMessages) {
+  constexpr std::string_view kText =
+      "34200.004241176,1,16113575,18,5853300,1\n"
+      "34200.025552082,3,16113575,18,5853300,1\r\n"
+      "\n"
+      "34200.1,x,1,1,1,1\n"
+      "34200.201743440,4,16120456,115,5859100,-1";
+
+  std::vector<lobster::Message> messages;
+  const uint64_t malformed = lobster::ParseMessages(
+      kText, [&messages](const lobster::Message& message) {
+        messages.push_back(message);
+      });
+
+  EXPECT_EQ(malformed, 1);
+  ASSERT_EQ(messages.size(), 3);
+
+  EXPECT_EQ(messages[0].Type, lobster::kSubmission);
+  EXPECT_EQ(messages[0].OrderId, uint64_t{16113575});
+  EXPECT_EQ(messages[0].Size, 18);
+  EXPECT_EQ(messages[0].Price, 5853300);
+  EXPECT_EQ(messages[0].Direction, 1);
+
+  EXPECT_EQ(messages[1].Type, lobster::kDeletion);
+
+  EXPECT_EQ(messages[2].Type, lobster::kExecution);
+  EXPECT_EQ(messages[2].Direction, -1);
+}
+
+TEST(LobsterTest, TranslateToOrderStream) {
+  lobster::Translator translator;
+  std::vector<Order> orders;
+
+  auto translate = [&](int type, uint64_t id, int64_t size, int64_t price,
+                       int direction) {
+    translator.Translate(
+        lobster::Message{.Type = type,
+                         .OrderId = id,
+                         .Size = size,
+                         .Price = price,
+                         .Direction = direction},
+        [&orders](const Order& order) { orders.push_back(order); });
+  };
+
+  // the first price lands on 1 << 15, one cent is one tick
+  translate(lobster::kSubmission, 1, 100, 5853300, 1);
+  translate(lobster::kSubmission, 2, 50, 5853500, -1);
+  translate(lobster::kPartialCancel, 1, 30, 5853300, 1);
+  translate(lobster::kExecution, 2, 20, 5853500, -1);
+  translate(lobster::kDeletion, 2, 30, 5853500, -1);
+  translate(lobster::kDeletion, 3, 10, 5853300, 1);
+  translate(lobster::kHiddenExecution, 0, 10, 5853300, 1);
+
+  ASSERT_EQ(orders.size(), 6);
+
+  EXPECT_EQ(orders[0].OrderType(), kBuy);
+  EXPECT_EQ(orders[0].Price(), Price_t{1 << 15});
+  EXPECT_EQ(orders[1].OrderType(), kSell);
+  EXPECT_EQ(orders[1].Price(), Price_t{(1 << 15) + 2});
+
+  // a partial cancel takes the order off and adds the rest back
+  EXPECT_EQ(orders[2].OrderType(), kCancel);
+  EXPECT_EQ(orders[2].Id(), ID_t{1});
+  EXPECT_EQ(orders[3].OrderType(), kBuy);
+  EXPECT_EQ(orders[3].Id(), ID_t{1});
+  EXPECT_EQ(orders[3].Quantity(), Quantity_t{70});
+
+  // an execution against a resting sell is a buy aggressor at its price
+  EXPECT_EQ(orders[4].OrderType(), kBuy);
+  EXPECT_GE(orders[4].Id(), lobster::Translator::kAggressorIdBase);
+  EXPECT_EQ(orders[4].Price(), Price_t{(1 << 15) + 2});
+  EXPECT_EQ(orders[4].Quantity(), Quantity_t{20});
+
+  EXPECT_EQ(orders[5].OrderType(), kCancel);
+  EXPECT_EQ(orders[5].Id(), ID_t{2});
+
+  EXPECT_EQ(translator.Count().UnknownOrders, 1);
+  EXPECT_EQ(translator.Count().Ignored, 1);
+}
@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+#include "book_depth.h"
+#include "heap_based_engine.h"
+#include "linux/udp.h"
+#include "market_data.h"
+#include "order.h"
+#include "order_handler.h"
+#include "replication.h"
+
+namespace {
+constexpr uint16_t kTestPort = 15710;
+
+std::vector<DepthLevel> Top(const BookDepth& depth,
+                            OrderType_t side,
+                            uint32_t count) {
+  std::vector<DepthLevel> levels(count);
+  levels.resize(depth.Top(side, levels));
+  return levels;
+}
+
+using LevelList = std::vector<std::pair<Price_t, uint32_t>>;
+
+LevelList Levels(std::span<const DepthLevel> levels) {
+  LevelList pairs;
+  for (const DepthLevel& level : levels) {
+    pairs.emplace_back(level.Price, level.Quantity);
+  }
+  return pairs;
+}
+
+// the datagrams a subscriber has been sent so far
+std::vector<std::vector<uint8_t>> ReceiveAll(UdpSocket& sock) {
+  std::vector<std::vector<uint8_t>> packets;
+  std::array<uint8_t, MarketDataPublisher::kMaxPacketLen> buffer;
+
+  int byte_recv;
+  while ((byte_recv = sock.TryRecv(buffer)) > 0) {
+    packets.emplace_back(buffer.data(), buffer.data() + byte_recv);
+  }
+  return packets;
+}
+
+uint16_t LevelCount(const std::vector<uint8_t>& packet) {
+  return Decoder<DepthPacketMessage>::Wrap(packet)
+      ->Get<DepthPacketMessage::kLevelCount>();
+}
+}  // namespace
+
+TEST(BookDepthTest, KeepsTheBestLevelsOfEachSide) {
+  BookDepth depth;
+
+  // across both ends of the price range and several bitmap words
+  for (const Price_t price : {0, 30, 31, 4095, 4096, 30000}) {
+    depth.Add(kBuy, price, 10);
+  }
+  depth.Add(kBuy, 31, 5);
+  for (const Price_t price : {65535, 40000, 30001, 30002}) {
+    depth.Add(kSell, price, 7);
+  }
+
+  EXPECT_EQ(Levels(Top(depth, kBuy, 3)),
+            (LevelList{{30000, 10}, {4096, 10}, {4095, 10}}));
+  EXPECT_EQ(Levels(Top(depth, kBuy, 10)).size(), 6);
+  EXPECT_EQ(Levels(Top(depth, kBuy, 10)).back().first, 0);
+  EXPECT_EQ(Levels(Top(depth, kSell, 10)),
+            (LevelList{{30001, 7}, {30002, 7}, {40000, 7}, {65535, 7}}));
+
+  const uint64_t version = depth.Version();
+
+  // a level goes once its quantity does, a cancel finds its own side
+  depth.Remove(kBuy, 30000, 10);
+  depth.Remove(30001, 7);
+  depth.Remove(31, 10);
+
+  EXPECT_EQ(Levels(Top(depth, kBuy, 2)), (LevelList{{4096, 10}, {4095, 10}}));
+  EXPECT_EQ(Levels(Top(depth, kSell, 1)), (LevelList{{30002, 7}}));
+  EXPECT_EQ(depth.Quantity(kBuy, 31), 5);
+  EXPECT_GT(depth.Version(), version);
+}
+
+TEST(BookDepthTest, FollowsTheBookThroughTheOrderHandler) {
+  auto engine = std::make_unique<HeapBasedEngine>();
+  StandbyObserver observer;
+  BookDepth depth;
+
+  OrderHandler order_handler{*engine, observer, NoInstrumentation{},
+                             DepthReports{depth}};
+
+  const std::array<Order, 6> orders{
+      BuyOrder{ID_t{1}, Price_t{30}, Quantity_t{10}},
+      BuyOrder{ID_t{2}, Price_t{29}, Quantity_t{10}},
+      SellOrder{ID_t{3}, Price_t{32}, Quantity_t{10}},
+      // takes all of 1 and rests the rest at 29
+      SellOrder{ID_t{4}, Price_t{29}, Quantity_t{15}},
+      CancelOrder{ID_t{3}, Price_t{32}},
+      // a cancel of what is not there changes nothing
+      CancelOrder{ID_t{3}, Price_t{32}},
+  };
+  order_handler({reinterpret_cast<const uint8_t*>(orders.data()),
+                 sizeof(orders)});
+
+  // the seller's remaining 5 met the buyer at 29
+  EXPECT_EQ(Levels(Top(depth, kBuy, 10)), (LevelList{{29, 5}}));
+  EXPECT_TRUE(Top(depth, kSell, 10).empty());
+}
+
+TEST(MarketDataTest, DiffsTurnWhatWasSentIntoTheLatest) {
+  BookDepth depth;
+  std::mt19937 random(7);
+
+  DepthView sent;
+  for (int round = 0; round < 2000; ++round) {
+    for (int i = 0; i < 20; ++i) {
+      const OrderType_t side = random() % 2;
+      // bids below asks, as in an uncrossed book
+      const Price_t price =
+          side == kBuy ? 100 - random() % 40 : 101 + random() % 40;
+      const Quantity_t quantity = 1 + random() % 5;
+
+      if (random() % 3 == 0 and depth.Quantity(side, price) >= quantity) {
+        depth.Remove(side, price, quantity);
+      } else {
+        depth.Add(side, price, quantity);
+      }
+    }
+
+    DepthView latest;
+    for (const OrderType_t side : {kBuy, kSell}) {
+      latest.Count[side] =
+          depth.Top(side, std::span{latest.Levels[side]}.first(5));
+    }
+
+    std::array<DepthUpdate, 4 * kMaxDepthLevels> updates;
+    const uint32_t count = DiffDepth(sent, latest, updates);
+    for (uint32_t i = 0; i < count; ++i) {
+      sent.Apply(updates[i]);
+    }
+    ASSERT_TRUE(sent == latest);
+  }
+}
+
+TEST(MarketDataTest, ConflatesABurstIntoOneUpdatePerLevel) {
+  UdpSocket subscriber;
+  subscriber.Bind("127.0.0.1", kTestPort);
+
+  MarketDataPublisher publisher("127.0.0.1", kTestPort, 5);
+  DepthFeed feed;
+
+  // a thousand changes to one level and a level which comes and goes
+  for (int i = 0; i < 1000; ++i) {
+    publisher.Book().Add(kBuy, 30, 1);
+    publisher.Book().Add(kSell, 31, 1);
+    publisher.Update();
+    publisher.Book().Remove(kSell, 31, 1);
+    publisher.Update();
+  }
+  EXPECT_TRUE(publisher.SendIncremental());
+  EXPECT_FALSE(publisher.SendIncremental());
+
+  auto packets = ReceiveAll(subscriber);
+  ASSERT_EQ(packets.size(), 1);
+  EXPECT_EQ(LevelCount(packets[0]), 1);
+  // nothing to apply it to before the first snapshot
+  EXPECT_FALSE(feed.Apply(packets[0]));
+
+  publisher.SendSnapshot();
+  packets = ReceiveAll(subscriber);
+  ASSERT_EQ(packets.size(), 1);
+  EXPECT_TRUE(feed.Apply(packets[0]));
+  EXPECT_TRUE(feed.Synced());
+  EXPECT_EQ(feed.Sequence(), 1);
+  EXPECT_EQ(Levels(feed.View().Side(kBuy)), (LevelList{{30, 1000}}));
+  EXPECT_TRUE(feed.View().Side(kSell).empty());
+
+  // only the top five levels are published, the sixth shows once one of
+  // them goes
+  for (Price_t price = 40; price < 46; ++price) {
+    publisher.Book().Add(kSell, price, 2);
+  }
+  publisher.Update();
+  publisher.SendIncremental();
+  publisher.Book().Remove(kSell, 41, 2);
+  publisher.Update();
+  publisher.SendIncremental();
+
+  for (const auto& packet : ReceiveAll(subscriber)) {
+    EXPECT_TRUE(feed.Apply(packet));
+  }
+  EXPECT_EQ(feed.Sequence(), 3);
+  EXPECT_EQ(Levels(feed.View().Side(kSell)),
+            (LevelList{{40, 2}, {42, 2}, {43, 2}, {44, 2}, {45, 2}}));
+  subscriber.Close();
+}
+
+TEST(MarketDataTest, AGapWaitsForTheNextSnapshot) {
+  UdpSocket subscriber;
+  subscriber.Bind("127.0.0.1", kTestPort + 1);
+
+  MarketDataPublisher publisher("127.0.0.1", kTestPort + 1);
+  DepthFeed feed;
+
+  publisher.SendSnapshot();
+  for (Quantity_t quantity = 1; quantity <= 3; ++quantity) {
+    publisher.Book().Add(kBuy, 30, quantity);
+    publisher.Update();
+    publisher.SendIncremental();
+  }
+
+  auto packets = ReceiveAll(subscriber);
+  ASSERT_EQ(packets.size(), 4);
+  EXPECT_TRUE(feed.Apply(packets[0]));
+  EXPECT_TRUE(feed.Apply(packets[1]));
+  // the second incremental is lost
+  EXPECT_FALSE(feed.Apply(packets[3]));
+  EXPECT_FALSE(feed.Synced());
+  EXPECT_EQ(feed.GapCount(), 1);
+
+  publisher.SendSnapshot();
+  packets = ReceiveAll(subscriber);
+  ASSERT_EQ(packets.size(), 1);
+  EXPECT_TRUE(feed.Apply(packets[0]));
+  EXPECT_EQ(feed.Sequence(), 3);
+  EXPECT_EQ(Levels(feed.View().Side(kBuy)), (LevelList{{30, 6}}));
+  subscriber.Close();
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "mpsc_ring.h"
+
+namespace {
+using Ring = MpscRing<uint64_t, 8>;
+
+std::vector<uint64_t> Drain(Ring& ring) {
+  std::vector<uint64_t> items;
+
+  for (auto pending = ring.Front(); !pending.empty(); pending = ring.Front()) {
+    items.insert(items.end(), pending.begin(), pending.end());
+    ring.Pop(pending.size());
+  }
+  return items;
+}
+}  // namespace
+
+TEST(MpscRingTest, ClaimsInOrderAndWrapsAround) {
+  auto ring = std::make_unique<Ring>();
+
+  EXPECT_EQ(ring->Push(std::vector<uint64_t>{1, 2, 3, 4, 5, 6}), 0);
+  EXPECT_EQ(Drain(*ring), (std::vector<uint64_t>{1, 2, 3, 4, 5, 6}));
+
+  // slots 6 and 7, then the front of the storage
+  EXPECT_EQ(ring->Push(std::vector<uint64_t>{7, 8, 9, 10, 11}), 6);
+  EXPECT_EQ(ring->Claimed(), 11);
+
+  const auto first = ring->Front();
+  ASSERT_EQ(first.size(), 2);
+  EXPECT_EQ(first[0], 7);
+  ring->Pop(first.size());
+
+  EXPECT_EQ(Drain(*ring), (std::vector<uint64_t>{9, 10, 11}));
+  EXPECT_EQ(ring->Size(), 0);
+}
+
+TEST(MpscRingTest, ConsumerSeesEveryBatchWholeAndInClaimOrder) {
+  auto ring = std::make_unique<MpscRing<uint64_t, 1024>>();
+  constexpr uint64_t kProducers = 4;
+  constexpr uint64_t kBatches = 5'000;
+  constexpr uint64_t kBatch = 3;
+
+  // producer p sends batches of three copies of p, p + 4, p + 8, ...
+  std::vector<std::thread> producers;
+  for (uint64_t p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&ring, p]() {
+      for (uint64_t n = 0; n < kBatches; ++n) {
+        const uint64_t item = n * kProducers + p;
+        ring->Push(std::vector<uint64_t>(kBatch, item));
+      }
+    });
+  }
+
+  std::vector<uint64_t> next(kProducers, 0);
+  uint64_t received = 0;
+
+  while (received < kProducers * kBatches * kBatch) {
+    const auto pending = ring->Front();
+    if (pending.empty()) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    for (const uint64_t item : pending) {
+      const uint64_t producer = item % kProducers;
+      ASSERT_EQ(item / kProducers, next[producer] / kBatch);
+      ++next[producer];
+    }
+    received += pending.size();
+    ring->Pop(pending.size());
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  for (const uint64_t count : next) {
+    EXPECT_EQ(count, kBatches * kBatch);
+  }
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "csv_order_parser.h"
+#include "error.h"
+#include "linux/file_map.h"
+#include "order.h"
+#include "order_file.h"
+
+TEST(OrderFileTest, ParseCsvOrders) {
+  constexpr std::string_view kText =
+      "B,1,20,12\n"
+      "S,18446744073709551615,65535,1\r\n"
+      "\n"
+      "X,3,20,12\n"
+      "B,4,70000,12\n"
+      "S,5,30,7\n"
+      "C,1,20,12";
+
+  std::vector<Order> orders;
+  const uint64_t malformed = ParseCsvOrders(
+      kText, [&orders](const Order& order) { orders.push_back(order); });
+
+  EXPECT_EQ(malformed, 2);
+  ASSERT_EQ(orders.size(), 4);
+
+  EXPECT_EQ(orders[0].OrderType(), kBuy);
+  EXPECT_EQ(orders[0].Id(), ID_t{1});
+  EXPECT_EQ(orders[0].Price(), Price_t{20});
+  EXPECT_EQ(orders[0].Quantity(), Quantity_t{12});
+
+  // 64 bit ids are kept whole
+  EXPECT_EQ(orders[1].OrderType(), kSell);
+  EXPECT_EQ(orders[1].Id(), ID_t{18446744073709551615u});
+  EXPECT_EQ(orders[1].Price(), Price_t{65535});
+
+  EXPECT_EQ(orders[2].Id(), ID_t{5});
+  EXPECT_EQ(orders[2].Quantity(), Quantity_t{7});
+
+  // a cancel carries no quantity
+  EXPECT_EQ(orders[3].OrderType(), kCancel);
+  EXPECT_EQ(orders[3].Id(), ID_t{1});
+  EXPECT_EQ(orders[3].Price(), Price_t{20});
+  EXPECT_EQ(orders[3].Quantity(), Quantity_t{0});
+}
+
+TEST(OrderFileTest, WriteAndMapRoundTrip) {
+  const std::string path = ::testing::TempDir() + "order_file_test.bin";
+
+  {
+    OrderFileWriter writer(path);
+    writer.Write(BuyOrder(ID_t{1}, Price_t{20}, Quantity_t{12}));
+    writer.Write(SellOrder(ID_t{2}, Price_t{30}, Quantity_t{15}));
+  }
+
+  FileMap file(path);
+  ASSERT_TRUE(IsOrderFile(file.Data()));
+
+  const std::span<const uint8_t> records = OrderFileRecords(file.Data());
+  ASSERT_EQ(records.size(), 2 * sizeof(Order));
+
+  const Order* orders = reinterpret_cast<const Order*>(records.data());
+  EXPECT_EQ(orders[0].OrderType(), kBuy);
+  EXPECT_EQ(orders[0].Id(), ID_t{1});
+  EXPECT_EQ(orders[1].OrderType(), kSell);
+  EXPECT_EQ(orders[1].Price(), Price_t{30});
+  EXPECT_EQ(orders[1].Quantity(), Quantity_t{15});
+}
+
+TEST(OrderFileTest, RejectsTruncatedFile) {
+  const std::string path = ::testing::TempDir() + "order_file_test.bin";
+
+  {
+    OrderFileWriter writer(path);
+    writer.Write(BuyOrder(ID_t{1}, Price_t{20}, Quantity_t{12}));
+  }
+
+  FileMap file(path);
+  EXPECT_THROW(OrderFileRecords(file.Data().first(file.Data().size() - 1)),
+               std::runtime_error);
+}
+
+TEST(OrderFileTest, FailedCloseThrowsOnlyWhenAskedFor) {
+  // every write to /dev/full fails
+  {
+    OrderFileWriter writer("/dev/full");
+    writer.Write(BuyOrder(ID_t{1}, Price_t{20}, Quantity_t{12}));
+    EXPECT_THROW(writer.Close(), FileWriteError);
+  }
+
+  // and the destructor swallows it
+  OrderFileWriter writer("/dev/full");
+  writer.Write(BuyOrder(ID_t{1}, Price_t{20}, Quantity_t{12}));
+}
@@ -161,3 +161,30 @@ TEST(EngineTest, TradeResultObserved) {
 
   handler(buffer);
 }
+
+TEST(EngineTest, CancelOrderDoesNotExecute) {
+  const CancelOrder cancel_order{ID_t{1}, Price_t{100}};
+
+  MockEngine mock_engine;
+  MockObserver mock_observer;
+
+  EXPECT_CALL(mock_engine, AddOrder(::testing::A<const BuyOrder&>())).Times(0);
+  EXPECT_CALL(mock_engine, AddOrder(::testing::A<const SellOrder&>())).Times(0);
+  EXPECT_CALL(mock_engine, Cancel(_))
+      .Times(1)
+      .WillOnce(::testing::Return(Quantity_t{40}));
+  EXPECT_CALL(mock_engine, Execute()).Times(0);
+  EXPECT_CALL(mock_observer, Send(_)).Times(0);
+
+  OrderHandler handler(mock_engine, mock_observer);
+
+  union {
+    const CancelOrder* order;
+    const uint8_t* data;
+  } msg;
+
+  msg.order = &cancel_order;
+  std::span<const uint8_t> buffer{msg.data, sizeof(cancel_order)};
+
+  handler(buffer);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <thread>
+#include <vector>
+#include "order.h"
+#include "order_pipeline.h"
+#include "order_sequencer.h"
+
+namespace {
+std::vector<uint8_t> Encode(const std::vector<Order>& orders) {
+  std::vector<uint8_t> buffer(orders.size() * sizeof(Order));
+  std::memcpy(buffer.data(), orders.data(), buffer.size());
+  return buffer;
+}
+
+// stands in for the order handler on the matching thread
+struct RecordingHandler {
+  std::vector<ID_t> Ids;
+
+  void operator()(std::span<const uint8_t> buffer) {
+    for (uint64_t offset = 0; offset < buffer.size(); offset += sizeof(Order)) {
+      Order order{kBuy, 0, 0, 0};
+      std::memcpy(&order, buffer.data() + offset, sizeof(Order));
+      Ids.push_back(order.Id());
+    }
+  }
+};
+}  // namespace
+
+TEST(OrderPipelineTest, DropsInvalidOrdersAndKeepsSequence) {
+  OrderPipeline pipeline;
+
+  const auto buffer = Encode({
+      BuyOrder(ID_t{1}, Price_t{30}, Quantity_t{10}),
+      Order(7, ID_t{2}, Price_t{30}, Quantity_t{10}),
+      SellOrder(ID_t{3}, Price_t{31}, Quantity_t{0}),
+      SellOrder(ID_t{4}, Price_t{31}, Quantity_t{5}),
+      CancelOrder(ID_t{1}, Price_t{30}),
+  });
+  pipeline.Publish(buffer);
+
+  EXPECT_EQ(pipeline.Sequenced(), 3);
+  EXPECT_EQ(pipeline.Rejected(), 2);
+
+  RecordingHandler handler;
+  EXPECT_TRUE(pipeline.RunOnce(handler));
+  EXPECT_FALSE(pipeline.RunOnce(handler));
+
+  EXPECT_EQ(handler.Ids, (std::vector<ID_t>{1, 4, 1}));
+}
+
+TEST(OrderPipelineTest, MatchingThreadSeesOrdersAcrossTheWrap) {
+  OrderPipeline pipeline;
+  RecordingHandler handler;
+
+  // three quarters of the ring twice, so the second batch wraps
+  const uint64_t batch_size = OrderPipeline::OrderQueue::kCapacity / 4 * 3;
+
+  for (ID_t first_id : {ID_t{0}, ID_t{batch_size}}) {
+    std::vector<Order> orders;
+    for (uint64_t i = 0; i < batch_size; ++i) {
+      orders.push_back(BuyOrder(first_id + i, Price_t{30}, Quantity_t{1}));
+    }
+    pipeline.Publish(Encode(orders));
+
+    while (pipeline.RunOnce(handler)) {
+    }
+  }
+
+  ASSERT_EQ(handler.Ids.size(), 2 * batch_size);
+  for (uint64_t i = 0; i < handler.Ids.size(); ++i) {
+    ASSERT_EQ(handler.Ids[i], i);
+  }
+}
+
+TEST(OrderSequencerTest, InterleavesGatewaysAndKeepsEachOnesOrder) {
+  OrderSequencer sequencer;
+  constexpr uint64_t kGateways = 3;
+  constexpr uint64_t kOrders = 30'000;
+
+  // gateway g sends the ids g, g + 3, g + 6, ... in batches of ten
+  std::vector<std::thread> gateways;
+  for (uint64_t g = 0; g < kGateways; ++g) {
+    gateways.emplace_back([&sequencer, g]() {
+      std::vector<Order> batch;
+      for (uint64_t id = g; id < kOrders; id += kGateways) {
+        batch.push_back(BuyOrder(ID_t{id}, Price_t{30}, Quantity_t{10}));
+
+        if (batch.size() == 10) {
+          sequencer.Publish(Encode(batch));
+          batch.clear();
+        }
+      }
+      sequencer.Publish(Encode(batch));
+    });
+  }
+
+  RecordingHandler handler;
+  while (handler.Ids.size() < kOrders) {
+    if (!sequencer.RunOnce(handler)) {
+      std::this_thread::yield();
+    }
+  }
+
+  for (auto& gateway : gateways) {
+    gateway.join();
+  }
+  EXPECT_EQ(sequencer.Sequenced(), kOrders);
+
+  std::vector<ID_t> next{0, 1, 2};
+  for (const ID_t id : handler.Ids) {
+    ASSERT_EQ(id, next[id % kGateways]);
+    next[id % kGateways] += kGateways;
+  }
+}
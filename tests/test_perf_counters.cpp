@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+#include "linux/perf_counters.h"
+
+TEST(PerfCountersTest, CountsOnlyWhileEnabled) {
+  PerfCounters counters;
+
+  if (!counters.Available()) {
+    // no pmu or perf_event_paranoid too strict, nothing is counted
+    EXPECT_FALSE(counters.Error().empty());
+    EXPECT_FALSE(counters.Read().Ipc().has_value());
+    GTEST_SKIP() << counters.Error();
+  }
+
+  volatile uint64_t sum = 0;
+
+  counters.Enable();
+  for (uint64_t i = 0; i < 1'000'000; ++i) {
+    sum = sum + i;
+  }
+  counters.Disable();
+
+  const PerfReading enabled = counters.Read();
+
+  for (uint64_t i = 0; i < 1'000'000; ++i) {
+    sum = sum + i;
+  }
+
+  const PerfReading disabled = counters.Read();
+
+  const auto instructions = static_cast<uint32_t>(PerfEvent::kInstructions);
+  ASSERT_TRUE(enabled.Values[instructions].has_value());
+  EXPECT_GT(*enabled.Values[instructions], 1'000'000u);
+  EXPECT_EQ(*disabled.Values[instructions], *enabled.Values[instructions]);
+}
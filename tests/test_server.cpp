@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include "error.h"
+#include "file_replay_transport.h"
+#include "linux/mirrored_buffer.h"
+#include "linux/tcp.h"
+#include "order.h"
+#include "order_file.h"
+#include "server.h"
+#include "uring_server.h"
+
+namespace {
+constexpr uint16_t kTestPort = 15678;
+
+std::vector<uint8_t> Encode(const Order& order) {
+  std::vector<uint8_t> buffer(sizeof(Order));
+  std::memcpy(buffer.data(), &order, sizeof(Order));
+  return buffer;
+}
+
+ID_t DecodeId(std::span<const uint8_t> buffer, uint64_t index) {
+  Order order{kBuy, 0, 0, 0};
+  std::memcpy(&order, buffer.data() + index * sizeof(Order), sizeof(Order));
+  return order.Id();
+}
+
+// both sessions are served at once, each reassembling its own split order
+template <class ServerType>
+void CheckConcurrentSessions(ServerType& server,
+                             uint16_t port,
+                             const std::vector<ID_t>& received) {
+  TcpSocket first;
+  TcpSocket second;
+  ASSERT_TRUE(first.Connect("127.0.0.1", port));
+  ASSERT_TRUE(second.Connect("127.0.0.1", port));
+
+  while (server.SessionCount() < 2) {
+    server.Poll(100);
+  }
+
+  // both sessions are left holding part of an order
+  const auto one = Encode(BuyOrder(ID_t{1}, Price_t{30}, Quantity_t{10}));
+  const auto two = Encode(SellOrder(ID_t{2}, Price_t{31}, Quantity_t{10}));
+
+  first.Send(std::span{one}.first(5));
+  second.Send(std::span{two}.first(9));
+  server.Poll(100);
+  server.Poll(100);
+  EXPECT_TRUE(received.empty());
+
+  first.Send(std::span{one}.subspan(5));
+  second.Send(std::span{two}.subspan(9));
+
+  while (received.size() < 2) {
+    server.Poll(100);
+  }
+  std::vector<ID_t> sorted = received;
+  std::sort(sorted.begin(), sorted.end());
+  EXPECT_EQ(sorted, (std::vector<ID_t>{1, 2}));
+
+  first.Close();
+  while (server.SessionCount() > 1) {
+    server.Poll(100);
+  }
+  second.Close();
+  while (server.SessionCount() > 0) {
+    server.Poll(100);
+  }
+}
+
+Server::RecvCallBack Collect(std::vector<ID_t>& received) {
+  return [&received](std::span<const uint8_t> buffer) {
+    ASSERT_EQ(buffer.size() % sizeof(Order), 0);
+    for (uint64_t i = 0; i < buffer.size() / sizeof(Order); ++i) {
+      received.push_back(DecodeId(buffer, i));
+    }
+  };
+}
+}  // namespace
+
+TEST(ServerTest, ServesConcurrentSessionsWithTheirOwnReassembly) {
+  std::vector<ID_t> received;
+  Server server("127.0.0.1", kTestPort, Collect(received));
+
+  CheckConcurrentSessions(server, kTestPort, received);
+}
+
+TEST(ServerTest, DeliversOrdersStraddlingTheRingEnd) {
+  std::vector<ID_t> received;
+  Server server("127.0.0.1", kTestPort + 2, Collect(received));
+
+  TcpSocket client;
+  ASSERT_TRUE(client.Connect("127.0.0.1", kTestPort + 2));
+
+  // the ring length is no multiple of an order, so some order straddles
+  // its end on every lap
+  constexpr uint64_t kBatch = 1000;
+  constexpr uint64_t kBatches = 40;
+
+  std::vector<uint8_t> batch(kBatch * sizeof(Order));
+  for (uint64_t n = 0; n < kBatches; ++n) {
+    for (uint64_t i = 0; i < kBatch; ++i) {
+      const Order order =
+          BuyOrder(ID_t{n * kBatch + i}, Price_t{30}, Quantity_t{10});
+      std::memcpy(batch.data() + i * sizeof(Order), &order, sizeof(Order));
+    }
+
+    // odd sized sends split orders across reads as well
+    client.Send(std::span{batch}.first(7));
+    client.Send(std::span{batch}.subspan(7));
+
+    while (received.size() < (n + 1) * kBatch) {
+      server.Poll(100);
+    }
+  }
+
+  ASSERT_EQ(received.size(), kBatch * kBatches);
+  for (uint64_t i = 0; i < received.size(); ++i) {
+    ASSERT_EQ(received[i], i);
+  }
+}
+
+TEST(ServerTest, MirroredBufferWrapsAround) {
+  MirroredBuffer buffer(1 << 16);
+  const uint64_t len = buffer.Len();
+
+  const char text[] = "straddles the end";
+  std::memcpy(buffer.Data() + len - 5, text, sizeof(text));
+
+  // the part written past the end shows up at the start
+  EXPECT_EQ(std::memcmp(buffer.Data(), text + 5, sizeof(text) - 5), 0);
+  EXPECT_EQ(std::memcmp(buffer.Data() + len - 5, text, sizeof(text)), 0);
+}
+
+TEST(ServerTest, UringServerServesConcurrentSessions) {
+  std::vector<ID_t> received;
+  std::unique_ptr<UringServer> server;
+
+  try {
+    server = std::make_unique<UringServer>("127.0.0.1", kTestPort + 1,
+                                           Collect(received));
+  } catch (const BaseIOError& error) {
+    GTEST_SKIP() << error.what();
+  }
+
+  CheckConcurrentSessions(*server, kTestPort + 1, received);
+}
+
+TEST(ServerTest, ReplaysAnOrderFileInBatches) {
+  const std::string path = ::testing::TempDir() + "file_replay_test";
+  constexpr uint64_t kOrderCount = 2 * FileReplayTransport::kBatchOrders + 3;
+
+  {
+    OrderFileWriter writer(path);
+    for (uint64_t i = 0; i < kOrderCount; ++i) {
+      writer.Write(BuyOrder(ID_t{i}, Price_t{30}, Quantity_t{10}));
+    }
+  }
+
+  std::vector<ID_t> received;
+  uint64_t batches = 0;
+
+  auto handler = [&](std::span<const uint8_t> buffer) {
+    EXPECT_LE(buffer.size(), FileReplayTransport::kBatchOrders * sizeof(Order));
+    Collect(received)(buffer);
+    ++batches;
+  };
+  BasicServer<FileReplayTransport, decltype(handler)> server(handler, path);
+
+  // returns once the whole file went through the handler
+  server.Run();
+
+  EXPECT_EQ(batches, 3);
+  ASSERT_EQ(received.size(), kOrderCount);
+  for (uint64_t i = 0; i < kOrderCount; ++i) {
+    ASSERT_EQ(received[i], i);
+  }
+  EXPECT_FALSE(server.Poll());
+
+  std::remove(path.c_str());
+}
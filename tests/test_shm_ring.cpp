@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "order.h"
+#include "shm_ring.h"
+#include "shm_server.h"
+#include "trade_observer.h"
+
+TEST(ShmRingTest, ProducerAndConsumerShareTheRing) {
+  const std::string path = ::testing::TempDir() + "shm_ring_test";
+  std::remove(path.c_str());
+
+  ShmRing<uint64_t, 8> producer(path);
+  ShmRing<uint64_t, 8> consumer(path);
+
+  const std::vector<uint64_t> items{1, 2, 3};
+  ASSERT_TRUE(producer.GetRing().TryPush(items));
+
+  const auto pending = consumer.GetRing().Front();
+  ASSERT_EQ(pending.size(), 3);
+  EXPECT_EQ(pending[2], 3);
+
+  consumer.GetRing().Pop(pending.size());
+  EXPECT_EQ(producer.GetRing().Size(), 0);
+
+  std::remove(path.c_str());
+}
+
+TEST(ShmRingTest, RefusesRingOfAnotherLayout) {
+  const std::string path = ::testing::TempDir() + "shm_ring_layout";
+  std::remove(path.c_str());
+
+  ShmRing<uint64_t, 8> ring(path);
+  // same file size, different item size
+  EXPECT_THROW((ShmRing<uint32_t, 16>(path)), std::runtime_error);
+
+  std::remove(path.c_str());
+}
+
+TEST(ShmRingTest, ShmServerHandsOverWholeOrders) {
+  const std::string path = ::testing::TempDir() + "shm_server_test";
+  std::remove(path.c_str());
+
+  std::vector<ID_t> received;
+  ShmServer server(path, [&received](std::span<const uint8_t> buffer) {
+    ASSERT_EQ(buffer.size() % sizeof(Order), 0);
+    for (uint64_t i = 0; i < buffer.size(); i += sizeof(Order)) {
+      Order order{kBuy, 0, 0, 0};
+      std::memcpy(&order, buffer.data() + i, sizeof(Order));
+      received.push_back(order.Id());
+    }
+  });
+
+  EXPECT_FALSE(server.Poll());
+
+  ShmOrderRing client(path);
+  const std::vector<Order> orders{
+      BuyOrder(ID_t{1}, Price_t{30}, Quantity_t{10}),
+      SellOrder(ID_t{2}, Price_t{31}, Quantity_t{5}),
+  };
+  ASSERT_TRUE(client.GetRing().TryPush(orders));
+
+  EXPECT_TRUE(server.Poll());
+  EXPECT_EQ(received, (std::vector<ID_t>{1, 2}));
+
+  std::remove(path.c_str());
+}
+
+TEST(ShmRingTest, TradesLargerThanTheQueueGoInParts) {
+  const std::string path = ::testing::TempDir() + "shm_trade_parts";
+  std::remove(path.c_str());
+
+  TradeObserver observer(path);
+  ShmTradeRing consumer(path);
+
+  // e.g. a large aggressor sweeping single lot orders
+  std::vector<TradeResult> results;
+  for (uint64_t i = 0; i < 3 * TradeQueue::kCapacity + 5; ++i) {
+    results.push_back(TradeResult{ID_t{1}, ID_t(i + 2), Price_t{30},
+                                  Price_t{30}, Quantity_t{1}});
+  }
+
+  std::vector<ID_t> received;
+  std::thread reader([&consumer, &received, count = results.size()] {
+    while (received.size() < count) {
+      const auto pending = consumer.GetRing().Front();
+      for (const TradeResult& result : pending) {
+        received.push_back(result.SellId);
+      }
+      consumer.GetRing().Pop(pending.size());
+    }
+  });
+
+  EXPECT_TRUE(observer.Send(results));
+  reader.join();
+
+  ASSERT_EQ(received.size(), results.size());
+  EXPECT_EQ(received.front(), 2);
+  EXPECT_EQ(received.back(), results.back().SellId);
+
+  std::remove(path.c_str());
+}
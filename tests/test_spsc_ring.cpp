@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "spsc_ring.h"
+
+namespace {
+using Ring = SpscRing<uint64_t, 8>;
+
+std::vector<uint64_t> Drain(Ring& ring) {
+  std::vector<uint64_t> items;
+
+  for (auto pending = ring.Front(); !pending.empty(); pending = ring.Front()) {
+    items.insert(items.end(), pending.begin(), pending.end());
+    ring.Pop(pending.size());
+  }
+  return items;
+}
+}  // namespace
+
+TEST(SpscRingTest, RejectsBatchThatDoesNotFit) {
+  auto ring = std::make_unique<Ring>();
+
+  const std::vector<uint64_t> six{1, 2, 3, 4, 5, 6};
+  EXPECT_TRUE(ring->TryPush(six));
+  EXPECT_FALSE(ring->TryPush(six));
+  EXPECT_EQ(ring->Size(), 6);
+
+  EXPECT_TRUE(ring->TryPush(std::vector<uint64_t>{7, 8}));
+  EXPECT_FALSE(ring->TryPush(std::vector<uint64_t>{9}));
+
+  EXPECT_EQ(Drain(*ring), (std::vector<uint64_t>{1, 2, 3, 4, 5, 6, 7, 8}));
+  EXPECT_EQ(ring->Size(), 0);
+}
+
+TEST(SpscRingTest, FrontStopsAtTheWrap) {
+  auto ring = std::make_unique<Ring>();
+
+  ASSERT_TRUE(ring->TryPush(std::vector<uint64_t>{1, 2, 3, 4, 5, 6}));
+  ring->Pop(ring->Front().size());
+
+  // slots 6 and 7, then the front of the storage
+  ASSERT_TRUE(ring->TryPush(std::vector<uint64_t>{7, 8, 9, 10, 11}));
+
+  const auto first = ring->Front();
+  ASSERT_EQ(first.size(), 2);
+  EXPECT_EQ(first[0], 7);
+  ring->Pop(first.size());
+
+  const auto second = ring->Front();
+  ASSERT_EQ(second.size(), 3);
+  EXPECT_EQ(second[2], 11);
+}
+
+TEST(SpscRingTest, ConsumerSeesEveryItemInOrder) {
+  auto ring = std::make_unique<SpscRing<uint64_t, 64>>();
+  constexpr uint64_t kTotal = 200'000;
+
+  std::thread producer([&ring]() {
+    uint64_t next = 0;
+    while (next < kTotal) {
+      const uint64_t batch[3] = {next, next + 1, next + 2};
+      if (ring->TryPush(batch)) {
+        next += 3;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint64_t expected = 0;
+  bool in_order = true;
+
+  while (expected < kTotal) {
+    const auto pending = ring->Front();
+    if (pending.empty()) {
+      std::this_thread::yield();
+    }
+    for (const uint64_t item : pending) {
+      in_order = in_order and item == expected++;
+    }
+    ring->Pop(pending.size());
+  }
+  producer.join();
+
+  EXPECT_TRUE(in_order);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include "linux/file_map.h"
+#include "trace_ring.h"
+
+namespace {
+TraceDumpHeader ReadHeader(std::span<const uint8_t> data) {
+  TraceDumpHeader header;
+  std::memcpy(&header, data.data(), sizeof(header));
+  return header;
+}
+
+TraceEvent ReadEvent(std::span<const uint8_t> data, uint64_t index) {
+  TraceEvent event;
+  std::memcpy(&event,
+              data.data() + sizeof(TraceDumpHeader) + index * sizeof(event),
+              sizeof(event));
+  return event;
+}
+}  // namespace
+
+TEST(TraceRingTest, DumpWrappedRingOldestFirst) {
+  const std::string path = ::testing::TempDir() + "trace_ring_test.trace";
+  std::remove(path.c_str());
+
+  auto ring = std::make_unique<TraceRing>(path, 1'000'000'000);
+
+  const uint64_t total = TraceRing::kCapacity + 10;
+  for (uint64_t i = 1; i <= total; ++i) {
+    ring->Record(Stage::kExecute, ID_t{i}, i * 100, i * 100 + 7);
+  }
+
+  ASSERT_TRUE(ring->Dump(kTraceDumpRequested));
+
+  FileMap file(path);
+  ASSERT_EQ(file.Data().size(), sizeof(TraceDumpHeader) +
+                                   TraceRing::kCapacity * sizeof(TraceEvent));
+
+  const TraceDumpHeader header = ReadHeader(file.Data());
+  EXPECT_EQ(std::memcmp(header.Magic, kTraceDumpMagic, sizeof(header.Magic)),
+            0);
+  EXPECT_EQ(header.Reason, kTraceDumpRequested);
+  EXPECT_EQ(header.Count, TraceRing::kCapacity);
+  EXPECT_GT(header.TicksPerNs, 0.0);
+
+  // the first 10 events were overwritten
+  const TraceEvent oldest = ReadEvent(file.Data(), 0);
+  EXPECT_EQ(oldest.OrderId, ID_t{11});
+  EXPECT_EQ(oldest.StartTsc, uint64_t{1100});
+  EXPECT_EQ(oldest.Ticks, uint32_t{7});
+  EXPECT_EQ(oldest.EventStage, Stage::kExecute);
+
+  const TraceEvent newest = ReadEvent(file.Data(), TraceRing::kCapacity - 1);
+  EXPECT_EQ(newest.OrderId, ID_t{total});
+
+  std::remove(path.c_str());
+}
+
+TEST(TraceRingTest, SpikeDumpsAtNextPoll) {
+  const std::string path = ::testing::TempDir() + "trace_spike_test.trace";
+  std::remove(path.c_str());
+
+  auto ring = std::make_unique<TraceRing>(path, 1'000);
+
+  const uint64_t now = ReadTsc();
+  ring->Record(Stage::kAddOrder, ID_t{1}, now, now + 10);
+  ring->Poll();
+
+  EXPECT_FALSE(std::filesystem::exists(path));
+
+  // far beyond a microsecond at any tsc frequency
+  ring->Record(Stage::kExecute, ID_t{1}, now, now + 1'000'000'000);
+  ring->Poll();
+  // written on the ring's own thread
+  ring->WaitForDump();
+
+  FileMap file(path);
+  ASSERT_GE(file.Data().size(), sizeof(TraceDumpHeader));
+
+  const TraceDumpHeader header = ReadHeader(file.Data());
+  EXPECT_EQ(header.Reason, kTraceDumpSpike);
+  EXPECT_EQ(header.Count, 2);
+
+  std::remove(path.c_str());
+}
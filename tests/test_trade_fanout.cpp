@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "linux/tcp.h"
+#include "trade_fanout.h"
+#include "trade_result.h"
+
+namespace {
+constexpr uint16_t kTestPort = 15700;
+
+std::vector<TradeResult> Trades(uint64_t first, uint64_t count) {
+  std::vector<TradeResult> trades;
+  for (uint64_t id = first; id < first + count; ++id) {
+    trades.push_back(TradeResult{.BuyId = id,
+                                 .SellId = id + 1,
+                                 .BuyPrice = 30,
+                                 .SellPrice = 30,
+                                 .Quantity = 10});
+  }
+  return trades;
+}
+
+// what a subscriber has been sent so far, the sequence header first
+class Reader {
+ public:
+  explicit Reader(uint16_t port) {
+    EXPECT_TRUE(m_sock_.Connect("127.0.0.1", port));
+    SetSocketNonBlocking(m_sock_);
+  }
+  ~Reader() { m_sock_.Close(); }
+
+  void ReadAvailable() {
+    uint8_t buffer[1 << 16];
+
+    while (1) {
+      const int byte_recv = m_sock_.TryRecv(buffer);
+      if (byte_recv <= 0) {
+        return;
+      }
+      Bytes.insert(std::end(Bytes), buffer, buffer + byte_recv);
+    }
+  }
+
+  uint64_t Sequence() const {
+    uint64_t sequence;
+    std::memcpy(&sequence, Bytes.data(), sizeof(sequence));
+    return sequence;
+  }
+
+  uint64_t TradeCount() const {
+    return (Bytes.size() - sizeof(uint64_t)) / sizeof(TradeResult);
+  }
+
+  TradeResult Trade(uint64_t i) const {
+    TradeResult trade;
+    std::memcpy(&trade,
+                Bytes.data() + sizeof(uint64_t) + i * sizeof(TradeResult),
+                sizeof(trade));
+    return trade;
+  }
+
+  std::vector<uint8_t> Bytes;
+
+ private:
+  TcpSocket m_sock_;
+};
+}  // namespace
+
+TEST(TradeFanoutTest, EverySubscriberGetsEveryTrade) {
+  TradeFanout fanout("127.0.0.1", kTestPort, 2048);
+
+  Reader first(kTestPort);
+  Reader second(kTestPort);
+  while (fanout.SubscriberCount() < 2) {
+    fanout.Poll();
+  }
+
+  for (uint64_t batch = 0; batch < 10; ++batch) {
+    EXPECT_TRUE(fanout.Send(Trades(batch * 100, 100)));
+
+    while (fanout.Poll()) {
+    }
+    first.ReadAvailable();
+    second.ReadAvailable();
+  }
+
+  for (Reader* reader : {&first, &second}) {
+    ASSERT_EQ(reader->Sequence(), 0);
+    ASSERT_EQ(reader->TradeCount(), 1000);
+    for (uint64_t i = 0; i < 1000; ++i) {
+      ASSERT_EQ(reader->Trade(i).BuyId, i);
+    }
+  }
+  EXPECT_EQ(fanout.Published(), 1000);
+}
+
+TEST(TradeFanoutTest, LateSubscriberStartsHalfALogBehind) {
+  TradeFanout fanout("127.0.0.1", kTestPort + 1, 2048);
+
+  // the log wraps more than once before anyone subscribes
+  for (uint64_t batch = 0; batch < 50; ++batch) {
+    fanout.Send(Trades(batch * 100, 100));
+  }
+
+  Reader reader(kTestPort + 1);
+  while (fanout.SubscriberCount() < 1) {
+    fanout.Poll();
+  }
+  while (fanout.Poll()) {
+    reader.ReadAvailable();
+  }
+  reader.ReadAvailable();
+
+  ASSERT_EQ(reader.Sequence(), 5000 - 1024);
+  ASSERT_EQ(reader.TradeCount(), 1024);
+  EXPECT_EQ(reader.Trade(0).BuyId, 5000 - 1024);
+  EXPECT_EQ(reader.Trade(1023).BuyId, 4999);
+}
+
+TEST(TradeFanoutTest, DropsASubscriberTheLogLapsAndServesTheRest) {
+  TradeFanout fanout("127.0.0.1", kTestPort + 2, 2048);
+
+  Reader reading(kTestPort + 2);
+  // never reads, its socket fills up and the log runs past it
+  Reader stalled(kTestPort + 2);
+  while (fanout.SubscriberCount() < 2) {
+    fanout.Poll();
+  }
+
+  // far more than the socket buffers of the stalled one hold
+  constexpr uint64_t kBatches = 2'000;
+  for (uint64_t batch = 0; batch < kBatches; ++batch) {
+    fanout.Send(Trades(batch * 1000, 1000));
+
+    while (fanout.Poll()) {
+      reading.ReadAvailable();
+    }
+    reading.ReadAvailable();
+  }
+
+  EXPECT_EQ(fanout.SubscriberCount(), 1);
+  EXPECT_EQ(fanout.DroppedCount(), 1);
+
+  ASSERT_EQ(reading.TradeCount(), kBatches * 1000);
+  for (uint64_t i = 0; i < reading.TradeCount(); ++i) {
+    ASSERT_EQ(reading.Trade(i).BuyId, i);
+  }
+}